@@ -450,3 +450,25 @@ class MergeSortBRAM(Elaboratable):
                     m.next = "OUTPUT_READ"
 
         return m
+
+
+if __name__ == "__main__":
+    import sys
+    from amaranth.back import verilog
+
+    output_path = sys.argv[1] if len(sys.argv) > 1 else "merge_sort.v"
+    max_ranges = int(sys.argv[2]) if len(sys.argv) > 2 else 256
+
+    top = MergeSortBRAM(max_ranges=max_ranges, width=64)
+    v = verilog.convert(top, name="top", ports=[
+        # Input interface
+        top.start_in, top.end_in, top.valid_in, top.count_in,
+        # Output interface
+        top.start_out, top.end_out, top.valid_out, top.done,
+        # Control
+        top.start, top.ready, top.busy,
+    ])
+
+    with open(output_path, "w") as f:
+        f.write(v)
+    print(f"Generated {output_path}")
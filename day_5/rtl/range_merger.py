@@ -171,3 +171,25 @@ class RangeMerger(Elaboratable):
                 m.d.comb += self.ready.eq(0)
 
         return m
+
+
+if __name__ == "__main__":
+    import sys
+    from amaranth.back import verilog
+
+    output_path = sys.argv[1] if len(sys.argv) > 1 else "range_merger.v"
+
+    top = RangeMerger(width=64, compute_coverage=True)
+    v = verilog.convert(top, name="top", ports=[
+        # Input interface
+        top.start_in, top.end_in, top.valid_in, top.last_in,
+        # Output interface
+        top.start_out, top.end_out, top.valid_out, top.last_out,
+        top.total_coverage,
+        # Control
+        top.ready,
+    ])
+
+    with open(output_path, "w") as f:
+        f.write(v)
+    print(f"Generated {output_path}")
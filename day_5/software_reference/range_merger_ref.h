@@ -0,0 +1,60 @@
+/**
+ * Native version of range_merger.py for the Verilator fuzz drivers.
+ *
+ * Same semantics as merge_all_ranges() and calculate_total_coverage():
+ * ranges are sorted by (start, end) and a range is folded into the previous
+ * one when start <= last end. Coverage is accumulated in 128 bits like the
+ * RangeMerger total_coverage output, so it matches Python for any set of
+ * fewer than 2**64 ranges.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace range_merger_ref {
+
+typedef unsigned __int128 Coverage;
+
+struct Range {
+    uint64_t start, end;
+
+    bool operator<(const Range& o) const {
+        return start < o.start || (start == o.start && end < o.end);
+    }
+    bool operator==(const Range& o) const { return start == o.start && end == o.end; }
+};
+
+// Sorted, merged copy of ranges (merge_all_ranges)
+static inline std::vector<Range> merge_all_ranges(std::vector<Range> ranges) {
+    std::vector<Range> merged;
+    if (ranges.empty()) {
+        return merged;
+    }
+    std::sort(ranges.begin(), ranges.end());
+    merged.push_back(ranges[0]);
+    for (size_t i = 1; i < ranges.size(); i++) {
+        Range& last = merged.back();
+        if (ranges[i].start <= last.end) {
+            last.end = std::max(last.end, ranges[i].end);
+        } else {
+            merged.push_back(ranges[i]);
+        }
+    }
+    return merged;
+}
+
+// Integers covered by non-overlapping ranges (calculate_total_coverage)
+static inline Coverage calculate_total_coverage(const std::vector<Range>& ranges) {
+    Coverage total = 0;
+    for (const Range& r : ranges) {
+        total += static_cast<Coverage>(r.end) - r.start + 1;
+    }
+    return total;
+}
+
+} // namespace range_merger_ref
@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""
+Amaranth simulator vs. Verilator throughput for the day 5 modules.
+
+Runs the same seeded random range sets, at growing sizes, through the
+Amaranth Python simulator and through the Verilated trace-free libraries,
+and reports simulated cycles per second for each. Both sides must produce
+the software reference result. The Amaranth simulator is only run up to
+--amaranth-max ranges, since it is orders of magnitude slower.
+
+Usage:
+    python3 bench_sim_speed.py [--modules sort merge coverage] [--sizes 64 256 1024 4096]
+"""
+
+import json
+import os
+import random
+import sys
+import time
+
+from rtl_merge_sort import ROOT, MergeSort, sort_cycle_budget
+from rtl_range_merger import RangeMerger
+from rtl_interval_coverage import IntervalCoverage
+
+sys.path.insert(0, ROOT)
+from software_reference.range_merger import merge_all_ranges, calculate_total_coverage
+
+
+def random_ranges(count, seed):
+    """count ranges with roughly half of them overlapping a neighbour."""
+    rng = random.Random(seed)
+    span = 1 << 20
+    ranges = []
+    for _ in range(count):
+        start = rng.randrange(count * span)
+        ranges.append((start, start + rng.randrange(2 * span)))
+    return ranges
+
+
+def expected_output(module, ranges):
+    """Software reference output: (ranges, coverage or None)."""
+    if module == 'sort':
+        return sorted(ranges), None
+    merged = merge_all_ranges(ranges)
+    return merged, calculate_total_coverage(merged)
+
+
+# =============================================================================
+# Amaranth simulator
+# =============================================================================
+
+def run_amaranth(module, ranges, max_ranges):
+    """Simulate one range set with amaranth.sim; returns (output, coverage, cycles)."""
+    from amaranth.sim import Simulator, Tick
+
+    if module == 'sort':
+        from rtl.merge_sort import MergeSortBRAM
+        dut = MergeSortBRAM(max_ranges=max_ranges, width=64)
+    elif module == 'merge':
+        from rtl.range_merger import RangeMerger as RangeMergerRTL
+        dut = RangeMergerRTL(width=64, compute_coverage=True)
+        ranges = sorted(ranges)
+    else:
+        from rtl.interval_coverage import IntervalCoverage as IntervalCoverageRTL
+        dut = IntervalCoverageRTL(max_ranges=max_ranges, width=64, compute_coverage=True)
+
+    output = []
+    state = {'cycles': 0, 'coverage': None}
+    max_cycles = sort_cycle_budget(len(ranges)) + len(ranges)
+
+    def testbench():
+        if module == 'merge':
+            # Stream one range per cycle, collect until last_out
+            for i in range(max_cycles):
+                if i < len(ranges):
+                    yield dut.start_in.eq(ranges[i][0])
+                    yield dut.end_in.eq(ranges[i][1])
+                    yield dut.valid_in.eq(1)
+                    yield dut.last_in.eq(i == len(ranges) - 1)
+                else:
+                    yield dut.valid_in.eq(0)
+                    yield dut.last_in.eq(0)
+                yield Tick()
+                state['cycles'] += 1
+                if (yield dut.valid_out):
+                    output.append(((yield dut.start_out), (yield dut.end_out)))
+                    if (yield dut.last_out):
+                        break
+            state['coverage'] = yield dut.total_coverage
+            return
+
+        # Sorter and pipeline: load, pulse start, collect until done
+        for start, end in ranges:
+            yield dut.start_in.eq(start)
+            yield dut.end_in.eq(end)
+            yield dut.valid_in.eq(1)
+            yield Tick()
+        yield dut.valid_in.eq(0)
+        yield dut.count_in.eq(len(ranges))
+        yield dut.start.eq(1)
+        yield Tick()
+        yield dut.start.eq(0)
+        state['cycles'] = len(ranges) + 1
+        for _ in range(max_cycles):
+            yield Tick()
+            state['cycles'] += 1
+            if (yield dut.valid_out):
+                output.append(((yield dut.start_out), (yield dut.end_out)))
+            if (yield dut.done):
+                break
+        if module == 'coverage':
+            state['coverage'] = yield dut.total_coverage
+
+    sim = Simulator(dut)
+    sim.add_clock(1e-6)
+    sim.add_process(testbench)
+    sim.run()
+    return output, state['coverage'], state['cycles']
+
+
+# =============================================================================
+# Verilator
+# =============================================================================
+
+def make_verilator(module, max_ranges):
+    """Create the trace-free Verilator model for module."""
+    if module == 'sort':
+        return MergeSort(max_ranges=max_ranges)
+    if module == 'merge':
+        return RangeMerger()
+    return IntervalCoverage(max_ranges=max_ranges)
+
+
+def run_verilator(dut, module, ranges):
+    """Run one range set through a Verilator model; returns (output, coverage, cycles).
+
+    cycles counts the load as well as the run, like the Amaranth testbench.
+    """
+    if module == 'sort':
+        return dut.sort(ranges), None, len(ranges) + dut.last_run_cycles
+    if module == 'merge':
+        return dut.merge(sorted(ranges)), dut.total_coverage, dut.last_run_cycles
+    output = dut.process(ranges)
+    return output, dut.total_coverage, len(ranges) + dut.last_run_cycles
+
+
+def measure(run, *args):
+    """Call run(*args), returning its result and the wall time."""
+    start_time = time.perf_counter()
+    result = run(*args)
+    return result, time.perf_counter() - start_time
+
+
+def main():
+    """Run the size ladder and print one row per module and size."""
+    import argparse
+
+    parser = argparse.ArgumentParser(description='Amaranth vs. Verilator simulation throughput')
+    parser.add_argument('--modules', nargs='+', choices=['sort', 'merge', 'coverage'],
+                        default=['sort', 'merge', 'coverage'], help='Modules to benchmark (default: all)')
+    parser.add_argument('--sizes', type=int, nargs='+', default=[64, 256, 1024, 4096],
+                        help='Range counts (default: 64 256 1024 4096)')
+    parser.add_argument('--max-ranges', type=int, default=4096,
+                        help='max_ranges the libraries were generated with (default: 4096)')
+    parser.add_argument('--amaranth-max', type=int, default=1024,
+                        help='Largest size run on the Amaranth simulator (default: 1024)')
+    parser.add_argument('--repeats', type=int, default=3,
+                        help='Verilator runs per size, best time kept (default: 3)')
+    parser.add_argument('--seed', type=int, default=1, help='Range generator seed (default: 1)')
+    parser.add_argument('--json', metavar='FILE', help='Also write the rows as JSON')
+    args = parser.parse_args()
+
+    sizes = [n for n in args.sizes if n <= args.max_ranges]
+    if len(sizes) < len(args.sizes):
+        print(f"Skipping sizes above max_ranges={args.max_ranges}", file=sys.stderr)
+
+    print(f"{'module':<9} {'ranges':>7} {'cycles':>10} {'amaranth_s':>11} {'amaranth_c/s':>13} "
+          f"{'verilator_s':>12} {'verilator_c/s':>14} {'speedup':>8}")
+    rows = []
+    failed = False
+    for module in args.modules:
+        dut = make_verilator(module, args.max_ranges)
+        for n in sizes:
+            ranges = random_ranges(n, args.seed + n)
+            expected = expected_output(module, ranges)
+
+            best = None
+            for _ in range(args.repeats):
+                (output, coverage, cycles), elapsed = measure(run_verilator, dut, module, ranges)
+                if (output, coverage) != expected:
+                    failed = True
+                    print(f"{module:<9} {n:>7} Verilator output mismatch", file=sys.stderr)
+                if best is None or elapsed < best:
+                    best = elapsed
+            row = {'module': module, 'ranges': n, 'cycles': cycles,
+                   'verilator_s': best, 'verilator_cps': cycles / best}
+
+            if n <= args.amaranth_max:
+                (output, coverage, am_cycles), elapsed = measure(run_amaranth, module, ranges, args.max_ranges)
+                if (output, coverage) != expected:
+                    failed = True
+                    print(f"{module:<9} {n:>7} Amaranth output mismatch", file=sys.stderr)
+                row.update({'amaranth_s': elapsed, 'amaranth_cps': am_cycles / elapsed,
+                            'speedup': elapsed / best})
+            rows.append(row)
+
+            if 'amaranth_s' in row:
+                am = f"{row['amaranth_s']:>11.3f} {row['amaranth_cps']:>13.0f}"
+                speedup = f"{row['speedup']:>7.0f}x"
+            else:
+                am = f"{'-':>11} {'-':>13}"
+                speedup = f"{'-':>8}"
+            print(f"{module:<9} {n:>7} {cycles:>10} {am} {row['verilator_s']:>12.4f} "
+                  f"{row['verilator_cps']:>14.0f} {speedup}")
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(rows, f, indent=2)
+        print(f"Wrote {args.json}", file=sys.stderr)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+"""
+Python ctypes wrapper for rtl_interval_coverage (IntervalCoverage) Verilator module.
+
+Usage:
+    from rtl_interval_coverage import IntervalCoverage
+
+    pipeline = IntervalCoverage()
+    merged = pipeline.process(ranges)
+    print(f"coverage {pipeline.total_coverage} in {pipeline.last_run_cycles} cycles")
+"""
+
+import ctypes
+import os
+import sys
+
+from rtl_merge_sort import ROOT, range_buffer, sort_cycle_budget
+
+
+
+class IntervalCoverage:
+    """Python wrapper for IntervalCoverage RTL simulation via Verilator."""
+
+    def __init__(self, lib_path=None, threads=0, trace=False, max_ranges=4096):
+        """Initialize the Verilator module wrapper.
+
+        Args:
+            lib_path: Path to shared library. If None, uses default location.
+            threads: Simulation threads for --threads builds (0 = default)
+            trace: Load the traced library (required for enable_waveform).
+                Otherwise the default is the trace-free librtl_interval_coverage_notrace.so,
+                falling back to the traced library if it has not been built.
+            max_ranges: Capacity the Verilog was generated with (Makefile MAX_RANGES)
+        """
+        if lib_path is None:
+            lib_dir = os.path.join(os.path.dirname(__file__), "../lib")
+            lib_path = os.path.join(lib_dir, "librtl_interval_coverage.so")
+            notrace_path = os.path.join(lib_dir, "librtl_interval_coverage_notrace.so")
+            if not trace and os.path.exists(notrace_path):
+                lib_path = notrace_path
+
+        if not os.path.exists(lib_path):
+            raise FileNotFoundError(f"Shared library not found: {lib_path}")
+
+        self.max_ranges = max_ranges
+        self._fresh = True  # No input set since the last reset
+        self.lib = ctypes.CDLL(lib_path)
+        self._setup_functions()
+        self.handle = self.lib.create_instance(threads)
+
+    def _setup_functions(self):
+        """Define C function signatures."""
+        # Lifecycle
+        self.lib.create_instance.argtypes = [ctypes.c_uint32]
+        self.lib.create_instance.restype = ctypes.c_void_p
+        self.lib.destroy_instance.argtypes = [ctypes.c_void_p]
+        self.lib.destroy_instance.restype = None
+        self.lib.reset_instance.argtypes = [ctypes.c_void_p]
+        self.lib.reset_instance.restype = None
+
+        # Waveform control
+        self.lib.enable_waveform.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
+        self.lib.enable_waveform.restype = None
+        self.lib.disable_waveform.argtypes = [ctypes.c_void_p]
+        self.lib.disable_waveform.restype = None
+        self.lib.has_waveform_support.argtypes = []
+        self.lib.has_waveform_support.restype = ctypes.c_uint8
+
+        # Clock
+        self.lib.clock_cycle.argtypes = [ctypes.c_void_p]
+        self.lib.clock_cycle.restype = None
+        self.lib.clock_n.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+        self.lib.clock_n.restype = None
+        self.lib.get_cycle_count.argtypes = [ctypes.c_void_p]
+        self.lib.get_cycle_count.restype = ctypes.c_uint64
+
+        # Status signals
+        self.lib.get_done.argtypes = [ctypes.c_void_p]
+        self.lib.get_done.restype = ctypes.c_uint8
+        self.lib.get_ready.argtypes = [ctypes.c_void_p]
+        self.lib.get_ready.restype = ctypes.c_uint8
+        self.lib.get_total_coverage.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64)]
+        self.lib.get_total_coverage.restype = None
+
+        # Bulk load / read
+        self.lib.load_ranges.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint32]
+        self.lib.load_ranges.restype = None
+        self.lib.process_ranges.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint32,
+                                            ctypes.c_uint64]
+        self.lib.process_ranges.restype = ctypes.c_uint32
+        self.lib.get_last_run_cycles.argtypes = [ctypes.c_void_p]
+        self.lib.get_last_run_cycles.restype = ctypes.c_uint64
+
+    def __del__(self):
+        """Cleanup on destruction."""
+        if getattr(self, 'handle', None):
+            self.lib.destroy_instance(self.handle)
+            self.handle = None
+
+    # =========================================================================
+    # Waveform control
+    # =========================================================================
+
+    def enable_waveform(self, filename, from_cycle=0, to_cycle=None):
+        """Enable waveform capture to FST file.
+
+        Args:
+            filename: Output FST filename
+            from_cycle: Start capturing from this cycle (default 0)
+            to_cycle: Stop capturing at this cycle (default: unlimited)
+        """
+        if not self.lib.has_waveform_support():
+            raise RuntimeError("Library built without tracing; create with trace=True")
+        if to_cycle is None:
+            to_cycle = 0xFFFFFFFFFFFFFFFF  # UINT64_MAX
+        self.lib.enable_waveform(self.handle, filename.encode(), from_cycle, to_cycle)
+
+    def disable_waveform(self):
+        """Disable waveform capture and close the file."""
+        self.lib.disable_waveform(self.handle)
+
+    # =========================================================================
+    # Clock control
+    # =========================================================================
+
+    def clock(self, n=1):
+        """Advance simulation by n clock cycles."""
+        if n == 1:
+            self.lib.clock_cycle(self.handle)
+        else:
+            self.lib.clock_n(self.handle, n)
+
+    def reset(self):
+        """Apply the reset sequence again (clears the coverage accumulator)."""
+        self.lib.reset_instance(self.handle)
+        self._fresh = True
+
+    # =========================================================================
+    # Bulk API
+    # =========================================================================
+
+    def process(self, ranges, out=None, max_cycles=None):
+        """Load unsorted ranges, sort and merge them and read the result back.
+
+        The pipeline stops in DONE after each input set, so the instance is
+        reset first unless it is fresh.
+
+        Args:
+            ranges: List of (start, end) tuples, or a C-contiguous uint64
+                numpy array of shape (N, 2), passed without copying
+            out: Optional C-contiguous uint64 numpy array of shape (N, 2)
+                the merged ranges are written into
+            max_cycles: Cycle limit (default: sort_cycle_budget(N) + N)
+
+        Returns:
+            The merged ranges: the filled rows of out if given, otherwise a list of tuples
+        """
+        in_buf, count, _keep = range_buffer(ranges)
+        if count == 0:
+            return out[:0] if out is not None else []
+        if count > self.max_ranges:
+            raise ValueError(f"{count} ranges exceed max_ranges={self.max_ranges}")
+        if max_cycles is None:
+            max_cycles = sort_cycle_budget(count) + count
+        if out is None:
+            out_buf = (ctypes.c_uint64 * (2 * count))()
+        else:
+            out_buf, cap, _ = range_buffer(out)
+            if cap < count:
+                raise ValueError(f"output array holds {cap} ranges, need {count}")
+
+        if not self._fresh:
+            self.reset()
+        self._fresh = False
+        self.lib.load_ranges(self.handle, in_buf, count)
+        emitted = self.lib.process_ranges(self.handle, out_buf, count, max_cycles)
+        if not self.done:
+            raise TimeoutError(f"Not done within {max_cycles} cycles ({emitted} ranges emitted)")
+
+        if out is not None:
+            return out[:emitted]
+        return [(out_buf[2 * i], out_buf[2 * i + 1]) for i in range(emitted)]
+
+    @property
+    def last_run_cycles(self):
+        """Cycles taken by the last process() from start to done."""
+        return self.lib.get_last_run_cycles(self.handle)
+
+    # =========================================================================
+    # Properties
+    # =========================================================================
+
+    @property
+    def cycle_count(self):
+        """Cycles simulated since creation (including reset)."""
+        return self.lib.get_cycle_count(self.handle)
+
+    @property
+    def done(self):
+        """True once the last merged range has been emitted."""
+        return bool(self.lib.get_done(self.handle))
+
+    @property
+    def ready(self):
+        """True while idle and accepting ranges."""
+        return bool(self.lib.get_ready(self.handle))
+
+    @property
+    def total_coverage(self):
+        """Integers covered by the merged ranges (128-bit)."""
+        words = (ctypes.c_uint64 * 2)()
+        self.lib.get_total_coverage(self.handle, words)
+        return words[1] << 64 | words[0]
+
+
+# =============================================================================
+# Test
+# =============================================================================
+
+def main():
+    """Process the test ranges and compare with the software reference."""
+    import time
+    import argparse
+
+    sys.path.insert(0, ROOT)
+    from software_reference.range_merger import read_input, merge_all_ranges, calculate_total_coverage
+
+    parser = argparse.ArgumentParser(description='IntervalCoverage Verilator test')
+    parser.add_argument('input_file', nargs='?', default=os.path.join(ROOT, "testcases/default_input.txt"),
+                        help='Input file with ranges (default: testcases/default_input.txt)')
+    parser.add_argument('--max-ranges', type=int, default=4096,
+                        help='max_ranges the library was generated with (default: 4096)')
+    parser.add_argument('--waveform', '-w', metavar='FILE', help='Output FST waveform file')
+    parser.add_argument('--waveform-from-cycle', type=int, default=0,
+                        help='Start waveform capture at this cycle (default: 0)')
+    parser.add_argument('--waveform-to-cycle', type=int, default=None,
+                        help='Stop waveform capture at this cycle (default: unlimited)')
+    args = parser.parse_args()
+
+    print("IntervalCoverage Test", file=sys.stderr)
+
+    pipeline = IntervalCoverage(trace=bool(args.waveform), max_ranges=args.max_ranges)
+    if args.waveform:
+        print(f"Waveform output: {args.waveform}", file=sys.stderr)
+        pipeline.enable_waveform(args.waveform, args.waveform_from_cycle, args.waveform_to_cycle)
+
+    ranges, _ = read_input(args.input_file)
+    sw_merged = merge_all_ranges(ranges)
+    sw_coverage = calculate_total_coverage(sw_merged)
+    print(f"Processing {len(ranges)} ranges...", file=sys.stderr)
+
+    start_time = time.time()
+    hw_merged = pipeline.process(ranges)
+    elapsed = time.time() - start_time
+    hw_coverage = pipeline.total_coverage
+
+    # A second input set on the same instance goes through reset()
+    hw_again = pipeline.process(ranges[::-1])
+
+    print(f"\nResults:", file=sys.stderr)
+    print(f"  Merged: {len(hw_merged)} ranges (software: {len(sw_merged)})", file=sys.stderr)
+    print(f"  Coverage: {hw_coverage} (software: {sw_coverage})", file=sys.stderr)
+    print(f"  Cycles: {pipeline.last_run_cycles}", file=sys.stderr)
+    print(f"  Time: {elapsed:.3f}s", file=sys.stderr)
+
+    if hw_merged == sw_merged and hw_coverage == sw_coverage and hw_again == hw_merged:
+        print("  PASS: Output matches software reference", file=sys.stderr)
+        return 0
+    else:
+        print("  FAIL: Output mismatch", file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+"""
+Python ctypes wrapper for rtl_merge_sort (MergeSortBRAM) Verilator module.
+
+Usage:
+    from rtl_merge_sort import MergeSort
+
+    sorter = MergeSort()
+    sorted_ranges = sorter.sort([(5, 9), (1, 3), (4, 4)])
+    print(f"{sorter.last_run_cycles} cycles")
+"""
+
+import ctypes
+import os
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "../..")
+
+
+def range_buffer(ranges):
+    """Return (pointer, count, keepalive) for an interleaved {start0, end0, ...} buffer.
+
+    ranges is a list of (start, end) tuples, or a C-contiguous uint64 numpy
+    array of shape (N, 2), which is passed without copying.
+    """
+    if hasattr(ranges, 'ctypes'):
+        if ranges.dtype.itemsize != 8 or ranges.dtype.kind != 'u':
+            raise ValueError("range array must have dtype uint64")
+        if ranges.ndim != 2 or ranges.shape[1] != 2:
+            raise ValueError("range array must have shape (N, 2)")
+        if not ranges.flags['C_CONTIGUOUS']:
+            raise ValueError("range array must be C-contiguous")
+        return ranges.ctypes.data_as(ctypes.POINTER(ctypes.c_uint64)), ranges.shape[0], ranges
+    count = len(ranges)
+    buf = (ctypes.c_uint64 * (2 * count))()
+    for i, (start, end) in enumerate(ranges):
+        buf[2 * i] = start
+        buf[2 * i + 1] = end
+    return buf, count, buf
+
+
+def sort_cycle_budget(count):
+    """Generous cycle limit for sorting count ranges (about 4 n log n in practice)."""
+    return 16 * (count + 1) * max(1, count.bit_length()) + 1000
+
+
+class MergeSort:
+    """Python wrapper for MergeSortBRAM RTL simulation via Verilator."""
+
+    def __init__(self, lib_path=None, threads=0, trace=False, max_ranges=4096):
+        """Initialize the Verilator module wrapper.
+
+        Args:
+            lib_path: Path to shared library. If None, uses default location.
+            threads: Simulation threads for --threads builds (0 = default)
+            trace: Load the traced library (required for enable_waveform).
+                Otherwise the default is the trace-free librtl_merge_sort_notrace.so,
+                falling back to the traced library if it has not been built.
+            max_ranges: Capacity the Verilog was generated with (Makefile MAX_RANGES)
+        """
+        if lib_path is None:
+            lib_dir = os.path.join(os.path.dirname(__file__), "../lib")
+            lib_path = os.path.join(lib_dir, "librtl_merge_sort.so")
+            notrace_path = os.path.join(lib_dir, "librtl_merge_sort_notrace.so")
+            if not trace and os.path.exists(notrace_path):
+                lib_path = notrace_path
+
+        if not os.path.exists(lib_path):
+            raise FileNotFoundError(f"Shared library not found: {lib_path}")
+
+        self.max_ranges = max_ranges
+        self.lib = ctypes.CDLL(lib_path)
+        self._setup_functions()
+        self.handle = self.lib.create_instance(threads)
+
+    def _setup_functions(self):
+        """Define C function signatures."""
+        # Lifecycle
+        self.lib.create_instance.argtypes = [ctypes.c_uint32]
+        self.lib.create_instance.restype = ctypes.c_void_p
+        self.lib.destroy_instance.argtypes = [ctypes.c_void_p]
+        self.lib.destroy_instance.restype = None
+        self.lib.reset_instance.argtypes = [ctypes.c_void_p]
+        self.lib.reset_instance.restype = None
+
+        # Waveform control
+        self.lib.enable_waveform.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
+        self.lib.enable_waveform.restype = None
+        self.lib.disable_waveform.argtypes = [ctypes.c_void_p]
+        self.lib.disable_waveform.restype = None
+        self.lib.has_waveform_support.argtypes = []
+        self.lib.has_waveform_support.restype = ctypes.c_uint8
+
+        # Clock
+        self.lib.clock_cycle.argtypes = [ctypes.c_void_p]
+        self.lib.clock_cycle.restype = None
+        self.lib.clock_n.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+        self.lib.clock_n.restype = None
+        self.lib.get_cycle_count.argtypes = [ctypes.c_void_p]
+        self.lib.get_cycle_count.restype = ctypes.c_uint64
+
+        # Status signals
+        self.lib.get_done.argtypes = [ctypes.c_void_p]
+        self.lib.get_done.restype = ctypes.c_uint8
+        self.lib.get_ready.argtypes = [ctypes.c_void_p]
+        self.lib.get_ready.restype = ctypes.c_uint8
+        self.lib.get_busy.argtypes = [ctypes.c_void_p]
+        self.lib.get_busy.restype = ctypes.c_uint8
+
+        # Bulk load / read
+        self.lib.load_ranges.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint32]
+        self.lib.load_ranges.restype = None
+        self.lib.sort_ranges.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint32,
+                                         ctypes.c_uint64]
+        self.lib.sort_ranges.restype = ctypes.c_uint32
+        self.lib.get_last_run_cycles.argtypes = [ctypes.c_void_p]
+        self.lib.get_last_run_cycles.restype = ctypes.c_uint64
+
+    def __del__(self):
+        """Cleanup on destruction."""
+        if getattr(self, 'handle', None):
+            self.lib.destroy_instance(self.handle)
+            self.handle = None
+
+    # =========================================================================
+    # Waveform control
+    # =========================================================================
+
+    def enable_waveform(self, filename, from_cycle=0, to_cycle=None):
+        """Enable waveform capture to FST file.
+
+        Args:
+            filename: Output FST filename
+            from_cycle: Start capturing from this cycle (default 0)
+            to_cycle: Stop capturing at this cycle (default: unlimited)
+        """
+        if not self.lib.has_waveform_support():
+            raise RuntimeError("Library built without tracing; create with trace=True")
+        if to_cycle is None:
+            to_cycle = 0xFFFFFFFFFFFFFFFF  # UINT64_MAX
+        self.lib.enable_waveform(self.handle, filename.encode(), from_cycle, to_cycle)
+
+    def disable_waveform(self):
+        """Disable waveform capture and close the file."""
+        self.lib.disable_waveform(self.handle)
+
+    # =========================================================================
+    # Clock control
+    # =========================================================================
+
+    def clock(self, n=1):
+        """Advance simulation by n clock cycles."""
+        if n == 1:
+            self.lib.clock_cycle(self.handle)
+        else:
+            self.lib.clock_n(self.handle, n)
+
+    def reset(self):
+        """Apply the reset sequence again."""
+        self.lib.reset_instance(self.handle)
+
+    # =========================================================================
+    # Bulk API
+    # =========================================================================
+
+    def sort(self, ranges, out=None, max_cycles=None):
+        """Load ranges, sort them and read the result back in native calls.
+
+        Args:
+            ranges: List of (start, end) tuples, or a C-contiguous uint64
+                numpy array of shape (N, 2), passed without copying
+            out: Optional C-contiguous uint64 numpy array of shape (N, 2)
+                the sorted ranges are written into
+            max_cycles: Sort cycle limit (default: sort_cycle_budget(N))
+
+        Returns:
+            The sorted ranges: out if given, otherwise a list of tuples
+        """
+        in_buf, count, _keep = range_buffer(ranges)
+        if count == 0:
+            return out if out is not None else []
+        if count > self.max_ranges:
+            raise ValueError(f"{count} ranges exceed max_ranges={self.max_ranges}")
+        if max_cycles is None:
+            max_cycles = sort_cycle_budget(count)
+        if out is None:
+            out_buf = (ctypes.c_uint64 * (2 * count))()
+        else:
+            out_buf, cap, _ = range_buffer(out)
+            if cap < count:
+                raise ValueError(f"output array holds {cap} ranges, need {count}")
+
+        # The sorter returns to IDLE after done, reset only to recover a timeout
+        self.lib.load_ranges(self.handle, in_buf, count)
+        emitted = self.lib.sort_ranges(self.handle, out_buf, count, max_cycles)
+        if emitted != count or not self.done:
+            self.reset()
+            raise TimeoutError(f"Sort emitted {emitted}/{count} ranges in {max_cycles} cycles")
+
+        if out is not None:
+            return out
+        return [(out_buf[2 * i], out_buf[2 * i + 1]) for i in range(count)]
+
+    @property
+    def last_run_cycles(self):
+        """Cycles taken by the last sort() from start to done."""
+        return self.lib.get_last_run_cycles(self.handle)
+
+    # =========================================================================
+    # Properties
+    # =========================================================================
+
+    @property
+    def cycle_count(self):
+        """Cycles simulated since creation (including reset)."""
+        return self.lib.get_cycle_count(self.handle)
+
+    @property
+    def done(self):
+        """True on the cycle the last range is emitted."""
+        return bool(self.lib.get_done(self.handle))
+
+    @property
+    def ready(self):
+        """True while idle and accepting ranges."""
+        return bool(self.lib.get_ready(self.handle))
+
+    @property
+    def busy(self):
+        """True while sorting."""
+        return bool(self.lib.get_busy(self.handle))
+
+
+# =============================================================================
+# Test
+# =============================================================================
+
+def main():
+    """Sort the test ranges and compare with Python's sorted()."""
+    import time
+    import argparse
+
+    sys.path.insert(0, ROOT)
+    from software_reference.range_merger import read_input
+
+    parser = argparse.ArgumentParser(description='MergeSortBRAM Verilator test')
+    parser.add_argument('input_file', nargs='?', default=os.path.join(ROOT, "testcases/default_input.txt"),
+                        help='Input file with ranges (default: testcases/default_input.txt)')
+    parser.add_argument('--max-ranges', type=int, default=4096,
+                        help='max_ranges the library was generated with (default: 4096)')
+    parser.add_argument('--waveform', '-w', metavar='FILE', help='Output FST waveform file')
+    parser.add_argument('--waveform-from-cycle', type=int, default=0,
+                        help='Start waveform capture at this cycle (default: 0)')
+    parser.add_argument('--waveform-to-cycle', type=int, default=None,
+                        help='Stop waveform capture at this cycle (default: unlimited)')
+    args = parser.parse_args()
+
+    print("MergeSortBRAM Test", file=sys.stderr)
+
+    sorter = MergeSort(trace=bool(args.waveform), max_ranges=args.max_ranges)
+    if args.waveform:
+        print(f"Waveform output: {args.waveform}", file=sys.stderr)
+        sorter.enable_waveform(args.waveform, args.waveform_from_cycle, args.waveform_to_cycle)
+
+    ranges, _ = read_input(args.input_file)
+    print(f"Sorting {len(ranges)} ranges...", file=sys.stderr)
+
+    start_time = time.time()
+    hw_sorted = sorter.sort(ranges)
+    elapsed = time.time() - start_time
+
+    # Reuse the instance for a second run to check it returns to IDLE
+    hw_again = sorter.sort(ranges[::-1])
+
+    print(f"\nResults:", file=sys.stderr)
+    print(f"  Ranges: {len(hw_sorted)}", file=sys.stderr)
+    print(f"  Cycles: {sorter.last_run_cycles}", file=sys.stderr)
+    print(f"  Time: {elapsed:.3f}s", file=sys.stderr)
+
+    if hw_sorted == sorted(ranges) and hw_again == hw_sorted:
+        print("  PASS: Output matches sorted()", file=sys.stderr)
+        return 0
+    else:
+        print("  FAIL: Output mismatch", file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,312 @@
+/**
+ * Parallel differential fuzz driver for the day 5 range modules.
+ *
+ * Each fuzz_<module>.cpp describes how to stream one range set through its
+ * wrapper (FuzzModule) and calls fuzz_main(). The driver generates random
+ * range sets, runs them on one model instance per worker thread and checks
+ * the output against range_merger_ref.h (sorted, or merged plus coverage).
+ *
+ * Case i uses seed base_seed + i, and everything about a case follows from
+ * its seed, so a failure is reproduced with --replay <seed>. Failing inputs
+ * are also written to <failure_dir>/<module>_<seed>.txt in the "start-end"
+ * testcase format read_input() and the Python tests accept.
+ *
+ * Usage: fuzz_<module> [--cases N] [--seed S] [--jobs J] [--max-len L]
+ *                      [--failures DIR] [--max-failures N] [--replay SEED]
+ */
+
+#pragma once
+
+#include "range_merger_ref.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+struct Instance;
+
+using range_merger_ref::Coverage;
+using range_merger_ref::Range;
+
+// What the DUT produced for one case
+struct FuzzResult {
+    std::vector<uint64_t> ranges;   // Interleaved {start, end} as emitted
+    Coverage coverage = 0;
+    bool finished = false;          // done / last_out seen within the cycle limit
+};
+
+struct FuzzModule {
+    const char* name;
+    uint32_t max_ranges;    // Largest set the model accepts
+    bool sorted_input;      // Stream the set sorted by start (range merger)
+    bool merged;            // Expect merged ranges and coverage, else only sorted ranges
+    Instance* (*create)();
+    void (*destroy)(Instance*);
+    // Stream in (interleaved {start, end}) through a freshly reset model
+    void (*run)(Instance*, const std::vector<uint64_t>& in, FuzzResult* out);
+};
+
+struct FuzzOptions {
+    uint64_t cases = 100000;
+    uint64_t seed = 1;
+    uint32_t jobs = 0;              // 0 = hardware concurrency
+    uint32_t max_len = 64;
+    const char* failure_dir = "fuzz_failures";
+    uint64_t max_failures = 10;     // Stop early after this many
+    bool replay = false;
+    uint64_t replay_seed = 0;
+};
+
+//==============================================================================
+// Case Generation
+//==============================================================================
+
+// splitmix64: cheap, seedable, and identical on every platform
+static inline uint64_t fuzz_next(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Range set for one seed. The value domain is picked per case: tiny domains
+// give duplicates, nesting and touching ranges; full 64-bit values exercise
+// the comparators and the 128-bit coverage carry.
+static inline std::vector<Range> fuzz_case(uint64_t seed, uint32_t max_len) {
+    uint64_t rng = seed;
+    uint32_t n = 1 + static_cast<uint32_t>(fuzz_next(&rng) % max_len);
+    if (fuzz_next(&rng) % 4 == 0) {
+        n = 1 + static_cast<uint32_t>(fuzz_next(&rng) % std::min<uint32_t>(max_len, 4));
+    }
+
+    uint64_t domain;
+    switch (fuzz_next(&rng) % 4) {
+    case 0: domain = 64; break;
+    case 1: domain = 1ull << 20; break;
+    case 2: domain = 1ull << 40; break;
+    default: domain = 0; break;  // Full 64-bit range
+    }
+    uint64_t max_width = domain ? std::max<uint64_t>(1, 2 * domain / n) : UINT64_MAX;
+
+    std::vector<Range> ranges(n);
+    for (Range& r : ranges) {
+        uint64_t bits = fuzz_next(&rng);
+        r.start = domain ? bits % domain : bits;
+        switch (fuzz_next(&rng) % 4) {
+        case 0: r.end = r.start; break;  // Single point
+        case 1: r.end = r.start + fuzz_next(&rng) % 4; break;  // Short, often touching
+        default: r.end = r.start + fuzz_next(&rng) % max_width; break;
+        }
+        if (r.end < r.start) {
+            r.end = UINT64_MAX;  // Clamp a wrapped end
+        }
+    }
+    return ranges;
+}
+
+//==============================================================================
+// Checking
+//==============================================================================
+
+static inline std::string fuzz_u128(Coverage v) {
+    char buf[48];
+    int i = sizeof(buf) - 1;
+    buf[i] = 0;
+    do {
+        buf[--i] = static_cast<char>('0' + static_cast<int>(v % 10));
+        v /= 10;
+    } while (v);
+    return std::string(buf + i);
+}
+
+// Empty string if r matches the reference for ranges, else what differs
+static inline std::string fuzz_check(const FuzzModule& m, const std::vector<Range>& ranges,
+                                     const FuzzResult& r) {
+    std::vector<Range> expected = ranges;
+    if (m.merged) {
+        expected = range_merger_ref::merge_all_ranges(expected);
+    } else {
+        std::sort(expected.begin(), expected.end());
+    }
+
+    char buf[160];
+    if (!r.finished) {
+        snprintf(buf, sizeof(buf), "timed out after %zu of %zu ranges", r.ranges.size() / 2, expected.size());
+        return buf;
+    }
+    if (r.ranges.size() / 2 != expected.size()) {
+        snprintf(buf, sizeof(buf), "%zu ranges out, expected %zu", r.ranges.size() / 2, expected.size());
+        return buf;
+    }
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (r.ranges[2 * i] != expected[i].start || r.ranges[2 * i + 1] != expected[i].end) {
+            snprintf(buf, sizeof(buf), "range %zu is %llu-%llu, expected %llu-%llu", i,
+                     static_cast<unsigned long long>(r.ranges[2 * i]),
+                     static_cast<unsigned long long>(r.ranges[2 * i + 1]),
+                     static_cast<unsigned long long>(expected[i].start),
+                     static_cast<unsigned long long>(expected[i].end));
+            return buf;
+        }
+    }
+    if (m.merged) {
+        Coverage cov = range_merger_ref::calculate_total_coverage(expected);
+        if (r.coverage != cov) {
+            return "coverage " + fuzz_u128(r.coverage) + ", expected " + fuzz_u128(cov);
+        }
+    }
+    return std::string();
+}
+
+// Stream one case through the model and check it
+static inline std::string fuzz_run_case(const FuzzModule& m, Instance* inst, uint64_t seed,
+                                        uint32_t max_len, std::vector<Range>* ranges) {
+    *ranges = fuzz_case(seed, max_len);
+    std::vector<Range> streamed = *ranges;
+    if (m.sorted_input) {
+        std::sort(streamed.begin(), streamed.end());
+    }
+    std::vector<uint64_t> in;
+    in.reserve(2 * streamed.size());
+    for (const Range& r : streamed) {
+        in.push_back(r.start);
+        in.push_back(r.end);
+    }
+    FuzzResult result;
+    m.run(inst, in, &result);
+    return fuzz_check(m, *ranges, result);
+}
+
+// Write the input in testcase format; returns the path (empty on failure)
+static inline std::string fuzz_save(const FuzzModule& m, const char* dir, uint64_t seed,
+                                    const std::vector<Range>& ranges) {
+    mkdir(dir, 0755);
+    std::string path = std::string(dir) + "/" + m.name + "_" + std::to_string(seed) + ".txt";
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        perror(path.c_str());
+        return std::string();
+    }
+    for (const Range& r : ranges) {
+        fprintf(f, "%llu-%llu\n", static_cast<unsigned long long>(r.start),
+                static_cast<unsigned long long>(r.end));
+    }
+    fclose(f);
+    return path;
+}
+
+//==============================================================================
+// Driver
+//==============================================================================
+
+static inline void fuzz_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--cases N] [--seed S] [--jobs J] [--max-len L] [--failures DIR] "
+                    "[--max-failures N] [--replay SEED]\n", prog);
+}
+
+static inline int fuzz_main(int argc, char** argv, const FuzzModule& m) {
+    FuzzOptions opt;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--cases") && i + 1 < argc) {
+            opt.cases = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            opt.seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--jobs") && i + 1 < argc) {
+            opt.jobs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if (!strcmp(argv[i], "--max-len") && i + 1 < argc) {
+            opt.max_len = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if (!strcmp(argv[i], "--failures") && i + 1 < argc) {
+            opt.failure_dir = argv[++i];
+        } else if (!strcmp(argv[i], "--max-failures") && i + 1 < argc) {
+            opt.max_failures = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            opt.replay = true;
+            opt.replay_seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            fuzz_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.max_len == 0) {
+        fuzz_usage(argv[0]);
+        return 2;
+    }
+    if (opt.max_len > m.max_ranges) {
+        fprintf(stderr, "--max-len %u exceeds the model's max_ranges, using %u\n", opt.max_len, m.max_ranges);
+        opt.max_len = m.max_ranges;
+    }
+
+    // Replay: one case, input and verdict on stderr
+    if (opt.replay) {
+        Instance* inst = m.create();
+        std::vector<Range> ranges;
+        std::string error = fuzz_run_case(m, inst, opt.replay_seed, opt.max_len, &ranges);
+        m.destroy(inst);
+        for (const Range& r : ranges) {
+            fprintf(stderr, "%llu-%llu\n", static_cast<unsigned long long>(r.start),
+                    static_cast<unsigned long long>(r.end));
+        }
+        fprintf(stderr, "seed %llu: %s\n", static_cast<unsigned long long>(opt.replay_seed),
+                error.empty() ? "PASS" : error.c_str());
+        return error.empty() ? 0 : 1;
+    }
+
+    uint32_t jobs = opt.jobs ? opt.jobs : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<uint64_t> next{0};
+    std::atomic<uint64_t> done{0};
+    std::atomic<uint64_t> failures{0};
+    std::mutex report;
+
+    auto worker = [&]() {
+        Instance* inst = m.create();
+        std::vector<Range> ranges;
+        for (;;) {
+            uint64_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= opt.cases || failures.load(std::memory_order_relaxed) >= opt.max_failures) {
+                break;
+            }
+            uint64_t seed = opt.seed + i;
+            std::string error = fuzz_run_case(m, inst, seed, opt.max_len, &ranges);
+            done.fetch_add(1, std::memory_order_relaxed);
+            if (!error.empty()) {
+                failures.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(report);
+                std::string path = fuzz_save(m, opt.failure_dir, seed, ranges);
+                printf("FAIL seed %llu (%zu ranges): %s%s%s\n", static_cast<unsigned long long>(seed),
+                       ranges.size(), error.c_str(), path.empty() ? "" : " -> ", path.c_str());
+                fflush(stdout);
+            }
+        }
+        m.destroy(inst);
+    };
+
+    fprintf(stderr, "Fuzzing %s: %llu cases from seed %llu, %u jobs, up to %u ranges\n", m.name,
+            static_cast<unsigned long long>(opt.cases), static_cast<unsigned long long>(opt.seed),
+            jobs, opt.max_len);
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t j = 0; j < jobs; j++) {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t ran = done.load();
+    fprintf(stderr, "  Cases: %llu\n", static_cast<unsigned long long>(ran));
+    fprintf(stderr, "  Failures: %llu\n", static_cast<unsigned long long>(failures.load()));
+    fprintf(stderr, "  Time: %.3fs\n", elapsed);
+    if (elapsed > 0) {
+        fprintf(stderr, "  Rate: %.0f cases/sec (%.1fM cases/hour)\n", ran / elapsed, ran / elapsed * 3600 / 1e6);
+    }
+    return failures.load() ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * Native differential fuzzer for rtl_interval_coverage (IntervalCoverage).
+ *
+ * Linked with rtl_interval_coverage.cpp and its trace-free model. Each
+ * unsorted case goes through load_ranges() and process_ranges() after a
+ * reset, so the sorter, the merger and the last_in handoff between them are
+ * all exercised; merged ranges and total_coverage are checked against
+ * range_merger_ref.h. See fuzz_driver.h for the options.
+ */
+
+#include "fuzz_driver.h"
+
+#ifndef FUZZ_MAX_RANGES
+#define FUZZ_MAX_RANGES 4096  // max_ranges the model was generated with
+#endif
+
+extern "C" {
+Instance* create_instance(uint32_t threads);
+void destroy_instance(Instance* inst);
+void reset_instance(Instance* inst);
+uint8_t get_done(Instance* inst);
+void get_total_coverage(Instance* inst, uint64_t* out);
+void load_ranges(Instance* inst, const uint64_t* se, uint32_t count);
+uint32_t process_ranges(Instance* inst, uint64_t* out, uint32_t cap, uint64_t max_cycles);
+}
+
+static Instance* create() { return create_instance(0); }
+
+static void run(Instance* inst, const std::vector<uint64_t>& in, FuzzResult* r) {
+    uint32_t count = static_cast<uint32_t>(in.size() / 2);
+    uint64_t max_cycles = 16ull * (count + 1) * (64 - __builtin_clzll(count)) + 1000 + count;
+    r->ranges.resize(in.size());
+    reset_instance(inst);
+    load_ranges(inst, in.data(), count);
+    uint32_t emitted = process_ranges(inst, r->ranges.data(), count, max_cycles);
+    r->finished = get_done(inst);
+    r->ranges.resize(2 * std::min(emitted, count));
+    uint64_t words[2];
+    get_total_coverage(inst, words);
+    r->coverage = static_cast<Coverage>(words[1]) << 64 | words[0];
+}
+
+int main(int argc, char** argv) {
+    FuzzModule m = {"rtl_interval_coverage", FUZZ_MAX_RANGES, false, true, create, destroy_instance, run};
+    return fuzz_main(argc, argv, m);
+}
@@ -0,0 +1,42 @@
+/**
+ * Native differential fuzzer for rtl_merge_sort (MergeSortBRAM).
+ *
+ * Linked with rtl_merge_sort.cpp and its trace-free model. Each unsorted
+ * case goes through load_ranges() and sort_ranges() and the output is checked
+ * against a (start, end) sort; the instance is reset between cases so a
+ * failing case does not leave the next one mid-sort. See fuzz_driver.h for
+ * the options.
+ */
+
+#include "fuzz_driver.h"
+
+#ifndef FUZZ_MAX_RANGES
+#define FUZZ_MAX_RANGES 4096  // max_ranges the model was generated with
+#endif
+
+extern "C" {
+Instance* create_instance(uint32_t threads);
+void destroy_instance(Instance* inst);
+void reset_instance(Instance* inst);
+uint8_t get_done(Instance* inst);
+void load_ranges(Instance* inst, const uint64_t* se, uint32_t count);
+uint32_t sort_ranges(Instance* inst, uint64_t* out, uint32_t cap, uint64_t max_cycles);
+}
+
+static Instance* create() { return create_instance(0); }
+
+static void run(Instance* inst, const std::vector<uint64_t>& in, FuzzResult* r) {
+    uint32_t count = static_cast<uint32_t>(in.size() / 2);
+    uint64_t max_cycles = 16ull * (count + 1) * (64 - __builtin_clzll(count)) + 1000 + count;
+    r->ranges.resize(in.size());
+    reset_instance(inst);
+    load_ranges(inst, in.data(), count);
+    uint32_t emitted = sort_ranges(inst, r->ranges.data(), count, max_cycles);
+    r->finished = get_done(inst);
+    r->ranges.resize(2 * std::min(emitted, count));
+}
+
+int main(int argc, char** argv) {
+    FuzzModule m = {"rtl_merge_sort", FUZZ_MAX_RANGES, false, false, create, destroy_instance, run};
+    return fuzz_main(argc, argv, m);
+}
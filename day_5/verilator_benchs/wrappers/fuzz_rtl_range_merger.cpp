@@ -0,0 +1,40 @@
+/**
+ * Native differential fuzzer for rtl_range_merger (RangeMerger).
+ *
+ * Linked with rtl_range_merger.cpp and its trace-free model. Each case is
+ * sorted, streamed through merge_ranges() after a reset, and the merged
+ * ranges and total_coverage are checked against range_merger_ref.h.
+ * See fuzz_driver.h for the options.
+ */
+
+#include "fuzz_driver.h"
+
+extern "C" {
+Instance* create_instance(uint32_t threads);
+void destroy_instance(Instance* inst);
+void reset_instance(Instance* inst);
+void get_total_coverage(Instance* inst, uint64_t* out);
+uint32_t merge_ranges(Instance* inst, const uint64_t* in, uint32_t count,
+                      uint64_t* out, uint32_t cap, uint64_t max_cycles);
+uint64_t get_last_run_cycles(Instance* inst);
+}
+
+static Instance* create() { return create_instance(0); }
+
+static void run(Instance* inst, const std::vector<uint64_t>& in, FuzzResult* r) {
+    uint32_t count = static_cast<uint32_t>(in.size() / 2);
+    uint64_t max_cycles = count + 16;
+    r->ranges.resize(in.size());
+    reset_instance(inst);
+    uint32_t emitted = merge_ranges(inst, in.data(), count, r->ranges.data(), count, max_cycles);
+    r->finished = get_last_run_cycles(inst) < max_cycles;
+    r->ranges.resize(2 * std::min(emitted, count));
+    uint64_t words[2];
+    get_total_coverage(inst, words);
+    r->coverage = static_cast<Coverage>(words[1]) << 64 | words[0];
+}
+
+int main(int argc, char** argv) {
+    FuzzModule m = {"rtl_range_merger", UINT32_MAX, true, true, create, destroy_instance, run};
+    return fuzz_main(argc, argv, m);
+}
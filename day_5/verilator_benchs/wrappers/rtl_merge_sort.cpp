@@ -0,0 +1,153 @@
+/**
+ * C wrapper for rtl_merge_sort (MergeSortBRAM) Verilator module.
+ * Exposes module signals as C functions for Python ctypes.
+ *
+ * All functions take the opaque handle returned by create_instance().
+ */
+
+#include "sim_instance.h"
+#include <cstdint>
+
+struct Instance : SimInstance {
+    uint64_t last_run_cycles = 0;  // Cycles taken by the last sort_ranges()
+};
+
+extern "C" {
+
+//==============================================================================
+// Lifecycle
+//==============================================================================
+
+Instance* create_instance(uint32_t threads) {
+    Instance* inst = new Instance;
+    sim_init(inst, threads);
+    // Initialize inputs
+    inst->dut->start_in = 0;
+    inst->dut->end_in = 0;
+    inst->dut->valid_in = 0;
+    inst->dut->count_in = 0;
+    inst->dut->start = 0;
+    return inst;
+}
+
+void destroy_instance(Instance* inst) {
+    if (!inst) return;
+    sim_cleanup(inst);
+    delete inst;
+}
+
+// Apply the reset sequence again (the cycle counter keeps running)
+void reset_instance(Instance* inst) {
+    sim_reset(inst);
+}
+
+//==============================================================================
+// Waveform Control
+//==============================================================================
+
+void enable_waveform(Instance* inst, const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
+    sim_enable_waveform(inst, filename, from_cycle, to_cycle);
+}
+
+void disable_waveform(Instance* inst) {
+    sim_disable_waveform(inst);
+}
+
+// 1 if this library was built with FST tracing, 0 for the trace-free variant
+uint8_t has_waveform_support() {
+    return SIM_TRACE;
+}
+
+//==============================================================================
+// Clock
+//==============================================================================
+
+void clock_cycle(Instance* inst) {
+    sim_clock_cycle(inst);
+}
+
+void clock_n(Instance* inst, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        sim_clock_cycle(inst);
+    }
+}
+
+uint64_t get_cycle_count(Instance* inst) {
+    return inst->sim_time / 2;
+}
+
+//==============================================================================
+// Input Signals
+//==============================================================================
+
+void set_start_in(Instance* inst, uint64_t v) { inst->dut->start_in = v; }
+void set_end_in(Instance* inst, uint64_t v) { inst->dut->end_in = v; }
+void set_valid_in(Instance* inst, uint8_t v) { inst->dut->valid_in = v; }
+void set_count_in(Instance* inst, uint32_t v) { inst->dut->count_in = v; }
+void set_start(Instance* inst, uint8_t v) { inst->dut->start = v; }
+
+//==============================================================================
+// Output Signals
+//==============================================================================
+
+uint64_t get_start_out(Instance* inst) { return inst->dut->start_out; }
+uint64_t get_end_out(Instance* inst) { return inst->dut->end_out; }
+uint8_t get_valid_out(Instance* inst) { return inst->dut->valid_out; }
+uint8_t get_done(Instance* inst) { return inst->dut->done; }
+uint8_t get_ready(Instance* inst) { return inst->dut->ready; }
+uint8_t get_busy(Instance* inst) { return inst->dut->busy; }
+
+//==============================================================================
+// Convenience Functions
+//==============================================================================
+
+// Stream count ranges from an interleaved {start0, end0, start1, end1, ...}
+// array into bank A, one per cycle, and set count_in. The sorter must be in
+// IDLE and count must not exceed the model's max_ranges.
+void load_ranges(Instance* inst, const uint64_t* se, uint32_t count) {
+    Vtop* dut = inst->dut;
+    dut->valid_in = 1;
+    for (uint32_t i = 0; i < count; i++) {
+        dut->start_in = se[2 * i];
+        dut->end_in = se[2 * i + 1];
+        sim_clock_cycle(inst);
+    }
+    dut->valid_in = 0;
+    dut->count_in = count;
+}
+
+// Pulse start and clock until done, storing the sorted ranges interleaved in
+// out (at most cap ranges). Returns the number of ranges emitted, which is
+// only short of count_in if max_cycles ran out; get_last_run_cycles() gives
+// the cycles taken including the start cycle.
+uint32_t sort_ranges(Instance* inst, uint64_t* out, uint32_t cap, uint64_t max_cycles) {
+    Vtop* dut = inst->dut;
+    dut->start = 1;
+    sim_clock_cycle(inst);
+    dut->start = 0;
+
+    uint64_t cycles = 1;
+    uint32_t emitted = 0;
+    while (cycles < max_cycles) {
+        sim_clock_cycle(inst);
+        cycles++;
+        if (dut->valid_out) {
+            if (emitted < cap) {
+                out[2 * emitted] = dut->start_out;
+                out[2 * emitted + 1] = dut->end_out;
+            }
+            emitted++;
+        }
+        if (dut->done) {
+            break;
+        }
+    }
+    inst->last_run_cycles = cycles;
+    return emitted;
+}
+
+uint64_t get_last_run_cycles(Instance* inst) {
+    return inst->last_run_cycles;
+}
+
+} // extern "C"
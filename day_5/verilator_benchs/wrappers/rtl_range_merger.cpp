@@ -0,0 +1,152 @@
+/**
+ * C wrapper for rtl_range_merger (RangeMerger) Verilator module.
+ * Exposes module signals as C functions for Python ctypes.
+ *
+ * All functions take the opaque handle returned by create_instance().
+ */
+
+#include "sim_instance.h"
+#include <cstdint>
+
+struct Instance : SimInstance {
+    uint64_t last_run_cycles = 0;  // Cycles taken by the last merge_ranges()
+};
+
+extern "C" {
+
+//==============================================================================
+// Lifecycle
+//==============================================================================
+
+Instance* create_instance(uint32_t threads) {
+    Instance* inst = new Instance;
+    sim_init(inst, threads);
+    // Initialize inputs
+    inst->dut->start_in = 0;
+    inst->dut->end_in = 0;
+    inst->dut->valid_in = 0;
+    inst->dut->last_in = 0;
+    return inst;
+}
+
+void destroy_instance(Instance* inst) {
+    if (!inst) return;
+    sim_cleanup(inst);
+    delete inst;
+}
+
+// Apply the reset sequence again (the cycle counter keeps running). The
+// merger stays in DONE after last_out, so each stream needs a fresh reset.
+void reset_instance(Instance* inst) {
+    sim_reset(inst);
+}
+
+//==============================================================================
+// Waveform Control
+//==============================================================================
+
+void enable_waveform(Instance* inst, const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
+    sim_enable_waveform(inst, filename, from_cycle, to_cycle);
+}
+
+void disable_waveform(Instance* inst) {
+    sim_disable_waveform(inst);
+}
+
+// 1 if this library was built with FST tracing, 0 for the trace-free variant
+uint8_t has_waveform_support() {
+    return SIM_TRACE;
+}
+
+//==============================================================================
+// Clock
+//==============================================================================
+
+void clock_cycle(Instance* inst) {
+    sim_clock_cycle(inst);
+}
+
+void clock_n(Instance* inst, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        sim_clock_cycle(inst);
+    }
+}
+
+uint64_t get_cycle_count(Instance* inst) {
+    return inst->sim_time / 2;
+}
+
+//==============================================================================
+// Input Signals
+//==============================================================================
+
+void set_start_in(Instance* inst, uint64_t v) { inst->dut->start_in = v; }
+void set_end_in(Instance* inst, uint64_t v) { inst->dut->end_in = v; }
+void set_valid_in(Instance* inst, uint8_t v) { inst->dut->valid_in = v; }
+void set_last_in(Instance* inst, uint8_t v) { inst->dut->last_in = v; }
+
+//==============================================================================
+// Output Signals
+//==============================================================================
+
+uint64_t get_start_out(Instance* inst) { return inst->dut->start_out; }
+uint64_t get_end_out(Instance* inst) { return inst->dut->end_out; }
+uint8_t get_valid_out(Instance* inst) { return inst->dut->valid_out; }
+uint8_t get_last_out(Instance* inst) { return inst->dut->last_out; }
+uint8_t get_ready(Instance* inst) { return inst->dut->ready; }
+
+// 128-bit total_coverage as {low, high} 64-bit words
+void get_total_coverage(Instance* inst, uint64_t* out) {
+    const auto& w = inst->dut->total_coverage;
+    out[0] = (uint64_t)w[1] << 32 | w[0];
+    out[1] = (uint64_t)w[3] << 32 | w[2];
+}
+
+//==============================================================================
+// Convenience Functions
+//==============================================================================
+
+// Stream count ranges, sorted by start, from an interleaved
+// {start0, end0, start1, end1, ...} array, one per cycle with last_in on the
+// final one, and clock until last_out. The merged ranges are stored
+// interleaved in out (at most cap ranges). Returns the number of ranges
+// emitted; get_last_run_cycles() gives the cycles taken. The merger must be
+// freshly reset and count must be at least 1.
+uint32_t merge_ranges(Instance* inst, const uint64_t* in, uint32_t count,
+                      uint64_t* out, uint32_t cap, uint64_t max_cycles) {
+    Vtop* dut = inst->dut;
+    uint64_t cycles = 0;
+    uint32_t emitted = 0;
+    bool last = false;
+    while (!last && cycles < max_cycles) {
+        if (cycles < count) {
+            dut->start_in = in[2 * cycles];
+            dut->end_in = in[2 * cycles + 1];
+            dut->valid_in = 1;
+            dut->last_in = cycles == count - 1;
+        } else {
+            dut->valid_in = 0;
+            dut->last_in = 0;
+        }
+        sim_clock_cycle(inst);
+        cycles++;
+        if (dut->valid_out) {
+            if (emitted < cap) {
+                out[2 * emitted] = dut->start_out;
+                out[2 * emitted + 1] = dut->end_out;
+            }
+            emitted++;
+            last = dut->last_out;
+        }
+    }
+    dut->valid_in = 0;
+    dut->last_in = 0;
+    inst->last_run_cycles = cycles;
+    return emitted;
+}
+
+uint64_t get_last_run_cycles(Instance* inst) {
+    return inst->last_run_cycles;
+}
+
+} // extern "C"
@@ -0,0 +1,152 @@
+/**
+ * Per-instance Verilator simulation state shared by all module wrappers.
+ *
+ * Every wrapper derives its opaque Instance handle from SimInstance, so each
+ * handle owns its own VerilatedContext, model and trace file. Independent
+ * handles can be driven concurrently from different threads.
+ *
+ * Build with -DSIM_TRACE=0 against a model Verilated without --trace-fst to
+ * compile all tracing out; the clock is then branch-free.
+ */
+
+#pragma once
+
+#ifndef SIM_TRACE
+#define SIM_TRACE 1
+#endif
+
+#include "Vtop.h"
+#include "verilated.h"
+#if SIM_TRACE
+#include "verilated_fst_c.h"
+#endif
+#include <cstdint>
+#include <cstdio>
+
+struct SimInstance {
+    VerilatedContext* ctx = nullptr;
+    Vtop* dut = nullptr;
+#if SIM_TRACE
+    VerilatedFstC* tfp = nullptr;
+#endif
+    uint64_t sim_time = 0;
+    uint64_t trace_from_cycle = 0;
+    uint64_t trace_to_cycle = UINT64_MAX;
+    bool tracing_enabled = false;
+};
+
+//==============================================================================
+// Lifecycle
+//==============================================================================
+
+// Hold rst for five cycles. The day 5 FSMs end in a terminal DONE state, so
+// this is also how an instance is reused for the next input set.
+static inline void sim_reset(SimInstance* s) {
+    s->dut->rst = 1;
+    for (int i = 0; i < 5; i++) {
+        s->dut->clk = 0; s->dut->eval();
+        s->dut->clk = 1; s->dut->eval();
+    }
+    s->dut->rst = 0;
+}
+
+// Create context and model, then apply the reset sequence.
+// threads sets the context thread count for models Verilated with --threads
+// (0 keeps the Verilator default); it is ignored for single-threaded builds.
+static inline void sim_init(SimInstance* s, uint32_t threads) {
+    s->ctx = new VerilatedContext;
+#if VM_THREADS
+    if (threads) {
+        s->ctx->threads(threads);
+    }
+#else
+    (void)threads;
+#endif
+    s->dut = new Vtop(s->ctx);
+    s->sim_time = 0;
+    sim_reset(s);
+}
+
+static inline void sim_cleanup(SimInstance* s) {
+#if SIM_TRACE
+    if (s->tfp) {
+        s->tfp->close();
+        delete s->tfp;
+        s->tfp = nullptr;
+    }
+#endif
+    if (s->dut) {
+        s->dut->final();
+        delete s->dut;
+        s->dut = nullptr;
+    }
+    if (s->ctx) {
+        delete s->ctx;
+        s->ctx = nullptr;
+    }
+    s->tracing_enabled = false;
+}
+
+//==============================================================================
+// Waveform Control
+//==============================================================================
+
+static inline void sim_enable_waveform(SimInstance* s, const char* filename,
+                                       uint64_t from_cycle, uint64_t to_cycle) {
+#if SIM_TRACE
+    if (s->tfp) {
+        s->tfp->close();
+        delete s->tfp;
+    }
+    s->tfp = new VerilatedFstC;
+    s->ctx->traceEverOn(true);
+    s->dut->trace(s->tfp, 99);  // Trace 99 levels of hierarchy
+    s->tfp->open(filename);
+    s->trace_from_cycle = from_cycle;
+    s->trace_to_cycle = to_cycle;
+    s->tracing_enabled = true;
+#else
+    (void)s; (void)from_cycle; (void)to_cycle;
+    fprintf(stderr, "Waveform %s not written: library built without tracing\n", filename);
+#endif
+}
+
+static inline void sim_disable_waveform(SimInstance* s) {
+#if SIM_TRACE
+    if (s->tfp) {
+        s->tfp->close();
+        delete s->tfp;
+        s->tfp = nullptr;
+    }
+#endif
+    s->tracing_enabled = false;
+}
+
+//==============================================================================
+// Clock
+//==============================================================================
+
+static inline void sim_clock_cycle(SimInstance* s) {
+#if SIM_TRACE
+    uint64_t cycle = s->sim_time / 2;
+    bool dump = s->tracing_enabled && cycle >= s->trace_from_cycle && cycle <= s->trace_to_cycle;
+#endif
+
+    s->dut->clk = 0;
+    s->dut->eval();
+#if SIM_TRACE
+    if (dump) {
+        s->tfp->dump(s->sim_time);
+    }
+#endif
+    s->sim_time++;
+
+    s->dut->clk = 1;
+    s->dut->eval();
+#if SIM_TRACE
+    if (dump) {
+        s->tfp->dump(s->sim_time);
+    }
+#endif
+    s->sim_time++;
+}
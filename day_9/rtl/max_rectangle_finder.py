@@ -16,13 +16,60 @@ Optimizations:
 - Area pruning (skip candidates that can't beat current max)
 - Pipelined vertex prefetch during validation
 - Merged FSM states for reduced latency
+- Optional candidate-parallel validation (num_lanes > 1): each lane is a
+  ValidateRectangle with its own polygon BRAM copy. GENERATE_RECT hands each
+  surviving candidate to a free lane and moves on; VALIDATE_WAIT only stalls
+  when every lane is busy. Lane results are merged into the max area as they
+  complete, and COMPLETE waits for all lanes to drain. Pruning compares
+  against the max seen so far, so with lanes in flight fewer candidates may
+  be pruned than in the single-lane search, but the result is the same.
+- Optional area-descending search (area_order=True): a histogram pass over
+  all pairs marks which log2 area buckets (bit length of the candidate area)
+  are occupied, then the pair scan is repeated once per occupied bucket from
+  the highest down, validating only that bucket's candidates. A large max is
+  found early and the search stops as soon as no remaining bucket can beat
+  it. rectangles_pruned then counts every non-degenerate pair that was not
+  validated, so tested + pruned is the same in both modes.
+- Optional edge index (edge_index_block = B > 0): each validator keeps the
+  bounding box of every block of B polygon edges and skips blocks that
+  cannot affect the candidate. edges_examined / edges_skipped total the
+  edges checked and skipped over the search.
+- Optional external vertex memory (cache_lines = C > 0): the polygon lives
+  off-chip and neither the finder nor the validator keeps a BRAM copy, so
+  max_vertices may go up to 65536. Both read it through a VertexCache of C
+  lines of line_vertices vertices per client, fetched in bursts over the
+  mem_req/mem_resp port. A miss freezes the whole search (clock enable)
+  until the line arrives, so the FSMs are unchanged; validation_cycles then
+  excludes the stalls, which are counted in cache_stall_cycles. The host
+  writes the polygon to memory and pulses ext_poly_valid with
+  ext_num_vertices instead of streaming it. Single lane, single edge, no
+  edge index.
+- Host backdoor preload: a simulator may write the polygon straight into
+  the vertex BRAMs, set num_vertices and poly_loaded and put the FSM in
+  WAIT_START; start_search then goes directly to INIT_SEARCH.
 
 Parameters
 ----------
 coord_width : int
     Coordinate width in bits (16-32, default 20).
 max_vertices : int
-    Maximum polygon vertices (3-8192, default 1024).
+    Maximum polygon vertices (3-8192, or 3-65536 with cache_lines > 0,
+    default 1024).
+num_lanes : int
+    Validator lanes (1-16, default 1).
+edges_per_cycle : int
+    Polygon edges each validator checks per cycle (1-16, default 1).
+area_order : bool
+    Visit candidates in descending log2 area buckets (default False).
+edge_index_block : int
+    Edges per validator edge-index block (power of two 2-64), 0 for no
+    index (default 0).
+cache_lines : int
+    Vertex cache lines per client for external vertex memory, a power of
+    two (2-256), or 0 to keep the polygon in BRAM (default 0).
+line_vertices : int
+    Vertices per cache line and memory burst, a power of two (2-64,
+    default 8).
 
 Interface
 ---------
@@ -31,6 +78,10 @@ Inputs:
     vertex_valid : Vertex data valid strobe
     vertex_last : Marks final vertex in polygon
     start_search : Begin rectangle search
+    ext_num_vertices, ext_poly_valid : Polygon written to external memory
+        (cache_lines > 0)
+    mem_req_ready, mem_resp_valid, mem_resp_data : External memory
+        (cache_lines > 0)
 
 Outputs:
     busy, done : Status signals
@@ -38,10 +89,23 @@ Outputs:
     max_area : Maximum area of valid rectangles
     rectangles_tested : Debug counter
     vertices_loaded : Debug counter
+    lane_busy : Per-lane validation in flight (a port only when num_lanes > 1)
+    verdict_valid : One-cycle strobe per validated candidate (these five are
+        ports only when num_lanes == 1)
+    verdict_outcome : VERDICT_* outcome of that candidate
+    verdict_cycles : Its validation cycles, start to done
+    verdict_fail_edge : Edge where CHECK 1/2 exited (fail_edge_index)
+    verdict_start_edge : Edge the validator's walk started from
+    edges_examined, edges_skipped : Edge-index counters (ports only when
+        edge_index_block > 0)
+    mem_req_valid, mem_req_addr : Burst request (cache_lines > 0)
+    cache_accesses, cache_misses, cache_stall_cycles : Vertex cache counters
+        for the last search (cache_lines > 0)
 """
 
 import sys
 import os
+from types import SimpleNamespace
 
 # Add project root to sys.path for imports
 _script_dir = os.path.dirname(os.path.abspath(__file__))
@@ -49,17 +113,41 @@ sys.path.insert(0, _script_dir)
 
 from amaranth import *
 from validate_rectangle import ValidateRectangle
+from vertex_cache import VertexCache
+
+
+# verdict_outcome encoding
+VERDICT_VALID = 0
+VERDICT_CHECK1 = 1   # Vertex strictly inside the rectangle
+VERDICT_CHECK2 = 2   # Edge crosses the shrunken rectangle
+VERDICT_CORNER = 3   # Full scan, a corner outside the polygon
 
 
 class MaxRectangleFinder(Elaboratable):
-    def __init__(self, coord_width: int = 20, max_vertices: int = 1024):
+    def __init__(self, coord_width: int = 20, max_vertices: int = 1024, num_lanes: int = 1,
+                 edges_per_cycle: int = 1, area_order: bool = False, edge_index_block: int = 0,
+                 cache_lines: int = 0, line_vertices: int = 8):
         if coord_width < 16 or coord_width > 32:
             raise ValueError(f"coord_width must be 16-32 bits, got {coord_width}")
-        if max_vertices < 3 or max_vertices > 8192:
-            raise ValueError(f"max_vertices must be 3-8192, got {max_vertices}")
+        max_cap = 65536 if cache_lines else 8192
+        if max_vertices < 3 or max_vertices > max_cap:
+            raise ValueError(f"max_vertices must be 3-{max_cap}, got {max_vertices}")
+        if num_lanes < 1 or num_lanes > 16:
+            raise ValueError(f"num_lanes must be 1-16, got {num_lanes}")
+        if edges_per_cycle < 1 or edges_per_cycle > 16:
+            raise ValueError(f"edges_per_cycle must be 1-16, got {edges_per_cycle}")
+        if cache_lines and (num_lanes > 1 or edges_per_cycle > 1 or edge_index_block):
+            raise ValueError("cache_lines requires num_lanes == 1, edges_per_cycle == 1 "
+                             "and edge_index_block == 0")
 
         self.coord_width = coord_width
         self.max_vertices = max_vertices
+        self.num_lanes = num_lanes
+        self.edges_per_cycle = edges_per_cycle
+        self.area_order = area_order
+        self.edge_index_block = edge_index_block
+        self.cache_lines = cache_lines
+        self.line_vertices = line_vertices
         self.addr_width = (max_vertices - 1).bit_length()
 
         # Vertex streaming interface
@@ -86,21 +174,72 @@ class MaxRectangleFinder(Elaboratable):
         self.debug_num_vertices = Signal(self.addr_width + 1)
         self.debug_rect_count = Signal(2 * self.addr_width)
         self.debug_max_area = Signal(2 * self.coord_width)
+        self.lane_busy = Signal(num_lanes)
+        self.edges_examined = Signal(32)
+        self.edges_skipped = Signal(32)
+
+        # Per-candidate validator verdict (single lane)
+        self.verdict_valid = Signal()
+        self.verdict_outcome = Signal(2)
+        self.verdict_cycles = Signal(max(16, self.addr_width + 2))  # ValidateRectangle width
+        self.verdict_fail_edge = Signal(self.addr_width)
+        self.verdict_start_edge = Signal(self.addr_width)
+
+        # External vertex memory (cache_lines > 0)
+        self.ext_num_vertices = Signal(self.addr_width + 1)
+        self.ext_poly_valid = Signal()
+        self.mem_req_valid = Signal()
+        self.mem_req_ready = Signal()
+        self.mem_req_addr = Signal(self.addr_width)
+        self.mem_resp_valid = Signal()
+        self.mem_resp_data = Signal(2 * coord_width)
+        self.cache_accesses = Signal(32)
+        self.cache_misses = Signal(32)
+        self.cache_stall_cycles = Signal(32)
 
     def elaborate(self, platform):
         m = Module()
 
         # ===== Vertex Storage BRAM =====
         from amaranth.hdl.mem import Memory
-        vertex_mem = Memory(width=2 * self.coord_width, depth=self.max_vertices, init=[])
-        read_port = vertex_mem.read_port(domain="sync", transparent=False)
-        write_port = vertex_mem.write_port(domain="sync")
-        m.submodules.vertex_mem_read = read_port
-        m.submodules.vertex_mem_write = write_port
-
-        # ===== ValidateRectangle Instance =====
-        validator = ValidateRectangle(coord_width=self.coord_width, max_vertices=self.max_vertices)
-        m.submodules.validator = validator
+        external = self.cache_lines > 0
+        if external:
+            # Read through the vertex cache with the same timing; the stream
+            # write port is left unconnected (the host writes the memory)
+            read_port = SimpleNamespace(addr=Signal(self.addr_width, name="fetch_addr"),
+                                        data=Signal(2 * self.coord_width, name="fetch_data"))
+            write_port = SimpleNamespace(addr=Signal(self.addr_width, name="unused_w_addr"),
+                                         data=Signal(2 * self.coord_width, name="unused_w_data"),
+                                         en=Signal(name="unused_w_en"))
+        else:
+            vertex_mem = Memory(width=2 * self.coord_width, depth=self.max_vertices, init=[])
+            read_port = vertex_mem.read_port(domain="sync", transparent=False)
+            write_port = vertex_mem.write_port(domain="sync")
+            m.submodules.vertex_mem_read = read_port
+            m.submodules.vertex_mem_write = write_port
+
+        # Every vertex read goes through fetch(), which also tells the cache
+        # that the data is needed next cycle
+        read_en = Signal()
+
+        def fetch(addr):
+            m.d.comb += read_port.addr.eq(addr)
+            if external:
+                m.d.comb += read_en.eq(1)
+
+        # Frozen cycles must not lose a start pulse, see the end of elaborate()
+        start_search = Signal() if external else self.start_search
+
+        # ===== ValidateRectangle Instances (one per lane) =====
+        multi_lane = self.num_lanes > 1
+        validators = []
+        for lane in range(self.num_lanes):
+            v = ValidateRectangle(coord_width=self.coord_width, max_vertices=self.max_vertices,
+                                  edges_per_cycle=self.edges_per_cycle,
+                                  index_block=self.edge_index_block, external=external)
+            m.submodules[f"validator_{lane}" if multi_lane else "validator"] = v
+            validators.append(v)
+        validator = validators[0]
 
         # ===== State Registers =====
         num_vertices = Signal(self.addr_width + 1)
@@ -112,6 +251,9 @@ class MaxRectangleFinder(Elaboratable):
 
         # Polygon loading counter
         poly_load_addr = Signal(self.addr_width)
+        # Validator BRAMs already hold this polygon: start skips LOAD_POLY_ONCE.
+        # Cleared by a streamed load; a host backdoor preload may set it.
+        poly_loaded = Signal()
 
         # Pruning counter
         pruned_count = Signal(2 * self.addr_width)
@@ -144,6 +286,8 @@ class MaxRectangleFinder(Elaboratable):
         valid_found = Signal()
         rect_count = Signal(2 * self.addr_width)
         validation_cycles_reg = Signal(32)
+        edges_examined_reg = Signal(32)
+        edges_skipped_reg = Signal(32)
         start_vertex_reg = Signal(self.addr_width)  # For circular edge iteration optimization
 
         # Pipeline registers for prefetching
@@ -160,21 +304,140 @@ class MaxRectangleFinder(Elaboratable):
             mem_y.eq(read_port.data[self.coord_width:]),
         ]
 
+        # Area-descending search (area_order only): bucket b holds candidate
+        # areas of bit length b, i.e. 2**(b-1) <= area < 2**b
+        area_order = self.area_order
+        num_buckets = 2 * self.coord_width + 1
+        histogram_pass = Signal()               # Pre-pass: mark occupied buckets only
+        bucket_present = Signal(num_buckets)    # Occupied buckets not yet searched
+        cur_bucket = Signal(range(num_buckets))  # Bucket searched by this pass
+        candidate_total = Signal(2 * self.addr_width)  # Non-degenerate pairs
+
+        if area_order:
+            gen_area = Signal(2 * self.coord_width)
+            gen_bucket = Signal(range(num_buckets))
+            m.d.comb += gen_area.eq((width_reg + 4) * (height_reg + 4))
+            for b in range(2 * self.coord_width):
+                with m.If(gen_area[b]):
+                    m.d.comb += gen_bucket.eq(b + 1)
+
+            # Next pass: highest occupied bucket below the current one, worth
+            # searching only if its largest area (2**b - 1) beats the max
+            remaining = Signal(num_buckets)
+            next_bucket = Signal(range(num_buckets))
+            m.d.comb += remaining.eq(bucket_present & ~(C(1, num_buckets) << cur_bucket))
+            for b in range(num_buckets):
+                with m.If(remaining[b]):
+                    m.d.comb += next_bucket.eq(b)
+            next_pass = Signal()
+            m.d.comb += next_pass.eq(remaining.any() & (((max_area_reg + 1) >> next_bucket) == 0))
+
+        # Per-lane state (multi-lane only)
+        lane_inflight = Signal(self.num_lanes)  # Lane has a candidate in validation
+        lane_area = [Signal(2 * self.coord_width, name=f"lane_area_{lane}")
+                     for lane in range(self.num_lanes)]
+        lane_start_vertex = [Signal(self.addr_width, name=f"lane_start_vertex_{lane}")
+                             for lane in range(self.num_lanes)]
+
         # Default validator inputs (can be overridden in states)
-        m.d.comb += [
-            validator.load_mode.eq(0),
-            validator.load_wr.eq(0),
-            validator.start.eq(0),
-            validator.rect_x.eq(cand_x),
-            validator.rect_y.eq(cand_y),
-            validator.rect_width.eq(cand_width),
-            validator.rect_height.eq(cand_height),
-            validator.num_vertices.eq(num_vertices),
-            validator.start_vertex.eq(start_vertex_reg),  # Circular iteration optimization
-            validator.load_addr.eq(0),
-            validator.load_data_x.eq(0),
-            validator.load_data_y.eq(0),
-        ]
+        for lane, v in enumerate(validators):
+            m.d.comb += [
+                v.load_mode.eq(0),
+                v.load_wr.eq(0),
+                v.start.eq(0),
+                v.num_vertices.eq(num_vertices),
+                v.load_addr.eq(0),
+                v.load_data_x.eq(0),
+                v.load_data_y.eq(0),
+            ]
+            if multi_lane:
+                # Lanes latch the rectangle on start, so all can share the pair registers
+                m.d.comb += [
+                    v.rect_x.eq(min_x_reg),
+                    v.rect_y.eq(min_y_reg),
+                    v.rect_width.eq(width_reg),
+                    v.rect_height.eq(height_reg),
+                    v.start_vertex.eq(lane_start_vertex[lane]),
+                ]
+            else:
+                m.d.comb += [
+                    v.rect_x.eq(cand_x),
+                    v.rect_y.eq(cand_y),
+                    v.rect_width.eq(cand_width),
+                    v.rect_height.eq(cand_height),
+                    v.start_vertex.eq(start_vertex_reg),  # Circular iteration optimization
+                ]
+
+        # Verdict of each validated candidate, straight from the validator's
+        # result registers (done is a one-cycle pulse)
+        if not multi_lane:
+            m.d.comb += [
+                self.verdict_valid.eq(validator.done),
+                self.verdict_outcome.eq(
+                    Mux(validator.check1_fail, VERDICT_CHECK1,
+                        Mux(validator.check2_fail, VERDICT_CHECK2,
+                            Mux(validator.is_valid, VERDICT_VALID, VERDICT_CORNER)))),
+                self.verdict_cycles.eq(validator.validation_cycles),
+                self.verdict_fail_edge.eq(validator.fail_edge_index),
+                self.verdict_start_edge.eq(start_vertex_reg),
+            ]
+
+        # ===== Lane Dispatch and Result Merge (multi-lane only) =====
+        if multi_lane:
+            m.d.comb += self.lane_busy.eq(lane_inflight)
+
+            # Lowest-numbered free lane takes the next candidate
+            lane_free = Signal()
+            free_lane = Signal(range(self.num_lanes))
+            m.d.comb += lane_free.eq(~lane_inflight.all())
+            for lane in reversed(range(self.num_lanes)):
+                with m.If(~lane_inflight[lane]):
+                    m.d.comb += free_lane.eq(lane)
+
+            def dispatch(area):
+                for lane, v in enumerate(validators):
+                    with m.If(free_lane == lane):
+                        m.d.comb += v.start.eq(1)
+                        m.d.sync += [
+                            lane_area[lane].eq(area),
+                            lane_inflight[lane].eq(1),
+                        ]
+
+            # Merge completions: any number of lanes may finish in one cycle
+            merged_area = max_area_reg
+            any_valid = C(0)
+            for lane, v in enumerate(validators):
+                lane_valid = v.done & v.is_valid
+                merged_area = Mux(lane_valid & (lane_area[lane] > merged_area),
+                                  lane_area[lane], merged_area)
+                any_valid = any_valid | lane_valid
+
+                with m.If(v.done):
+                    m.d.sync += lane_inflight[lane].eq(0)
+                    # Same start-vertex hint as the single lane, kept per lane
+                    with m.If(v.is_valid):
+                        m.d.sync += lane_start_vertex[lane].eq(0)
+                    with m.Elif(v.check1_fail | v.check2_fail):
+                        m.d.sync += lane_start_vertex[lane].eq(v.fail_edge_index)
+                    with m.Else():
+                        m.d.sync += lane_start_vertex[lane].eq(0)
+
+            lanes_done = sum(v.done for v in validators)
+            lanes_cycles = sum(Mux(v.done, v.validation_cycles, 0) for v in validators)
+            lanes_examined = sum(Mux(v.done, v.edges_examined, 0) for v in validators)
+            lanes_skipped = sum(Mux(v.done, v.edges_skipped, 0) for v in validators)
+            with m.If(lanes_done != 0):
+                m.d.sync += [
+                    rect_count.eq(rect_count + lanes_done),
+                    validation_cycles_reg.eq(validation_cycles_reg + lanes_cycles),
+                    edges_examined_reg.eq(edges_examined_reg + lanes_examined),
+                    edges_skipped_reg.eq(edges_skipped_reg + lanes_skipped),
+                ]
+            with m.If(any_valid):
+                m.d.sync += [
+                    max_area_reg.eq(merged_area),
+                    valid_found.eq(1),
+                ]
 
         # ===== FSM =====
         with m.FSM(domain="sync") as fsm:
@@ -184,12 +447,15 @@ class MaxRectangleFinder(Elaboratable):
                 self.debug_rect_count.eq(rect_count),
                 self.debug_max_area.eq(max_area_reg),
             ]
+            if not multi_lane:
+                m.d.comb += self.lane_busy.eq(fsm.ongoing("VALIDATE_WAIT"))
 
             # ===== VERTEX LOADING PHASE =====
             with m.State("IDLE"):
                 m.d.comb += self.busy.eq(0)
 
-                with m.If(self.vertex_valid):
+                # No vertex stream with external memory
+                with m.If(self.vertex_valid if not external else C(0)):
                     m.d.sync += [
                         self.done.eq(0),
                         write_port.addr.eq(0),
@@ -197,6 +463,7 @@ class MaxRectangleFinder(Elaboratable):
                         write_port.en.eq(1),
                         write_addr.eq(1),
                         num_vertices.eq(1),
+                        poly_loaded.eq(0),
                     ]
                     m.next = "LOAD_VERTICES"
                 with m.Else():
@@ -206,6 +473,14 @@ class MaxRectangleFinder(Elaboratable):
                         write_addr.eq(0),
                         num_vertices.eq(0),
                     ]
+                if external:
+                    # The host has written the polygon to external memory
+                    with m.If(self.ext_poly_valid):
+                        m.d.sync += [
+                            num_vertices.eq(self.ext_num_vertices),
+                            poly_loaded.eq(1),
+                        ]
+                        m.next = "WAIT_START"
 
             with m.State("LOAD_VERTICES"):
                 m.d.comb += self.busy.eq(0)
@@ -229,8 +504,9 @@ class MaxRectangleFinder(Elaboratable):
                 m.d.comb += self.busy.eq(0)
                 m.d.sync += write_port.en.eq(0)
 
-                with m.If(self.start_search):
+                with m.If(start_search):
                     m.d.sync += [
+                        self.done.eq(0),
                         rect_i.eq(0),
                         rect_j.eq(1),
                         rect_count.eq(0),
@@ -239,31 +515,43 @@ class MaxRectangleFinder(Elaboratable):
                         valid_found.eq(0),
                         poly_load_addr.eq(0),
                         validation_cycles_reg.eq(0),
+                        edges_examined_reg.eq(0),
+                        edges_skipped_reg.eq(0),
                         start_vertex_reg.eq(0),
+                        histogram_pass.eq(area_order),
+                        bucket_present.eq(0),
+                        cur_bucket.eq(0),
+                        candidate_total.eq(0),
                     ]
-                    m.d.comb += read_port.addr.eq(0)
-                    m.next = "LOAD_POLY_ONCE"
+                    m.d.sync += [svr.eq(0) for svr in lane_start_vertex]
+                    fetch(0)
+                    with m.If(poly_loaded):
+                        m.next = "INIT_SEARCH"
+                    with m.Else():
+                        m.next = "LOAD_POLY_ONCE"
 
             # ===== POLYGON LOADING (ONCE) =====
             with m.State("LOAD_POLY_ONCE"):
                 m.d.comb += self.busy.eq(1)
 
-                # Write vertex to ValidateRectangle memory
-                m.d.comb += [
-                    validator.load_mode.eq(1),
-                    validator.load_addr.eq(poly_load_addr),
-                    validator.load_data_x.eq(mem_x),
-                    validator.load_data_y.eq(mem_y),
-                    validator.load_wr.eq(1),
-                ]
+                # Write vertex to every lane's ValidateRectangle memory
+                for v in validators:
+                    m.d.comb += [
+                        v.load_mode.eq(1),
+                        v.load_addr.eq(poly_load_addr),
+                        v.load_data_x.eq(mem_x),
+                        v.load_data_y.eq(mem_y),
+                        v.load_wr.eq(1),
+                    ]
 
                 m.d.sync += poly_load_addr.eq(poly_load_addr + 1)
 
                 with m.If(poly_load_addr == num_vertices - 1):
-                    m.d.comb += read_port.addr.eq(0)
+                    m.d.sync += poly_loaded.eq(1)
+                    fetch(0)
                     m.next = "INIT_SEARCH"
                 with m.Else():
-                    m.d.comb += read_port.addr.eq(poly_load_addr + 1)
+                    fetch(poly_load_addr + 1)
 
             # ===== SEARCH PHASE =====
             with m.State("INIT_SEARCH"):
@@ -272,7 +560,7 @@ class MaxRectangleFinder(Elaboratable):
                     vertex_i_x.eq(mem_x),
                     vertex_i_y.eq(mem_y),
                 ]
-                m.d.comb += read_port.addr.eq(1)
+                fetch(1)
                 m.next = "FETCH_J"
 
             with m.State("FETCH_J"):
@@ -327,19 +615,37 @@ class MaxRectangleFinder(Elaboratable):
 
                 with m.If((width == 0) | (height == 0)):
                     m.next = "NEXT_RECT"
+                if area_order:
+                    with m.Elif(histogram_pass):
+                        m.d.sync += [
+                            bucket_present.eq(bucket_present | (C(1, num_buckets) << gen_bucket)),
+                            candidate_total.eq(candidate_total + 1),
+                        ]
+                        m.next = "NEXT_RECT"
+                    with m.Elif(gen_bucket != cur_bucket):
+                        # Searched in another pass
+                        m.next = "NEXT_RECT"
                 with m.Elif(candidate_area <= max_area_reg):
                     m.d.sync += pruned_count.eq(pruned_count + 1)
                     m.next = "NEXT_RECT"
                 with m.Else():
-                    # Start validation immediately using registered values
-                    m.d.comb += [
-                        validator.rect_x.eq(min_x_reg),
-                        validator.rect_y.eq(min_y_reg),
-                        validator.rect_width.eq(width_reg),  # Use registered width (OPTIMIZATION #9)
-                        validator.rect_height.eq(height_reg),  # Use registered height (OPTIMIZATION #9)
-                        validator.start.eq(1),
-                    ]
-                    m.next = "VALIDATE_WAIT"
+                    if multi_lane:
+                        # Hand off to a free lane and move on, or wait for one
+                        with m.If(lane_free):
+                            dispatch(candidate_area)
+                            m.next = "NEXT_RECT"
+                        with m.Else():
+                            m.next = "VALIDATE_WAIT"
+                    else:
+                        # Start validation immediately using registered values
+                        m.d.comb += [
+                            validator.rect_x.eq(min_x_reg),
+                            validator.rect_y.eq(min_y_reg),
+                            validator.rect_width.eq(width_reg),  # Use registered width (OPTIMIZATION #9)
+                            validator.rect_height.eq(height_reg),  # Use registered height (OPTIMIZATION #9)
+                            validator.start.eq(1),
+                        ]
+                        m.next = "VALIDATE_WAIT"
 
             with m.State("VALIDATE_WAIT"):
                 m.d.comb += self.busy.eq(1)
@@ -358,11 +664,11 @@ class MaxRectangleFinder(Elaboratable):
                             # Will complete after this validation - skip prefetch
                             m.d.sync += prefetch_state.eq(2)
                         with m.Else():
-                            m.d.comb += read_port.addr.eq(next_i_val)
+                            fetch(next_i_val)
                             m.d.sync += prefetch_state.eq(1)
                     with m.Else():
                         # Just fetch next j
-                        m.d.comb += read_port.addr.eq(next_j_val)
+                        fetch(next_j_val)
                         m.d.sync += prefetch_state.eq(1)
 
                 with m.Elif(prefetch_state == 1):
@@ -373,32 +679,43 @@ class MaxRectangleFinder(Elaboratable):
                         prefetch_state.eq(2),
                     ]
 
-                # State 2: captured, just wait for validator
-
-                with m.If(validator.done):
-                    m.d.sync += [
-                        rect_count.eq(rect_count + 1),
-                        # Accumulate validator's cycle count
-                        validation_cycles_reg.eq(validation_cycles_reg + validator.validation_cycles),
-                    ]
-
-                    # Merged UPDATE_MAX: Update max in same cycle if valid
-                    with m.If(validator.is_valid):
-                        # OPTIMIZATION #8: Use pre-registered area instead of combinatorial computation
-                        with m.If(cand_area > max_area_reg):
-                            m.d.sync += max_area_reg.eq(cand_area)
+                if multi_lane:
+                    # State 2: captured, wait for a lane. Lane results can raise the
+                    # max meanwhile, so the held candidate may be pruned instead
+                    with m.If(cand_area <= max_area_reg):
+                        m.d.sync += pruned_count.eq(pruned_count + 1)
+                        m.next = "NEXT_RECT"
+                    with m.Elif(lane_free):
+                        dispatch(cand_area)
+                        m.next = "NEXT_RECT"
+                else:
+                    # State 2: captured, just wait for validator
+                    with m.If(validator.done):
                         m.d.sync += [
-                            valid_found.eq(1),
-                            start_vertex_reg.eq(0),  # Reset after valid rectangle
+                            rect_count.eq(rect_count + 1),
+                            # Accumulate validator's cycle count
+                            validation_cycles_reg.eq(validation_cycles_reg + validator.validation_cycles),
+                            edges_examined_reg.eq(edges_examined_reg + validator.edges_examined),
+                            edges_skipped_reg.eq(edges_skipped_reg + validator.edges_skipped),
                         ]
-                    with m.Elif(validator.check1_fail | validator.check2_fail):
-                        # Early termination: use fail_edge for next validation
-                        m.d.sync += start_vertex_reg.eq(validator.fail_edge_index)
-                    with m.Else():
-                        # CHECK3 failed (tested all edges): reset to beginning
-                        m.d.sync += start_vertex_reg.eq(0)
 
-                    m.next = "NEXT_RECT"
+                        # Merged UPDATE_MAX: Update max in same cycle if valid
+                        with m.If(validator.is_valid):
+                            # OPTIMIZATION #8: Use pre-registered area instead of combinatorial computation
+                            with m.If(cand_area > max_area_reg):
+                                m.d.sync += max_area_reg.eq(cand_area)
+                            m.d.sync += [
+                                valid_found.eq(1),
+                                start_vertex_reg.eq(0),  # Reset after valid rectangle
+                            ]
+                        with m.Elif(validator.check1_fail | validator.check2_fail):
+                            # Early termination: use fail_edge for next validation
+                            m.d.sync += start_vertex_reg.eq(validator.fail_edge_index)
+                        with m.Else():
+                            # CHECK3 failed (tested all edges): reset to beginning
+                            m.d.sync += start_vertex_reg.eq(0)
+
+                        m.next = "NEXT_RECT"
 
             with m.State("NEXT_RECT"):
                 m.d.comb += self.busy.eq(1)
@@ -411,7 +728,22 @@ class MaxRectangleFinder(Elaboratable):
                 with m.If(will_need_new_i):
                     # Moving to next i
                     with m.If(next_i_val >= num_vertices - 1):
-                        m.next = "COMPLETE"
+                        if area_order:
+                            # End of a pass: rescan the pairs for the next bucket
+                            with m.If(next_pass):
+                                m.d.sync += [
+                                    histogram_pass.eq(0),
+                                    bucket_present.eq(remaining),
+                                    cur_bucket.eq(next_bucket),
+                                    rect_i.eq(0),
+                                    rect_j.eq(1),
+                                ]
+                                fetch(0)
+                                m.next = "INIT_SEARCH"
+                            with m.Else():
+                                m.next = "COMPLETE"
+                        else:
+                            m.next = "COMPLETE"
                     with m.Else():
                         m.d.sync += [
                             rect_i.eq(next_i_val),
@@ -423,10 +755,10 @@ class MaxRectangleFinder(Elaboratable):
                                 vertex_i_x.eq(prefetched_x),
                                 vertex_i_y.eq(prefetched_y),
                             ]
-                            m.d.comb += read_port.addr.eq(next_i_val + 1)
+                            fetch(next_i_val + 1)
                             m.next = "FETCH_J"
                         with m.Else():
-                            m.d.comb += read_port.addr.eq(next_i_val)
+                            fetch(next_i_val)
                             m.next = "FETCH_I"
                 with m.Else():
                     # Same i, next j
@@ -440,7 +772,7 @@ class MaxRectangleFinder(Elaboratable):
                         m.next = "REGISTER_PAIR"  # Go through REGISTER_PAIR to update min/max
                     with m.Else():
                         # Need to fetch j
-                        m.d.comb += read_port.addr.eq(next_j_val)
+                        fetch(next_j_val)
                         m.next = "FETCH_J"
 
             with m.State("FETCH_I"):
@@ -449,23 +781,73 @@ class MaxRectangleFinder(Elaboratable):
                     vertex_i_x.eq(mem_x),
                     vertex_i_y.eq(mem_y),
                 ]
-                m.d.comb += read_port.addr.eq(rect_j)
+                fetch(rect_j)
                 m.next = "FETCH_J"
 
             with m.State("COMPLETE"):
-                m.d.comb += self.busy.eq(0)
-                m.d.sync += [
-                    self.done.eq(1),
-                    self.valid.eq(valid_found),
-                    self.max_area.eq(max_area_reg),
-                    self.rectangles_tested.eq(rect_count),
-                    self.rectangles_pruned.eq(pruned_count),
-                    self.vertices_loaded.eq(num_vertices),
-                    self.validation_cycles.eq(validation_cycles_reg),
-                ]
-                m.next = "IDLE"
+                # Lanes still in flight can raise the max, wait for them
+                drained = ~lane_inflight.any() if multi_lane else C(1)
+                m.d.comb += self.busy.eq(~drained)
+                with m.If(drained):
+                    m.d.sync += [
+                        self.done.eq(1),
+                        self.valid.eq(valid_found),
+                        self.max_area.eq(max_area_reg),
+                        self.rectangles_tested.eq(rect_count),
+                        # Area order: pairs in skipped buckets count as pruned as well
+                        self.rectangles_pruned.eq(candidate_total - rect_count if area_order
+                                                  else pruned_count),
+                        self.vertices_loaded.eq(num_vertices),
+                        self.validation_cycles.eq(validation_cycles_reg),
+                        self.edges_examined.eq(edges_examined_reg),
+                        self.edges_skipped.eq(edges_skipped_reg),
+                    ]
+                    m.next = "IDLE"
+
+        if not external:
+            return m
+
+        # ===== External Vertex Memory =====
+        # The search above becomes a core clock-enabled by ~stall: a cache miss
+        # freezes the finder and validator until the line has been fetched
+        cache = VertexCache(data_width=2 * self.coord_width, addr_width=self.addr_width,
+                            num_ports=2, num_lines=self.cache_lines,
+                            line_vertices=self.line_vertices)
+        top = Module()
+        top.submodules.core = EnableInserter(~cache.stall)(m)
+        top.submodules.cache = cache
+
+        top.d.comb += [
+            # Port 0: finder pair reads, port 1: validator edge walk
+            cache.addr[0].eq(read_port.addr),
+            cache.en[0].eq(read_en),
+            read_port.data.eq(cache.data[0]),
+            cache.addr[1].eq(validator.ext_addr),
+            cache.en[1].eq(validator.ext_en),
+            validator.ext_data.eq(cache.data[1]),
+            cache.invalidate.eq(self.ext_poly_valid),
+            cache.clear.eq(self.start_search),
+            self.mem_req_valid.eq(cache.mem_req_valid),
+            self.mem_req_addr.eq(cache.mem_req_addr),
+            cache.mem_req_ready.eq(self.mem_req_ready),
+            cache.mem_resp_valid.eq(self.mem_resp_valid),
+            cache.mem_resp_data.eq(self.mem_resp_data),
+            self.cache_accesses.eq(cache.accesses),
+            self.cache_misses.eq(cache.misses),
+            self.cache_stall_cycles.eq(cache.stall_cycles),
+        ]
+
+        # The start cycle reads vertex 0 and may miss: hold the pulse until
+        # the core runs
+        start_hold = Signal()
+        top.d.comb += start_search.eq(self.start_search | start_hold)
+        with top.If(cache.stall):
+            with top.If(self.start_search):
+                top.d.sync += start_hold.eq(1)
+        with top.Else():
+            top.d.sync += start_hold.eq(0)
 
-        return m
+        return top
 
 
 if __name__ == "__main__":
@@ -473,15 +855,37 @@ if __name__ == "__main__":
     from amaranth.back import verilog
 
     output_path = sys.argv[1] if len(sys.argv) > 1 else "max_rectangle_finder.v"
-
-    top = MaxRectangleFinder(coord_width=20, max_vertices=1024)
-    v = verilog.convert(top, name="top", ports=[
+    max_vertices = int(sys.argv[2]) if len(sys.argv) > 2 else 1024
+    num_lanes = int(sys.argv[3]) if len(sys.argv) > 3 else 1
+    edges_per_cycle = int(sys.argv[4]) if len(sys.argv) > 4 else 1
+    area_order = bool(int(sys.argv[5])) if len(sys.argv) > 5 else False
+    edge_index_block = int(sys.argv[6]) if len(sys.argv) > 6 else 0
+    cache_lines = int(sys.argv[7]) if len(sys.argv) > 7 else 0
+    line_vertices = int(sys.argv[8]) if len(sys.argv) > 8 else 8
+
+    top = MaxRectangleFinder(coord_width=20, max_vertices=max_vertices, num_lanes=num_lanes,
+                             edges_per_cycle=edges_per_cycle, area_order=area_order,
+                             edge_index_block=edge_index_block, cache_lines=cache_lines,
+                             line_vertices=line_vertices)
+    ports = [
         top.vertex_x, top.vertex_y, top.vertex_valid, top.vertex_last,
         top.start_search, top.busy, top.done, top.valid, top.max_area,
         top.rectangles_tested, top.rectangles_pruned, top.vertices_loaded,
         top.validation_cycles, top.debug_state, top.debug_num_vertices,
         top.debug_rect_count, top.debug_max_area
-    ])
+    ]
+    if num_lanes > 1:
+        ports.append(top.lane_busy)
+    else:
+        ports += [top.verdict_valid, top.verdict_outcome, top.verdict_cycles,
+                  top.verdict_fail_edge, top.verdict_start_edge]
+    if edge_index_block:
+        ports += [top.edges_examined, top.edges_skipped]
+    if cache_lines:
+        ports += [top.ext_num_vertices, top.ext_poly_valid, top.mem_req_valid, top.mem_req_ready,
+                  top.mem_req_addr, top.mem_resp_valid, top.mem_resp_data,
+                  top.cache_accesses, top.cache_misses, top.cache_stall_cycles]
+    v = verilog.convert(top, name="top", ports=ports)
 
     with open(output_path, "w") as f:
         f.write(v)
@@ -1,5 +1,6 @@
 import sys
 import os
+from types import SimpleNamespace
 
 # Add project root to sys.path for imports
 _script_dir = os.path.dirname(os.path.abspath(__file__))
@@ -23,6 +24,20 @@ class ValidateRectangle(Elaboratable):
     - 4 parallel checks per edge (VRC, EIC, CV Ray-Cast, CV Boundary)
     - Early termination for CHECK 1/2 violations
     - Latency: num_vertices + 3 cycles
+    - Optional multi-edge datapath (edges_per_cycle = E > 1): E copies of
+      the vertex BRAM read at consecutive addresses and E copies of the
+      checks, so E edges are checked per cycle. Latency drops to about
+      num_vertices / E + 4 cycles; verdicts and fail_edge_index are the same
+    - Optional edge index (index_block = B > 0): while the polygon is loaded,
+      the bounding box of each block of B consecutive edges is written to an
+      index BRAM. Validation visits the same edges in the same order but
+      skips every block whose box cannot touch the rectangle or the corner
+      rays, at one cycle per skipped block; verdicts and fail_edge_index are
+      the same
+    - Optional external vertex memory (external=True): no BRAM; vertices are
+      read through ext_addr/ext_en/ext_data, a BRAM-like port served by the
+      finder's VertexCache. Cache misses freeze the validator through its
+      clock enable, so the FSM is the single-edge one unchanged
 
     Checks:
     - CHECK 1 (VRC): Polygon vertex strictly inside rectangle
@@ -35,7 +50,16 @@ class ValidateRectangle(Elaboratable):
     coord_width : int
         Coordinate width in bits (16-32, default 20).
     max_vertices : int
-        Maximum polygon vertices (3-8192, default 512).
+        Maximum polygon vertices (3-8192, or 3-65536 with external=True,
+        default 512).
+    edges_per_cycle : int
+        Polygon edges checked per cycle (1-16, default 1).
+    index_block : int
+        Edges per edge-index block, a power of two (2-64), or 0 for no
+        index (default 0). Single-edge datapath only.
+    external : bool
+        Read vertices from external memory instead of a BRAM (default
+        False). Single-edge datapath without index only.
 
     Interface
     ---------
@@ -44,22 +68,39 @@ class ValidateRectangle(Elaboratable):
         num_vertices : Polygon vertex count
         load_mode, load_addr, load_data_x, load_data_y, load_wr : BRAM load
         start : Begin validation
+        ext_data : Vertex read data (external=True only)
 
     Outputs:
         busy, done : Status
         is_valid : Result (valid when done=1)
         check1_fail, check2_fail, check3_fail : Debug outputs
         debug_edges_processed : Edge counter for benchmarking
+        edges_examined, edges_skipped : Edges checked / skipped by the index
+            in the last validation (index_block > 0 only)
+        ext_addr, ext_en : Vertex read address and request (external=True only)
     """
 
-    def __init__(self, coord_width: int = 20, max_vertices: int = 512):
+    def __init__(self, coord_width: int = 20, max_vertices: int = 512, edges_per_cycle: int = 1,
+                 index_block: int = 0, external: bool = False):
         if coord_width < 16 or coord_width > 32:
             raise ValueError(f"coord_width must be 16-32 bits, got {coord_width}")
-        if max_vertices < 3 or max_vertices > 8192:
-            raise ValueError(f"max_vertices must be 3-8192, got {max_vertices}")
+        max_cap = 65536 if external else 8192
+        if max_vertices < 3 or max_vertices > max_cap:
+            raise ValueError(f"max_vertices must be 3-{max_cap}, got {max_vertices}")
+        if edges_per_cycle < 1 or edges_per_cycle > 16:
+            raise ValueError(f"edges_per_cycle must be 1-16, got {edges_per_cycle}")
+        if index_block and (index_block < 2 or index_block > 64 or index_block & (index_block - 1)):
+            raise ValueError(f"index_block must be 0 or a power of two 2-64, got {index_block}")
+        if index_block and edges_per_cycle > 1:
+            raise ValueError("index_block requires edges_per_cycle == 1")
+        if external and (edges_per_cycle > 1 or index_block):
+            raise ValueError("external requires edges_per_cycle == 1 and index_block == 0")
 
         self.coord_width = coord_width
         self.max_vertices = max_vertices
+        self.edges_per_cycle = edges_per_cycle
+        self.index_block = index_block
+        self.external = external
         self.addr_width = (max_vertices - 1).bit_length()
 
         # Rectangle parameters
@@ -90,18 +131,36 @@ class ValidateRectangle(Elaboratable):
         self.check2_fail = Signal()
         self.check3_fail = Signal()
         self.debug_edges_processed = Signal(self.addr_width + 1)
-        self.validation_cycles = Signal(16)  # Cycles from start to done
+        self.validation_cycles = Signal(max(16, self.addr_width + 2))  # Cycles from start to done
         self.fail_edge_index = Signal(self.addr_width)  # Edge where CHECK1/2 failed
+        self.edges_examined = Signal(self.addr_width + 2)
+        self.edges_skipped = Signal(self.addr_width + 2)
+
+        # External vertex memory interface
+        self.ext_addr = Signal(self.addr_width)
+        self.ext_en = Signal()
+        self.ext_data = Signal(2 * coord_width)
 
     def elaborate(self, platform):
+        if self.edges_per_cycle > 1:
+            return self._elaborate_multi_edge()
+        if self.index_block:
+            return self._elaborate_edge_index()
+
         m = Module()
 
         # ===== BRAM for Polygon Vertices =====
-        vertex_mem = Memory(width=2 * self.coord_width, depth=self.max_vertices, init=[])
-        read_port = vertex_mem.read_port(domain="sync", transparent=False)
-        write_port = vertex_mem.write_port(domain="sync")
-        m.submodules.mem_read = read_port
-        m.submodules.mem_write = write_port
+        if self.external:
+            # Same read timing, served by the vertex cache; a read is needed
+            # from the start cycle until FINALIZE
+            read_port = SimpleNamespace(addr=self.ext_addr, data=self.ext_data)
+            m.d.comb += self.ext_en.eq(self.busy | (self.start & ~self.load_mode))
+        else:
+            vertex_mem = Memory(width=2 * self.coord_width, depth=self.max_vertices, init=[])
+            read_port = vertex_mem.read_port(domain="sync", transparent=False)
+            write_port = vertex_mem.write_port(domain="sync")
+            m.submodules.mem_read = read_port
+            m.submodules.mem_write = write_port
 
         # ===== Memory Control =====
         current_vertex = Signal(self.addr_width)
@@ -115,11 +174,12 @@ class ValidateRectangle(Elaboratable):
         ]
 
         # Memory write
-        m.d.comb += [
-            write_port.addr.eq(self.load_addr),
-            write_port.data.eq(Cat(self.load_data_x, self.load_data_y)),
-            write_port.en.eq(self.load_wr & self.load_mode),
-        ]
+        if not self.external:
+            m.d.comb += [
+                write_port.addr.eq(self.load_addr),
+                write_port.data.eq(Cat(self.load_data_x, self.load_data_y)),
+                write_port.en.eq(self.load_wr & self.load_mode),
+            ]
 
         # ===== Edge Registers =====
         edge_p1_x = Signal(self.coord_width)
@@ -132,7 +192,7 @@ class ValidateRectangle(Elaboratable):
         on_boundary = [Signal(name=f'on_boundary_{i}') for i in range(4)]
         check1_failed = Signal()
         check2_failed = Signal()
-        cycle_counter = Signal(16)  # Count cycles from start to done
+        cycle_counter = Signal(len(self.validation_cycles))  # Count cycles from start to done
 
         # ===== Registered Rectangle Boundaries (pipelined for timing) =====
         rect_x2_reg = Signal(self.coord_width)
@@ -408,3 +468,705 @@ class ValidateRectangle(Elaboratable):
                 m.next = "IDLE"
 
         return m
+
+    def _elaborate_multi_edge(self):
+        """Datapath checking E = edges_per_cycle edges per cycle.
+
+        Bank b is a full copy of the polygon, read at (base + b) mod n, so each
+        cycle delivers the next E vertices. With the last vertex of the previous
+        block they form E edges, checked in parallel; crossing counts and
+        boundary hits are merged per cycle. The same num_vertices + 1 edges as
+        in the single-edge datapath are visited (edges past that are masked),
+        and a CHECK 1/2 failure reports the first failing edge, so is_valid,
+        the fail flags and fail_edge_index match it exactly.
+        """
+        E = self.edges_per_cycle
+        m = Module()
+        n = self.num_vertices
+
+        def wrap(value):
+            # value mod n for value < 2n
+            return Mux(value >= n, value - n, value)
+
+        def const_mod_n(value):
+            # value mod n for a constant value <= E (n >= 3)
+            r = Const(value, range(E + 1))
+            for _ in range(value // 3):
+                r = Mux(r >= n, r - n, r)
+            return r
+
+        # ===== Banked BRAM (one polygon copy per edge slot) =====
+        read_ports = []
+        bank_x = []
+        bank_y = []
+        for b in range(E):
+            vertex_mem = Memory(width=2 * self.coord_width, depth=self.max_vertices, init=[])
+            read_port = vertex_mem.read_port(domain="sync", transparent=False)
+            write_port = vertex_mem.write_port(domain="sync")
+            m.submodules[f"mem_read_{b}"] = read_port
+            m.submodules[f"mem_write_{b}"] = write_port
+            m.d.comb += [
+                write_port.addr.eq(self.load_addr),
+                write_port.data.eq(Cat(self.load_data_x, self.load_data_y)),
+                write_port.en.eq(self.load_wr & self.load_mode),
+            ]
+            read_ports.append(read_port)
+            bank_x.append(read_port.data[:self.coord_width])
+            bank_y.append(read_port.data[self.coord_width:])
+
+        # Next read address per bank, and the address behind each bank's data
+        bank_addr = [Signal(self.addr_width, name=f"bank_addr_{b}") for b in range(E)]
+        fetch_addr = [Signal(self.addr_width, name=f"fetch_addr_{b}") for b in range(E)]
+        addr_step = Signal(self.addr_width)  # E mod n
+        for b in range(E):
+            m.d.comb += read_ports[b].addr.eq(bank_addr[b])
+
+        def advance_banks():
+            for b in range(E):
+                m.d.sync += [
+                    fetch_addr[b].eq(bank_addr[b]),
+                    bank_addr[b].eq(wrap(bank_addr[b] + addr_step)),
+                ]
+
+        # ===== Edge Window =====
+        # Edge e of the current block is (win[e], win[e + 1]); win_index holds
+        # the vertex index of each slot for fail_edge_index
+        win_x = [Signal(self.coord_width, name=f"win_x_{e}") for e in range(E + 1)]
+        win_y = [Signal(self.coord_width, name=f"win_y_{e}") for e in range(E + 1)]
+        win_index = [Signal(self.addr_width, name=f"win_index_{e}") for e in range(E + 1)]
+
+        def load_window_tail():
+            for b in range(E):
+                m.d.sync += [
+                    win_x[b + 1].eq(bank_x[b]),
+                    win_y[b + 1].eq(bank_y[b]),
+                    win_index[b + 1].eq(fetch_addr[b]),
+                ]
+
+        # ===== Validation State =====
+        edge_counter = Signal(range(self.max_vertices + 2 * E))
+        crossings = [Signal(16, name=f'crossings_{i}') for i in range(4)]
+        on_boundary = [Signal(name=f'on_boundary_{i}') for i in range(4)]
+        check1_failed = Signal()
+        check2_failed = Signal()
+        cycle_counter = Signal(len(self.validation_cycles))  # Count cycles from start to done
+
+        # ===== Registered Rectangle (same pipelining as the single-edge datapath) =====
+        rect_x_reg = Signal(self.coord_width)
+        rect_y_reg = Signal(self.coord_width)
+        rect_width_reg = Signal(self.coord_width)
+        rect_height_reg = Signal(self.coord_width)
+        rect_x2_reg = Signal(self.coord_width)
+        rect_y2_reg = Signal(self.coord_width)
+        shrunk_x1_reg = Signal(self.coord_width)
+        shrunk_x2_reg = Signal(self.coord_width)
+        shrunk_y1_reg = Signal(self.coord_width)
+        shrunk_y2_reg = Signal(self.coord_width)
+        corner_x_reg = [Signal(self.coord_width, name=f"corner_x_reg_{c}") for c in range(4)]
+        corner_y_reg = [Signal(self.coord_width, name=f"corner_y_reg_{c}") for c in range(4)]
+
+        # ===== E Copies of the Checks =====
+        # CornerValidationCheck computes edge min/max from p1/p2, so its
+        # pre-registered min/max inputs are left undriven here
+        edge_active = []
+        check1_violation = []
+        check2_violation = []
+        cv_crossing_inc = [[] for _ in range(4)]
+        cv_boundary_set = [[] for _ in range(4)]
+        for e in range(E):
+            check1 = VertexInRectangleCheck(coord_width=self.coord_width)
+            check2 = EdgeIntersectionCheck(coord_width=self.coord_width)
+            m.submodules[f"check1_{e}"] = check1
+            m.submodules[f"check2_{e}"] = check2
+            m.d.comb += [
+                check1.edge_p1_x.eq(win_x[e]),
+                check1.edge_p1_y.eq(win_y[e]),
+                check1.rect_x.eq(rect_x_reg),
+                check1.rect_y.eq(rect_y_reg),
+                check1.rect_x2.eq(rect_x2_reg),
+                check1.rect_y2.eq(rect_y2_reg),
+                check2.edge_p1_x.eq(win_x[e]),
+                check2.edge_p1_y.eq(win_y[e]),
+                check2.edge_p2_x.eq(win_x[e + 1]),
+                check2.edge_p2_y.eq(win_y[e + 1]),
+                check2.shrunk_x1.eq(shrunk_x1_reg),
+                check2.shrunk_x2.eq(shrunk_x2_reg),
+                check2.shrunk_y1.eq(shrunk_y1_reg),
+                check2.shrunk_y2.eq(shrunk_y2_reg),
+            ]
+            active = Signal(name=f"edge_active_{e}")
+            m.d.comb += active.eq(edge_counter + e <= n)
+            edge_active.append(active)
+            check1_violation.append(active & check1.violation)
+            check2_violation.append(active & check2.violation)
+
+            for c in range(4):
+                cv = CornerValidationCheck(coord_width=self.coord_width)
+                m.submodules[f'cv_{e}_{c}'] = cv
+                m.d.comb += [
+                    cv.edge_p1_x.eq(win_x[e]),
+                    cv.edge_p1_y.eq(win_y[e]),
+                    cv.edge_p2_x.eq(win_x[e + 1]),
+                    cv.edge_p2_y.eq(win_y[e + 1]),
+                    cv.corner_x.eq(corner_x_reg[c]),
+                    cv.corner_y.eq(corner_y_reg[c]),
+                    cv.on_boundary.eq(on_boundary[c]),
+                ]
+                cv_crossing_inc[c].append(active & cv.crossing_inc)
+                cv_boundary_set[c].append(active & cv.boundary_set)
+
+        any_violation = Signal()
+        m.d.comb += any_violation.eq(Cat(*check1_violation, *check2_violation).any())
+
+        # ===== Final Validation =====
+        all_corners_valid = Signal()
+        m.d.comb += all_corners_valid.eq(
+            (on_boundary[0] | crossings[0][0]) &
+            (on_boundary[1] | crossings[1][0]) &
+            (on_boundary[2] | crossings[2][0]) &
+            (on_boundary[3] | crossings[3][0])
+        )
+
+        m.d.comb += self.debug_edges_processed.eq(edge_counter)
+
+        # ===== FSM (same states as the single-edge datapath) =====
+        with m.FSM(domain="sync"):
+            with m.State("IDLE"):
+                m.d.comb += self.busy.eq(0)
+
+                for c in range(4):
+                    m.d.sync += [crossings[c].eq(0), on_boundary[c].eq(0)]
+                m.d.sync += [
+                    check1_failed.eq(0),
+                    check2_failed.eq(0),
+                    self.done.eq(0),
+                    self.check1_fail.eq(0),
+                    self.check2_fail.eq(0),
+                    self.check3_fail.eq(0),
+                    self.is_valid.eq(0),
+                    edge_counter.eq(0),
+                    cycle_counter.eq(0),
+                    self.fail_edge_index.eq(0),
+                ]
+
+                with m.If(self.start & ~self.load_mode):
+                    # Bank b starts at start_vertex + 1 + b; bank 0 first fetches start_vertex
+                    m.d.comb += read_ports[0].addr.eq(self.start_vertex)
+                    m.d.sync += [
+                        win_index[0].eq(self.start_vertex),
+                        addr_step.eq(const_mod_n(E)),
+                        cycle_counter.eq(1),
+                        rect_x_reg.eq(self.rect_x),
+                        rect_y_reg.eq(self.rect_y),
+                        rect_width_reg.eq(self.rect_width),
+                        rect_height_reg.eq(self.rect_height),
+                    ]
+                    for b in range(E):
+                        m.d.sync += bank_addr[b].eq(wrap(self.start_vertex + const_mod_n(b + 1)))
+                    m.next = "INIT_FETCH_V1"
+
+            with m.State("INIT_FETCH_V1"):
+                m.d.comb += self.busy.eq(1)
+                m.d.sync += [
+                    win_x[0].eq(bank_x[0]),
+                    win_y[0].eq(bank_y[0]),
+                    cycle_counter.eq(cycle_counter + 1),
+                ]
+                advance_banks()
+                m.next = "INIT_FETCH_V2"
+
+            with m.State("INIT_FETCH_V2"):
+                m.d.comb += self.busy.eq(1)
+                load_window_tail()
+                advance_banks()
+                m.d.sync += [
+                    edge_counter.eq(0),
+                    cycle_counter.eq(cycle_counter + 1),
+                    rect_x2_reg.eq(rect_x_reg + rect_width_reg),
+                    rect_y2_reg.eq(rect_y_reg + rect_height_reg),
+                    shrunk_x1_reg.eq(rect_x_reg + 1),
+                    shrunk_x2_reg.eq(rect_x_reg + rect_width_reg - 1),
+                    shrunk_y1_reg.eq(rect_y_reg + 1),
+                    shrunk_y2_reg.eq(rect_y_reg + rect_height_reg - 1),
+                    corner_x_reg[0].eq(rect_x_reg),
+                    corner_y_reg[0].eq(rect_y_reg),
+                    corner_x_reg[1].eq(rect_x_reg + rect_width_reg),
+                    corner_y_reg[1].eq(rect_y_reg),
+                    corner_x_reg[2].eq(rect_x_reg + rect_width_reg),
+                    corner_y_reg[2].eq(rect_y_reg + rect_height_reg),
+                    corner_x_reg[3].eq(rect_x_reg),
+                    corner_y_reg[3].eq(rect_y_reg + rect_height_reg),
+                ]
+                m.next = "PROCESS_PIPELINE"
+
+            with m.State("PROCESS_PIPELINE"):
+                m.d.comb += self.busy.eq(1)
+                m.d.sync += cycle_counter.eq(cycle_counter + 1)
+
+                with m.If(any_violation):
+                    # Early termination: report the first failing edge of the block
+                    for e in reversed(range(E)):
+                        with m.If(check1_violation[e] | check2_violation[e]):
+                            m.d.sync += [
+                                check1_failed.eq(check1_violation[e]),
+                                check2_failed.eq(check2_violation[e]),
+                                self.fail_edge_index.eq(win_index[e]),
+                            ]
+                    m.next = "FINALIZE"
+                with m.Else():
+                    # Merge the block's crossing counts and boundary hits
+                    for c in range(4):
+                        m.d.sync += crossings[c].eq(crossings[c] + sum(cv_crossing_inc[c]))
+                        with m.If(Cat(*cv_boundary_set[c]).any()):
+                            m.d.sync += on_boundary[c].eq(1)
+
+                    m.d.sync += edge_counter.eq(edge_counter + E)
+
+                    with m.If(edge_counter + E > n):
+                        m.next = "FINALIZE"
+                    with m.Else():
+                        # Slide the window by E vertices
+                        m.d.sync += [
+                            win_x[0].eq(win_x[E]),
+                            win_y[0].eq(win_y[E]),
+                            win_index[0].eq(win_index[E]),
+                        ]
+                        load_window_tail()
+                        advance_banks()
+
+            with m.State("FINALIZE"):
+                m.d.comb += self.busy.eq(0)
+
+                with m.If(check1_failed | check2_failed):
+                    m.d.sync += [
+                        self.is_valid.eq(0),
+                        self.check1_fail.eq(check1_failed),
+                        self.check2_fail.eq(check2_failed),
+                        self.check3_fail.eq(0),
+                    ]
+                with m.Else():
+                    m.d.sync += [
+                        self.is_valid.eq(all_corners_valid),
+                        self.check1_fail.eq(0),
+                        self.check2_fail.eq(0),
+                        self.check3_fail.eq(~all_corners_valid),
+                    ]
+
+                m.d.sync += [
+                    self.done.eq(1),
+                    self.validation_cycles.eq(cycle_counter + 1),  # +1 for FINALIZE cycle
+                ]
+                m.next = "IDLE"
+
+        return m
+
+    def _elaborate_edge_index(self):
+        """Single-edge datapath with a block bounding-box edge index.
+
+        Edge e runs from vertex e to vertex e + 1, and block t holds edges
+        t*B .. t*B + B - 1. Its index entry is the bounding box of vertices
+        t*B .. t*B + B (the last block wraps to vertex 0), built on the fly
+        as the polygon is loaded. An edge outside the box cannot hold a
+        vertex inside the rectangle, cross it, contain a corner, or cross a
+        corner's ray (p1.x <= corner.x, corner.y in [ymin, ymax)), so a
+        block is skipped if its box misses the closed rectangle and neither
+        corner row falls in [box ymin, box ymax) at or left of rect_x2.
+
+        The num_vertices + 1 edges of the single-edge datapath are visited
+        in the same order from start_vertex, minus skipped blocks, so the
+        crossing counts, the first failing edge and therefore is_valid and
+        fail_edge_index are unchanged. Entering a block costs one cycle for
+        the index lookup and, if the block is scanned, two to fetch its first
+        edge; a scanned block whose successor is known to be needed streams
+        straight into it.
+        """
+        B = self.index_block
+        log_b = B.bit_length() - 1
+        num_blocks = -(-self.max_vertices // B)
+        m = Module()
+        n = self.num_vertices
+        cw = self.coord_width
+
+        # ===== BRAM for Polygon Vertices =====
+        vertex_mem = Memory(width=2 * cw, depth=self.max_vertices, init=[])
+        read_port = vertex_mem.read_port(domain="sync", transparent=False)
+        write_port = vertex_mem.write_port(domain="sync")
+        m.submodules.mem_read = read_port
+        m.submodules.mem_write = write_port
+
+        mem_data_x = Signal(cw)
+        mem_data_y = Signal(cw)
+        m.d.comb += [
+            mem_data_x.eq(read_port.data[:cw]),
+            mem_data_y.eq(read_port.data[cw:]),
+            write_port.addr.eq(self.load_addr),
+            write_port.data.eq(Cat(self.load_data_x, self.load_data_y)),
+            write_port.en.eq(self.load_wr & self.load_mode),
+        ]
+
+        # ===== Edge Index BRAM: {xmin, xmax, ymin, ymax} per block =====
+        index_mem = Memory(width=4 * cw, depth=num_blocks, init=[])
+        index_read = index_mem.read_port(domain="sync", transparent=False)
+        index_write = index_mem.write_port(domain="sync")
+        m.submodules.index_read = index_read
+        m.submodules.index_write = index_write
+
+        def bbox_merge(box, x, y):
+            xmin, xmax, ymin, ymax = box
+            return (Mux(x < xmin, x, xmin), Mux(x > xmax, x, xmax),
+                    Mux(y < ymin, y, ymin), Mux(y > ymax, y, ymax))
+
+        # ===== Index Build (during polygon load) =====
+        run_box = [Signal(cw, name=f"run_box_{k}") for k in range(4)]
+        first_x = Signal(cw)  # Vertex 0, closes the last block
+        first_y = Signal(cw)
+        last_pending = Signal()  # Last block written the cycle after its vertex
+        last_block = Signal(range(num_blocks))
+        last_box = [Signal(cw, name=f"last_box_{k}") for k in range(4)]
+
+        load_x = self.load_data_x
+        load_y = self.load_data_y
+        block_start = self.load_addr[:log_b] == 0
+        merged = bbox_merge(run_box, load_x, load_y)
+        point = (load_x, load_x, load_y, load_y)
+
+        with m.If(self.load_wr & self.load_mode):
+            with m.If(self.load_addr == 0):
+                m.d.sync += [first_x.eq(load_x), first_y.eq(load_y)]
+            with m.If(block_start):
+                # The block start vertex also ends the previous block
+                m.d.sync += [r.eq(v) for r, v in zip(run_box, point)]
+                with m.If(self.load_addr != 0):
+                    m.d.comb += [
+                        index_write.addr.eq((self.load_addr >> log_b) - 1),
+                        index_write.data.eq(Cat(*merged)),
+                        index_write.en.eq(1),
+                    ]
+            with m.Else():
+                m.d.sync += [r.eq(v) for r, v in zip(run_box, merged)]
+            with m.If(self.load_addr == n - 1):
+                tail = [Mux(block_start, p, v) for p, v in zip(point, merged)]
+                m.d.sync += [
+                    last_pending.eq(1),
+                    last_block.eq(self.load_addr >> log_b),
+                ]
+                m.d.sync += [r.eq(v) for r, v in zip(last_box, bbox_merge(tail, first_x, first_y))]
+        with m.If(last_pending):
+            m.d.sync += last_pending.eq(0)
+            m.d.comb += [
+                index_write.addr.eq(last_block),
+                index_write.data.eq(Cat(*last_box)),
+                index_write.en.eq(1),
+            ]
+
+        # ===== Registered Rectangle (same pipelining as the single-edge datapath) =====
+        rect_x_reg = Signal(cw)
+        rect_y_reg = Signal(cw)
+        rect_width_reg = Signal(cw)
+        rect_height_reg = Signal(cw)
+        rect_x2_reg = Signal(cw)
+        rect_y2_reg = Signal(cw)
+        shrunk_x1_reg = Signal(cw)
+        shrunk_x2_reg = Signal(cw)
+        shrunk_y1_reg = Signal(cw)
+        shrunk_y2_reg = Signal(cw)
+        corner_x_reg = [Signal(cw, name=f"corner_x_reg_{c}") for c in range(4)]
+        corner_y_reg = [Signal(cw, name=f"corner_y_reg_{c}") for c in range(4)]
+
+        # ===== Block Skip Test =====
+        # index_block_q is the block behind index_read.data (the address of the
+        # previous cycle); index_addr holds it unless a state moves it
+        index_addr = Signal(range(num_blocks))
+        index_block_q = Signal(range(num_blocks))
+        m.d.comb += [
+            index_read.addr.eq(index_addr),
+            index_addr.eq(index_block_q),
+        ]
+        m.d.sync += index_block_q.eq(index_addr)
+
+        box_xmin = index_read.data[0 * cw:1 * cw]
+        box_xmax = index_read.data[1 * cw:2 * cw]
+        box_ymin = index_read.data[2 * cw:3 * cw]
+        box_ymax = index_read.data[3 * cw:4 * cw]
+        box_left = box_xmin <= rect_x2_reg
+        box_overlap = (box_left & (box_xmax >= rect_x_reg) &
+                       (box_ymin <= rect_y2_reg) & (box_ymax >= rect_y_reg))
+        box_ray = box_left & (((box_ymin <= rect_y_reg) & (rect_y_reg < box_ymax)) |
+                              ((box_ymin <= rect_y2_reg) & (rect_y2_reg < box_ymax)))
+        block_skip = Signal()
+        m.d.comb += block_skip.eq(~(box_overlap | box_ray))
+
+        # ===== Edge Traversal =====
+        cur_edge = Signal(self.addr_width)        # Edge being checked (vertex index of p1)
+        next_fetch = Signal(self.addr_width)      # Vertex read for the next slide
+        remaining = Signal(self.addr_width + 2)   # Edges left of the num_vertices + 1
+        edges_examined = Signal(self.addr_width + 2)
+        edges_skipped = Signal(self.addr_width + 2)
+
+        def wrap_inc(value):
+            return Mux(value + 1 < n, value + 1, 0)
+
+        def block_of(edge):
+            return edge >> log_b
+
+        def next_block(block):
+            return Mux((block + 1) << log_b < n, block + 1, 0)
+
+        cur_block_end = Signal(self.addr_width + 1)  # First edge after cur_edge's block
+        m.d.comb += cur_block_end.eq(
+            Mux((block_of(cur_edge) + 1) << log_b < n, (block_of(cur_edge) + 1) << log_b, n))
+        block_left = Signal(self.addr_width + 1)     # Edges from cur_edge to its block end
+        m.d.comb += block_left.eq(cur_block_end - cur_edge)
+
+        read_addr = Signal(self.addr_width)
+        m.d.comb += read_port.addr.eq(read_addr)
+
+        # ===== Edge Registers and Checks =====
+        edge_p1_x = Signal(cw)
+        edge_p1_y = Signal(cw)
+        edge_p2_x = Signal(cw)
+        edge_p2_y = Signal(cw)
+
+        crossings = [Signal(16, name=f'crossings_{i}') for i in range(4)]
+        on_boundary = [Signal(name=f'on_boundary_{i}') for i in range(4)]
+        check1_failed = Signal()
+        check2_failed = Signal()
+        cycle_counter = Signal(len(self.validation_cycles))  # Count cycles from start to done
+
+        check1 = VertexInRectangleCheck(coord_width=cw)
+        check2 = EdgeIntersectionCheck(coord_width=cw)
+        m.submodules.check1 = check1
+        m.submodules.check2 = check2
+        m.d.comb += [
+            check1.edge_p1_x.eq(edge_p1_x),
+            check1.edge_p1_y.eq(edge_p1_y),
+            check1.rect_x.eq(rect_x_reg),
+            check1.rect_y.eq(rect_y_reg),
+            check1.rect_x2.eq(rect_x2_reg),
+            check1.rect_y2.eq(rect_y2_reg),
+            check2.edge_p1_x.eq(edge_p1_x),
+            check2.edge_p1_y.eq(edge_p1_y),
+            check2.edge_p2_x.eq(edge_p2_x),
+            check2.edge_p2_y.eq(edge_p2_y),
+            check2.shrunk_x1.eq(shrunk_x1_reg),
+            check2.shrunk_x2.eq(shrunk_x2_reg),
+            check2.shrunk_y1.eq(shrunk_y1_reg),
+            check2.shrunk_y2.eq(shrunk_y2_reg),
+        ]
+
+        # CornerValidationCheck computes edge min/max from p1/p2, so its
+        # pre-registered min/max inputs are left undriven here
+        cv_crossing_inc = []
+        cv_boundary_set = []
+        for c in range(4):
+            cv = CornerValidationCheck(coord_width=cw)
+            m.submodules[f'cv_{c}'] = cv
+            m.d.comb += [
+                cv.edge_p1_x.eq(edge_p1_x),
+                cv.edge_p1_y.eq(edge_p1_y),
+                cv.edge_p2_x.eq(edge_p2_x),
+                cv.edge_p2_y.eq(edge_p2_y),
+                cv.corner_x.eq(corner_x_reg[c]),
+                cv.corner_y.eq(corner_y_reg[c]),
+                cv.on_boundary.eq(on_boundary[c]),
+            ]
+            cv_crossing_inc.append(cv.crossing_inc)
+            cv_boundary_set.append(cv.boundary_set)
+
+        all_corners_valid = Signal()
+        m.d.comb += all_corners_valid.eq(
+            (on_boundary[0] | crossings[0][0]) &
+            (on_boundary[1] | crossings[1][0]) &
+            (on_boundary[2] | crossings[2][0]) &
+            (on_boundary[3] | crossings[3][0])
+        )
+
+        m.d.comb += self.debug_edges_processed.eq(edges_examined)
+
+        # ===== FSM =====
+        with m.FSM(domain="sync"):
+            with m.State("IDLE"):
+                m.d.comb += self.busy.eq(0)
+
+                for c in range(4):
+                    m.d.sync += [crossings[c].eq(0), on_boundary[c].eq(0)]
+                m.d.sync += [
+                    check1_failed.eq(0),
+                    check2_failed.eq(0),
+                    self.done.eq(0),
+                    self.check1_fail.eq(0),
+                    self.check2_fail.eq(0),
+                    self.check3_fail.eq(0),
+                    self.is_valid.eq(0),
+                    cycle_counter.eq(0),
+                    self.fail_edge_index.eq(0),
+                ]
+
+                with m.If(self.start & ~self.load_mode):
+                    m.d.comb += index_addr.eq(block_of(self.start_vertex))
+                    m.d.sync += [
+                        cur_edge.eq(self.start_vertex),
+                        remaining.eq(n + 1),
+                        edges_examined.eq(0),
+                        edges_skipped.eq(0),
+                        cycle_counter.eq(1),
+                        rect_x_reg.eq(self.rect_x),
+                        rect_y_reg.eq(self.rect_y),
+                        rect_width_reg.eq(self.rect_width),
+                        rect_height_reg.eq(self.rect_height),
+                    ]
+                    m.next = "SETUP"
+
+            with m.State("SETUP"):
+                m.d.comb += self.busy.eq(1)
+                m.d.sync += [
+                    cycle_counter.eq(cycle_counter + 1),
+                    rect_x2_reg.eq(rect_x_reg + rect_width_reg),
+                    rect_y2_reg.eq(rect_y_reg + rect_height_reg),
+                    shrunk_x1_reg.eq(rect_x_reg + 1),
+                    shrunk_x2_reg.eq(rect_x_reg + rect_width_reg - 1),
+                    shrunk_y1_reg.eq(rect_y_reg + 1),
+                    shrunk_y2_reg.eq(rect_y_reg + rect_height_reg - 1),
+                    corner_x_reg[0].eq(rect_x_reg),
+                    corner_y_reg[0].eq(rect_y_reg),
+                    corner_x_reg[1].eq(rect_x_reg + rect_width_reg),
+                    corner_y_reg[1].eq(rect_y_reg),
+                    corner_x_reg[2].eq(rect_x_reg + rect_width_reg),
+                    corner_y_reg[2].eq(rect_y_reg + rect_height_reg),
+                    corner_x_reg[3].eq(rect_x_reg),
+                    corner_y_reg[3].eq(rect_y_reg + rect_height_reg),
+                ]
+                m.next = "BLOCK_CHECK"
+
+            # Index entry of cur_edge's block is valid here: skip to the next
+            # block (one cycle per block) or start fetching cur_edge
+            with m.State("BLOCK_CHECK"):
+                m.d.comb += self.busy.eq(1)
+                m.d.sync += cycle_counter.eq(cycle_counter + 1)
+
+                with m.If(block_skip):
+                    with m.If(remaining <= block_left):
+                        m.d.sync += [
+                            edges_skipped.eq(edges_skipped + remaining),
+                            remaining.eq(0),
+                        ]
+                        m.next = "FINALIZE"
+                    with m.Else():
+                        m.d.comb += index_addr.eq(next_block(block_of(cur_edge)))
+                        m.d.sync += [
+                            edges_skipped.eq(edges_skipped + block_left),
+                            remaining.eq(remaining - block_left),
+                            cur_edge.eq(Mux(cur_block_end < n, cur_block_end, 0)),
+                        ]
+                with m.Else():
+                    # Look up the following block while this one is scanned
+                    m.d.comb += [
+                        index_addr.eq(next_block(block_of(cur_edge))),
+                        read_addr.eq(cur_edge),
+                    ]
+                    m.d.sync += next_fetch.eq(wrap_inc(cur_edge))
+                    m.next = "FETCH_P1"
+
+            with m.State("FETCH_P1"):
+                m.d.comb += [
+                    self.busy.eq(1),
+                    read_addr.eq(next_fetch),
+                ]
+                m.d.sync += [
+                    edge_p1_x.eq(mem_data_x),
+                    edge_p1_y.eq(mem_data_y),
+                    next_fetch.eq(wrap_inc(next_fetch)),
+                    cycle_counter.eq(cycle_counter + 1),
+                ]
+                m.next = "FETCH_P2"
+
+            with m.State("FETCH_P2"):
+                m.d.comb += [
+                    self.busy.eq(1),
+                    read_addr.eq(next_fetch),
+                ]
+                m.d.sync += [
+                    edge_p2_x.eq(mem_data_x),
+                    edge_p2_y.eq(mem_data_y),
+                    next_fetch.eq(wrap_inc(next_fetch)),
+                    cycle_counter.eq(cycle_counter + 1),
+                ]
+                m.next = "SCAN"
+
+            with m.State("SCAN"):
+                m.d.comb += self.busy.eq(1)
+                m.d.sync += [
+                    cycle_counter.eq(cycle_counter + 1),
+                    edges_examined.eq(edges_examined + 1),
+                ]
+
+                next_edge = wrap_inc(cur_edge)
+                block_done = cur_edge + 1 == cur_block_end
+                next_needed = (index_block_q == block_of(next_edge)) & ~block_skip
+
+                with m.If(check1.violation | check2.violation):
+                    # Early termination at the failing edge
+                    m.d.sync += [
+                        check1_failed.eq(check1.violation),
+                        check2_failed.eq(check2.violation),
+                        self.fail_edge_index.eq(cur_edge),
+                    ]
+                    m.next = "FINALIZE"
+                with m.Else():
+                    for c in range(4):
+                        with m.If(cv_crossing_inc[c]):
+                            m.d.sync += crossings[c].eq(crossings[c] + 1)
+                        with m.If(cv_boundary_set[c]):
+                            m.d.sync += on_boundary[c].eq(1)
+
+                    m.d.sync += [
+                        remaining.eq(remaining - 1),
+                        cur_edge.eq(next_edge),
+                    ]
+
+                    with m.If(remaining == 1):
+                        m.next = "FINALIZE"
+                    with m.Elif(block_done & ~next_needed):
+                        # Next block may be skippable (or its entry is not read yet)
+                        m.d.comb += index_addr.eq(block_of(next_edge))
+                        m.next = "BLOCK_CHECK"
+                    with m.Else():
+                        # Slide the edge window, streaming into the next block if needed
+                        with m.If(block_done):
+                            m.d.comb += index_addr.eq(next_block(block_of(next_edge)))
+                        m.d.comb += read_addr.eq(next_fetch)
+                        m.d.sync += [
+                            edge_p1_x.eq(edge_p2_x),
+                            edge_p1_y.eq(edge_p2_y),
+                            edge_p2_x.eq(mem_data_x),
+                            edge_p2_y.eq(mem_data_y),
+                            next_fetch.eq(wrap_inc(next_fetch)),
+                        ]
+
+            with m.State("FINALIZE"):
+                m.d.comb += self.busy.eq(0)
+
+                with m.If(check1_failed | check2_failed):
+                    m.d.sync += [
+                        self.is_valid.eq(0),
+                        self.check1_fail.eq(check1_failed),
+                        self.check2_fail.eq(check2_failed),
+                        self.check3_fail.eq(0),
+                    ]
+                with m.Else():
+                    m.d.sync += [
+                        self.is_valid.eq(all_corners_valid),
+                        self.check1_fail.eq(0),
+                        self.check2_fail.eq(0),
+                        self.check3_fail.eq(~all_corners_valid),
+                    ]
+
+                m.d.sync += [
+                    self.done.eq(1),
+                    self.validation_cycles.eq(cycle_counter + 1),  # +1 for FINALIZE cycle
+                    self.edges_examined.eq(edges_examined),
+                    self.edges_skipped.eq(edges_skipped),
+                ]
+                m.next = "IDLE"
+
+        return m
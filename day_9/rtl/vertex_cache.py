@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""
+Vertex cache for MaxRectangleFinder's external-memory mode.
+
+Serves BRAM-like read ports (address this cycle, data next cycle) from a
+polygon held in external memory. Each port has its own direct-mapped cache
+of num_lines lines of line_vertices consecutive vertices, so the finder's
+pair reads and the validator's edge walk never evict each other's lines.
+
+A lookup that misses raises stall until its line has been fetched. The
+clients are clock-enabled by ~stall, so a miss freezes them instead of
+adding wait states to their FSMs; the read data registers hold while
+stalled, so data for the last completed read is still there afterwards.
+
+Misses are served one burst at a time, lowest port first: a request
+(mem_req_valid/mem_req_ready, mem_req_addr = first vertex of the line)
+returns line_vertices beats on mem_resp_valid/mem_resp_data, in order.
+mem_req_valid and mem_req_addr are registered, so a memory model may
+sample them before the clock edge without settling the design first.
+
+invalidate may arrive at any time. A burst already requested is still
+drained, so the memory side never sees a request withdrawn or beats
+ignored, but its line is dropped instead of being marked valid; the
+stalled client then misses again and fetches the line from the new polygon.
+"""
+
+from amaranth import *
+from amaranth.hdl.mem import Memory
+
+
+class VertexCache(Elaboratable):
+    """
+    Parameters
+    ----------
+    data_width : int
+        Bits per vertex word ({y, x}).
+    addr_width : int
+        Vertex index width.
+    num_ports : int
+        Client read ports (1-4).
+    num_lines : int
+        Lines per port, a power of two (2-256).
+    line_vertices : int
+        Vertices per line and per burst, a power of two (2-64).
+
+    Interface
+    ---------
+    Per port k:
+        addr[k], en[k] : Read address and request (inputs)
+        data[k] : Read data, valid the cycle after an unstalled request
+    Control:
+        stall : A requested line is not cached (output, combinational)
+        invalidate : Drop every line and any fill in flight (new polygon in memory)
+        clear : Zero the counters
+    Memory side:
+        mem_req_valid, mem_req_ready, mem_req_addr : Burst request
+        mem_resp_valid, mem_resp_data : Burst beats
+    Counters (since clear):
+        accesses : Completed read requests, over all ports
+        misses : Lines fetched
+        stall_cycles : Cycles with stall high
+    """
+
+    def __init__(self, data_width: int, addr_width: int, num_ports: int = 2,
+                 num_lines: int = 16, line_vertices: int = 8):
+        if num_ports < 1 or num_ports > 4:
+            raise ValueError(f"num_ports must be 1-4, got {num_ports}")
+        if num_lines < 2 or num_lines > 256 or num_lines & (num_lines - 1):
+            raise ValueError(f"num_lines must be a power of two 2-256, got {num_lines}")
+        if line_vertices < 2 or line_vertices > 64 or line_vertices & (line_vertices - 1):
+            raise ValueError(f"line_vertices must be a power of two 2-64, got {line_vertices}")
+        if num_lines * line_vertices > 1 << addr_width:
+            raise ValueError("cache is larger than the vertex address space")
+
+        self.data_width = data_width
+        self.addr_width = addr_width
+        self.num_ports = num_ports
+        self.num_lines = num_lines
+        self.line_vertices = line_vertices
+
+        self.addr = [Signal(addr_width, name=f"addr_{k}") for k in range(num_ports)]
+        self.en = [Signal(name=f"en_{k}") for k in range(num_ports)]
+        self.data = [Signal(data_width, name=f"data_{k}") for k in range(num_ports)]
+
+        self.stall = Signal()
+        self.invalidate = Signal()
+        self.clear = Signal()
+
+        self.mem_req_valid = Signal()
+        self.mem_req_ready = Signal()
+        self.mem_req_addr = Signal(addr_width)
+        self.mem_resp_valid = Signal()
+        self.mem_resp_data = Signal(data_width)
+
+        self.accesses = Signal(32)
+        self.misses = Signal(32)
+        self.stall_cycles = Signal(32)
+
+    def elaborate(self, platform):
+        m = Module()
+        P = self.num_ports
+        log_l = self.line_vertices.bit_length() - 1
+        log_n = self.num_lines.bit_length() - 1
+        line_width = self.addr_width - log_l
+
+        # ===== Tags: full line address and valid bit per line, per port =====
+        tags = [Array(Signal(line_width, name=f"tag_{k}_{i}") for i in range(self.num_lines))
+                for k in range(P)]
+        valid = [Signal(self.num_lines, name=f"line_valid_{k}") for k in range(P)]
+
+        def line_of(addr):
+            return addr[log_l:]
+
+        def index_of(line):
+            return line[:log_n]
+
+        # ===== Lookup =====
+        miss = Signal(P)
+        for k in range(P):
+            line = line_of(self.addr[k])
+            hit = valid[k].bit_select(index_of(line), 1) & (tags[k][index_of(line)] == line)
+            m.d.comb += miss[k].eq(self.en[k] & ~hit)
+        m.d.comb += self.stall.eq(miss.any())
+
+        # ===== Line Data (one BRAM per port) =====
+        write_ports = []
+        for k in range(P):
+            data_mem = Memory(width=self.data_width, depth=self.num_lines * self.line_vertices,
+                              init=[], name=f"line_mem_{k}")
+            rp = data_mem.read_port(domain="sync", transparent=False)
+            wp = data_mem.write_port(domain="sync")
+            m.submodules[f"line_read_{k}"] = rp
+            m.submodules[f"line_write_{k}"] = wp
+            m.d.comb += [
+                rp.addr.eq(self.addr[k][:log_l + log_n]),
+                rp.en.eq(~self.stall),
+                self.data[k].eq(rp.data),
+            ]
+            write_ports.append(wp)
+
+        # ===== Line Fill =====
+        fill_port = Signal(range(P))
+        fill_line = Signal(line_width)
+        beat = Signal(log_l)
+
+        # Lowest missing port and its line
+        miss_port = Signal(range(P))
+        for k in reversed(range(P)):
+            with m.If(miss[k]):
+                m.d.comb += miss_port.eq(k)
+        miss_line = Array(line_of(a) for a in self.addr)[miss_port]
+
+        request = Signal()
+        refill_done = Signal()
+        drop_fill = Signal()  # Invalidated mid-burst: drain the beats, keep nothing
+
+        with m.FSM(domain="sync"):
+            with m.State("IDLE"):
+                with m.If(self.stall & ~self.invalidate):
+                    m.d.sync += [
+                        fill_port.eq(miss_port),
+                        fill_line.eq(miss_line),
+                        self.mem_req_addr.eq(miss_line << log_l),
+                        drop_fill.eq(0),
+                    ]
+                    m.next = "REQUEST"
+
+            with m.State("REQUEST"):
+                with m.If(self.invalidate):
+                    m.d.sync += drop_fill.eq(1)
+                m.d.comb += [
+                    self.mem_req_valid.eq(1),
+                    request.eq(self.mem_req_ready),
+                ]
+                with m.If(self.mem_req_ready):
+                    m.d.sync += beat.eq(0)
+                    for k in range(P):
+                        with m.If(fill_port == k):
+                            m.d.sync += valid[k].bit_select(index_of(fill_line), 1).eq(0)
+                    m.next = "FILL"
+
+            with m.State("FILL"):
+                with m.If(self.invalidate):
+                    m.d.sync += drop_fill.eq(1)
+                with m.If(self.mem_resp_valid):
+                    for k, wp in enumerate(write_ports):
+                        m.d.comb += [
+                            wp.addr.eq(Cat(beat, index_of(fill_line))),
+                            wp.data.eq(self.mem_resp_data),
+                            wp.en.eq(fill_port == k),
+                        ]
+                    m.d.sync += beat.eq(beat + 1)
+                    with m.If(beat == self.line_vertices - 1):
+                        m.d.comb += refill_done.eq(1)
+                        m.next = "IDLE"
+
+        # Tag update after the last beat (the refilled line hits next cycle),
+        # unless an invalidate arrived during the fill
+        keep_fill = refill_done & ~drop_fill & ~self.invalidate
+        for k in range(P):
+            with m.If(keep_fill & (fill_port == k)):
+                m.d.sync += [
+                    tags[k][index_of(fill_line)].eq(fill_line),
+                    valid[k].bit_select(index_of(fill_line), 1).eq(1),
+                ]
+            with m.If(self.invalidate):
+                m.d.sync += valid[k].eq(0)
+
+        # ===== Counters =====
+        completed = sum((self.en[k] for k in range(P)), Const(0, range(P + 1)))
+        with m.If(self.clear):
+            m.d.sync += [
+                self.accesses.eq(0),
+                self.misses.eq(0),
+                self.stall_cycles.eq(0),
+            ]
+        with m.Else():
+            with m.If(self.stall):
+                m.d.sync += self.stall_cycles.eq(self.stall_cycles + 1)
+            with m.Else():
+                m.d.sync += self.accesses.eq(self.accesses + completed)
+            with m.If(request):
+                m.d.sync += self.misses.eq(self.misses + 1)
+
+        return m
@@ -13,11 +13,21 @@ import time
 from max_rectangle_finder import MaxRectangleFinder, parse_polygon_text
 
 
-def run_software(input_text):
-    """Run software reference implementation."""
+def run_software(input_text, native=False, threads=0):
+    """Run software reference implementation.
+
+    Args:
+        input_text: Polygon text
+        native: Use the C++ reference (native_reference.py) instead of Python
+        threads: OpenMP threads for the native reference (0 = default)
+    """
     vertices = parse_polygon_text(input_text)
 
-    finder = MaxRectangleFinder()
+    if native:
+        from native_reference import NativeMaxRectangleFinder
+        finder = NativeMaxRectangleFinder(threads=threads)
+    else:
+        finder = MaxRectangleFinder()
     for x, y in vertices:
         finder.add_vertex(x, y)
 
@@ -76,6 +86,12 @@ def main():
         description='Compare software reference against RTL implementation'
     )
     parser.add_argument('input_file', help='Input file with polygon vertices')
+    parser.add_argument('--native', action='store_true',
+                        help='Use the native C++ reference (build with make ref-lib)')
+    parser.add_argument('--threads', type=int, default=0,
+                        help='OpenMP threads for --native (default: OpenMP default)')
+    parser.add_argument('--verify-native', action='store_true',
+                        help='Also run the Python reference and check the native one matches it')
     args = parser.parse_args()
 
     # Read input
@@ -88,8 +104,8 @@ def main():
     print()
 
     # Run software reference
-    print("Running software reference...")
-    sw_stats = run_software(input_text)
+    print(f"Running software reference{' (native)' if args.native else ''}...")
+    sw_stats = run_software(input_text, args.native, args.threads)
 
     print(f"  Result: {sw_stats['result']}")
     print(f"  Time: {sw_stats['elapsed']:.3f}s")
@@ -99,6 +115,18 @@ def main():
     print(f"  Valid rectangles: {sw_stats['valid_rectangles']}")
     print()
 
+    if args.native and args.verify_native:
+        print("Running Python reference for verification...")
+        py_stats = run_software(input_text)
+        keys = ['result', 'rectangles_tested', 'rectangles_pruned', 'valid_rectangles']
+        diffs = [k for k in keys if py_stats[k] != sw_stats[k]]
+        if diffs:
+            for k in diffs:
+                print(f"✗ Native reference differs on {k}: {sw_stats[k]} (Python: {py_stats[k]})")
+            return 1
+        print(f"  ✓ Native reference matches ({py_stats['elapsed'] / max(sw_stats['elapsed'], 1e-9):.1f}x faster)")
+        print()
+
     # Run RTL if available
     print("Running RTL implementation...")
     # Use absolute path for RTL test
@@ -0,0 +1,244 @@
+/**
+ * Rectangle validation kernels of the native reference model.
+ *
+ * Branch-free versions of the ValidateRectangle checks (rtl/checks.py) with
+ * the semantics of _validate_rectangle() in max_rectangle_finder.py:
+ * CHECK 1 vertex strictly inside, CHECK 2 edge crossing the rectangle shrunk
+ * by 4, CHECK 3 + 4 corner on the boundary or odd ray-casting count.
+ *
+ * validate_rectangle_rtl() instead follows the hardware validator
+ * (rtl/validate_rectangle.py, rtl/checks.py) verdict for verdict, for the
+ * rtl_max_rect wrapper's lockstep scoreboard. The native reference
+ * (max_rectangle_finder.cpp) uses the software model semantics.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace max_rect_ref {
+
+constexpr int64_t SHRINK = 4;           // CHECK 2 shrunken rectangle margin
+constexpr size_t EDGE_CHUNK = 64;       // Edges tested between early exits
+
+// Polygon edges as structure-of-arrays; edge e runs from vertex e to e+1
+struct Edges {
+    size_t n = 0;
+    std::vector<int64_t> x1, y1;          // Start vertex (CHECK 1, ray casting)
+    std::vector<int64_t> lo_x, hi_x;      // Sorted endpoints
+    std::vector<int64_t> lo_y, hi_y;
+    std::vector<int64_t> horiz, vert;     // 1 if y1 == y2 / x1 == x2
+
+    Edges() = default;
+    Edges(const std::vector<int64_t>& vx, const std::vector<int64_t>& vy) { assign(vx, vy); }
+
+    void assign(const std::vector<int64_t>& vx, const std::vector<int64_t>& vy) {
+        n = vx.size();
+        x1 = vx;
+        y1 = vy;
+        lo_x.resize(n); hi_x.resize(n);
+        lo_y.resize(n); hi_y.resize(n);
+        horiz.resize(n); vert.resize(n);
+        for (size_t e = 0; e < n; e++) {
+            size_t f = (e + 1) % n;
+            lo_x[e] = vx[e] < vx[f] ? vx[e] : vx[f];
+            hi_x[e] = vx[e] < vx[f] ? vx[f] : vx[e];
+            lo_y[e] = vy[e] < vy[f] ? vy[e] : vy[f];
+            hi_y[e] = vy[e] < vy[f] ? vy[f] : vy[e];
+            horiz[e] = vy[e] == vy[f];
+            vert[e] = vx[e] == vx[f];
+        }
+    }
+};
+
+struct Candidate {
+    int64_t x, y, w, h;
+    int64_t area;
+};
+
+// Area-descending search bucket (MaxRectangleFinder area_order): the bit
+// length of the area, so bucket b holds areas in [2**(b-1), 2**b)
+inline int area_bucket(int64_t area) {
+    return area > 0 ? 64 - __builtin_clzll(static_cast<uint64_t>(area)) : 0;
+}
+
+// CHECK 1 (vertex strictly inside) and CHECK 2 (edge crosses the shrunken
+// rectangle) over all edges. Returns true if any edge violates.
+inline bool any_edge_violation(const Edges& E, int64_t rx, int64_t ry, int64_t rx2, int64_t ry2) {
+    const int64_t sx1 = rx + SHRINK, sx2 = rx2 - SHRINK;
+    const int64_t sy1 = ry + SHRINK, sy2 = ry2 - SHRINK;
+    const int64_t* x1 = E.x1.data();
+    const int64_t* y1 = E.y1.data();
+    const int64_t* lx = E.lo_x.data();
+    const int64_t* hx = E.hi_x.data();
+    const int64_t* ly = E.lo_y.data();
+    const int64_t* hy = E.hi_y.data();
+    const int64_t* hz = E.horiz.data();
+    const int64_t* vt = E.vert.data();
+
+    for (size_t base = 0; base < E.n; base += EDGE_CHUNK) {
+        size_t end = base + EDGE_CHUNK < E.n ? base + EDGE_CHUNK : E.n;
+        int64_t bad = 0;
+#pragma omp simd reduction(| : bad)
+        for (size_t e = base; e < end; e++) {
+            int64_t inside = (rx < x1[e]) & (x1[e] < rx2) & (ry < y1[e]) & (y1[e] < ry2);
+            int64_t h_cross = hz[e] & (sy1 < ly[e]) & (ly[e] < sy2) &
+                              !((hx[e] <= sx1) | (lx[e] >= sx2));
+            int64_t v_cross = vt[e] & (sx1 < lx[e]) & (lx[e] < sx2) &
+                              !((hy[e] <= sy1) | (ly[e] >= sy2));
+            bad |= inside | h_cross | v_cross;
+        }
+        if (bad) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// CHECK 3 + 4: the corner is on the polygon boundary or has an odd
+// ray-casting crossing count (ray to +x, non-horizontal edges with
+// x1 <= px and py in [ymin, ymax)).
+inline bool corner_valid(const Edges& E, int64_t px, int64_t py) {
+    const int64_t* x1 = E.x1.data();
+    const int64_t* lx = E.lo_x.data();
+    const int64_t* hx = E.hi_x.data();
+    const int64_t* ly = E.lo_y.data();
+    const int64_t* hy = E.hi_y.data();
+    const int64_t* hz = E.horiz.data();
+    const int64_t* vt = E.vert.data();
+
+    int64_t on_boundary = 0;
+    int64_t crossings = 0;
+#pragma omp simd reduction(| : on_boundary) reduction(+ : crossings)
+    for (size_t e = 0; e < E.n; e++) {
+        on_boundary |= (hz[e] & (py == ly[e]) & (lx[e] <= px) & (px <= hx[e])) |
+                       (vt[e] & (px == lx[e]) & (ly[e] <= py) & (py <= hy[e]));
+        crossings += (1 - hz[e]) & (x1[e] <= px) & (ly[e] <= py) & (py < hy[e]);
+    }
+    return on_boundary || (crossings & 1);
+}
+
+inline bool validate_rectangle(const Edges& E, const Candidate& c) {
+    int64_t rx2 = c.x + c.w;
+    int64_t ry2 = c.y + c.h;
+    if (any_edge_violation(E, c.x, c.y, rx2, ry2)) {
+        return false;
+    }
+    return corner_valid(E, c.x, c.y) && corner_valid(E, rx2, c.y) &&
+           corner_valid(E, c.x, ry2) && corner_valid(E, rx2, ry2);
+}
+
+//==============================================================================
+// ValidateRectangle (RTL) semantics
+//==============================================================================
+//
+// The hardware validator differs from the software model in three ways:
+// CHECK 2 uses the rectangle shrunk by 1 and only tests crossings of its
+// shrunk bottom (vertical edges) and left (horizontal edges) sides; the walk
+// starts at the finder's start-vertex hint and stops at the first edge that
+// fails CHECK 1 or 2; and a full walk covers n + 1 edges, so the start edge
+// is counted twice by the ray casting.
+
+// ValidateRectangle verdicts, as MaxRectangleFinder.verdict_outcome
+constexpr int VERDICT_VALID = 0;
+constexpr int VERDICT_CHECK1 = 1;
+constexpr int VERDICT_CHECK2 = 2;
+constexpr int VERDICT_CORNER = 3;
+
+struct RtlVerdict {
+    int outcome;
+    size_t fail_edge;  // Edge CHECK 1/2 exited at (fail_edge_index), else 0
+};
+
+// First edge in [lo, hi) failing RTL CHECK 1 or 2, or hi. *check1 is set if
+// that edge fails CHECK 1, which takes priority in verdict_outcome.
+inline size_t first_rtl_violation(const Edges& E, int64_t rx, int64_t ry, int64_t rx2, int64_t ry2,
+                                  size_t lo, size_t hi, bool* check1) {
+    const int64_t sx1 = rx + 1, sx2 = rx2 - 1;
+    const int64_t sy1 = ry + 1, sy2 = ry2 - 1;
+    const int64_t* x1 = E.x1.data();
+    const int64_t* y1 = E.y1.data();
+    const int64_t* lx = E.lo_x.data();
+    const int64_t* hx = E.hi_x.data();
+    const int64_t* ly = E.lo_y.data();
+    const int64_t* hy = E.hi_y.data();
+    const int64_t* hz = E.horiz.data();
+    const int64_t* vt = E.vert.data();
+
+    auto inside = [&](size_t e) -> int64_t {
+        return (rx < x1[e]) & (x1[e] < rx2) & (ry < y1[e]) & (y1[e] < ry2);
+    };
+    auto crosses = [&](size_t e) -> int64_t {
+        int64_t v_cross = vt[e] & (ly[e] < sy1) & (sy1 < hy[e]) & (sx1 < x1[e]) & (x1[e] < sx2);
+        int64_t h_cross = hz[e] & (lx[e] < sx1) & (sx1 < hx[e]) & (sy1 < y1[e]) & (y1[e] < sy2);
+        return v_cross | h_cross;
+    };
+
+    for (size_t base = lo; base < hi; base += EDGE_CHUNK) {
+        size_t end = base + EDGE_CHUNK < hi ? base + EDGE_CHUNK : hi;
+        int64_t bad = 0;
+#pragma omp simd reduction(| : bad)
+        for (size_t e = base; e < end; e++) {
+            bad |= inside(e) | crosses(e);
+        }
+        if (!bad) {
+            continue;
+        }
+        for (size_t e = base; e < end; e++) {
+            if (inside(e) | crosses(e)) {
+                *check1 = inside(e);
+                return e;
+            }
+        }
+    }
+    return hi;
+}
+
+// CHECK 3 + 4 over all n edges plus the repeated start edge
+inline bool corner_valid_rtl(const Edges& E, int64_t px, int64_t py, size_t start) {
+    const int64_t* x1 = E.x1.data();
+    const int64_t* lx = E.lo_x.data();
+    const int64_t* hx = E.hi_x.data();
+    const int64_t* ly = E.lo_y.data();
+    const int64_t* hy = E.hi_y.data();
+    const int64_t* hz = E.horiz.data();
+    const int64_t* vt = E.vert.data();
+
+    int64_t on_boundary = 0;
+    int64_t crossings = 0;
+#pragma omp simd reduction(| : on_boundary) reduction(+ : crossings)
+    for (size_t e = 0; e < E.n; e++) {
+        on_boundary |= (hz[e] & (py == ly[e]) & (lx[e] <= px) & (px <= hx[e])) |
+                       (vt[e] & (px == lx[e]) & (ly[e] <= py) & (py <= hy[e]));
+        crossings += (1 - hz[e]) & (x1[e] <= px) & (ly[e] <= py) & (py < hy[e]);
+    }
+    size_t s = start;
+    crossings += (1 - hz[s]) & (x1[s] <= px) & (ly[s] <= py) & (py < hy[s]);
+    return on_boundary || (crossings & 1);
+}
+
+// Verdict of ValidateRectangle for candidate c, walking from edge start
+inline RtlVerdict validate_rectangle_rtl(const Edges& E, const Candidate& c, size_t start) {
+    if (E.n == 0) {
+        return {VERDICT_CORNER, 0};
+    }
+    start = start < E.n ? start : 0;
+    int64_t rx2 = c.x + c.w;
+    int64_t ry2 = c.y + c.h;
+    bool check1 = false;
+    size_t e = first_rtl_violation(E, c.x, c.y, rx2, ry2, start, E.n, &check1);
+    if (e == E.n) {
+        e = first_rtl_violation(E, c.x, c.y, rx2, ry2, 0, start, &check1);
+        e = e == start ? E.n : e;
+    }
+    if (e != E.n) {
+        return {check1 ? VERDICT_CHECK1 : VERDICT_CHECK2, e};
+    }
+    bool valid = corner_valid_rtl(E, c.x, c.y, start) && corner_valid_rtl(E, rx2, c.y, start) &&
+                 corner_valid_rtl(E, c.x, ry2, start) && corner_valid_rtl(E, rx2, ry2, start);
+    return {valid ? VERDICT_VALID : VERDICT_CORNER, 0};
+}
+
+}  // namespace max_rect_ref
@@ -0,0 +1,182 @@
+/**
+ * Native reference implementation of the MaxRectangleFinder algorithm.
+ *
+ * Same algorithm, scaling and pruning order as max_rectangle_finder.py, so
+ * the result and the get_statistics() counters are identical; it only runs
+ * faster. Loaded through ctypes by native_reference.py.
+ *
+ * Speedups over the Python reference:
+ * - Polygon edges are stored as structure-of-arrays with pre-sorted
+ *   endpoints, and the vertex-in-rectangle, edge-intersection and corner
+ *   (ray casting + boundary) checks are branch-free loops over those arrays
+ *   that the compiler vectorizes (omp simd); see max_rect_ref.h.
+ * - Candidate pairs are processed in blocks. Candidates that cannot beat the
+ *   max area at the start of a block are pruned without validation; the rest
+ *   are validated in parallel (OpenMP), then the block is replayed in pair
+ *   order so the running max, and therefore the pruned/tested counts, match
+ *   the sequential algorithm exactly.
+ * - With area_order, candidates are replayed bucket by bucket (log2 area,
+ *   highest first) exactly as in the Python reference's area_order mode.
+ *
+ * Build: make ref-lib (in verilator_benchs/)
+ */
+
+#include "max_rect_ref.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+using max_rect_ref::Candidate;
+using max_rect_ref::Edges;
+using max_rect_ref::validate_rectangle;
+
+constexpr int64_t SCALE_FACTOR = 4;     // Matches RTL SCALE_SHIFT=2
+constexpr size_t BLOCK_CANDIDATES = 4096;
+
+struct Search {
+    const Edges& edges;
+    int64_t max_area = 0;
+    uint64_t tested = 0;
+    uint64_t pruned = 0;
+    uint64_t valid_found = 0;
+
+    std::vector<Candidate> block;
+    std::vector<uint32_t> pending;  // Block indices needing validation
+    std::vector<uint8_t> valid;
+
+    explicit Search(const Edges& e) : edges(e) { block.reserve(BLOCK_CANDIDATES); }
+
+    void push(const Candidate& c) {
+        block.push_back(c);
+        if (block.size() == BLOCK_CANDIDATES) {
+            flush();
+        }
+    }
+
+    void flush() {
+        // Speculatively validate everything that beats the max at block start
+        pending.clear();
+        for (size_t k = 0; k < block.size(); k++) {
+            if (block[k].area > max_area) {
+                pending.push_back(static_cast<uint32_t>(k));
+            }
+        }
+        valid.assign(block.size(), 0);
+        const long num_pending = static_cast<long>(pending.size());
+#pragma omp parallel for schedule(dynamic, 16) if (num_pending > 64)
+        for (long p = 0; p < num_pending; p++) {
+            uint32_t k = pending[p];
+            valid[k] = validate_rectangle(edges, block[k]);
+        }
+
+        // Replay in pair order (mirrors find_max_rectangle())
+        for (size_t k = 0; k < block.size(); k++) {
+            const Candidate& c = block[k];
+            if (c.area <= max_area) {
+                pruned++;
+                continue;
+            }
+            if (valid[k]) {
+                max_area = c.area;
+                valid_found++;
+            }
+            tested++;
+        }
+        block.clear();
+    }
+};
+
+}  // namespace
+
+extern "C" {
+
+// Find the maximum rectangle in the polygon given as count interleaved
+// unscaled (x, y) pairs. threads sets the OpenMP thread count (0 = default).
+// area_order visits candidates in descending log2 area buckets (RTL
+// MaxRectangleFinder area_order). If stats is non-null it receives
+// {rectangles_tested, rectangles_pruned, valid_rectangles}. Returns the max
+// area in RTL output scaling (area >> 4).
+uint64_t max_rect_ref_find(const int64_t* xy, uint32_t count, uint32_t threads, uint32_t area_order,
+                           uint64_t* stats) {
+    if (stats) {
+        stats[0] = stats[1] = stats[2] = 0;
+    }
+    if (count < 3) {
+        return 0;
+    }
+#ifdef _OPENMP
+    if (threads) {
+        omp_set_num_threads(static_cast<int>(threads));
+    }
+#else
+    (void)threads;
+#endif
+
+    std::vector<int64_t> vx(count), vy(count);
+    for (uint32_t i = 0; i < count; i++) {
+        vx[i] = xy[2 * i] * SCALE_FACTOR;
+        vy[i] = xy[2 * i + 1] * SCALE_FACTOR;
+    }
+    Edges edges(vx, vy);
+    Search search(edges);
+    std::vector<Candidate> all;  // area_order: every candidate, in pair order
+
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = i + 1; j < count; j++) {
+            int64_t min_x = vx[i] < vx[j] ? vx[i] : vx[j];
+            int64_t max_x = vx[i] < vx[j] ? vx[j] : vx[i];
+            int64_t min_y = vy[i] < vy[j] ? vy[i] : vy[j];
+            int64_t max_y = vy[i] < vy[j] ? vy[j] : vy[i];
+            int64_t width = max_x - min_x;
+            int64_t height = max_y - min_y;
+
+            // Skip degenerate rectangles (zero width or height)
+            if (width == 0 || height == 0) {
+                continue;
+            }
+            Candidate c = {min_x, min_y, width, height, (width + 4) * (height + 4)};
+            if (area_order) {
+                all.push_back(c);
+            } else {
+                search.push(c);
+            }
+        }
+    }
+    if (area_order) {
+        uint64_t buckets = 0;
+        for (const Candidate& c : all) {
+            buckets |= 1ull << max_rect_ref::area_bucket(c.area);
+        }
+        while (buckets) {
+            int bucket = 63 - __builtin_clzll(buckets);
+            buckets &= ~(1ull << bucket);
+            // Areas in the bucket are below 2**bucket
+            if ((1ll << bucket) - 1 <= search.max_area) {
+                break;
+            }
+            for (const Candidate& c : all) {
+                if (max_rect_ref::area_bucket(c.area) == bucket) {
+                    search.push(c);
+                }
+            }
+            search.flush();
+        }
+        search.pruned = all.size() - search.tested;
+    }
+    search.flush();
+
+    if (stats) {
+        stats[0] = search.tested;
+        stats[1] = search.pruned;
+        stats[2] = search.valid_found;
+    }
+    return static_cast<uint64_t>(search.max_area >> 4);
+}
+
+}  // extern "C"
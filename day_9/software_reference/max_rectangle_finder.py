@@ -15,6 +15,12 @@ Algorithm:
    b. Validate using 4 checks (vertex inside, edge intersection, ray casting, boundary)
    c. Track maximum valid rectangle area
 5. Return area (with formula: (width+4)*(height+4)/16 to match RTL)
+
+With area_order=True the candidates are visited like the RTL's area_order
+mode: grouped into log2 area buckets (bit length of the area), highest
+bucket first, pair order within a bucket, stopping once no remaining bucket
+can beat the max. rectangles_pruned then counts every candidate that was
+not validated.
 """
 
 import sys
@@ -27,7 +33,8 @@ class MaxRectangleFinder:
     # Coordinate scaling factor (matches RTL SCALE_SHIFT=2)
     SCALE_FACTOR = 4
 
-    def __init__(self):
+    def __init__(self, area_order: bool = False):
+        self.area_order = area_order
         self.vertices = []
         self.max_area = 0
         self.rectangles_tested = 0
@@ -55,6 +62,26 @@ class MaxRectangleFinder:
         self.rectangles_pruned = 0
         self.valid_rectangles_found = 0
 
+        if self.area_order:
+            candidates = list(self._candidates())
+            buckets = sorted({area.bit_length() for *_, area in candidates}, reverse=True)
+            for bucket in buckets:
+                # Areas in the bucket are below 2**bucket
+                if (1 << bucket) - 1 <= self.max_area:
+                    break
+                for candidate in candidates:
+                    if candidate[4].bit_length() == bucket:
+                        self._test_candidate(*candidate)
+            self.rectangles_pruned = len(candidates) - self.rectangles_tested
+        else:
+            for candidate in self._candidates():
+                self._test_candidate(*candidate)
+
+        # Return area divided by 16 (to match RTL output scaling)
+        return self.max_area >> 4
+
+    def _candidates(self):
+        """Yield (min_x, min_y, width, height, area) for each non-degenerate vertex pair."""
         num_vertices = len(self.vertices)
 
         # Generate all vertex pair combinations (i, j) where i < j
@@ -78,23 +105,23 @@ class MaxRectangleFinder:
                     continue
 
                 # Compute area with RTL formula: (width+4)*(height+4)
-                candidate_area = (width + 4) * (height + 4)
+                yield min_x, min_y, width, height, (width + 4) * (height + 4)
 
-                # Area pruning: skip if can't beat current max
-                if candidate_area <= self.max_area:
-                    self.rectangles_pruned += 1
-                    continue
-
-                # Validate rectangle
-                if self._validate_rectangle(min_x, min_y, width, height):
-                    if candidate_area > self.max_area:
-                        self.max_area = candidate_area
-                    self.valid_rectangles_found += 1
+    def _test_candidate(self, min_x: int, min_y: int, width: int, height: int,
+                        candidate_area: int):
+        """Prune or validate one candidate and update the max area."""
+        # Area pruning: skip if can't beat current max
+        if candidate_area <= self.max_area:
+            self.rectangles_pruned += 1
+            return
 
-                self.rectangles_tested += 1
+        # Validate rectangle
+        if self._validate_rectangle(min_x, min_y, width, height):
+            if candidate_area > self.max_area:
+                self.max_area = candidate_area
+            self.valid_rectangles_found += 1
 
-        # Return area divided by 16 (to match RTL output scaling)
-        return self.max_area >> 4
+        self.rectangles_tested += 1
 
     def _validate_rectangle(self, rect_x: int, rect_y: int,
                            rect_width: int, rect_height: int) -> bool:
@@ -304,6 +331,8 @@ def main():
     parser.add_argument('input_file', nargs='?', type=argparse.FileType('r'),
                        default=sys.stdin,
                        help='Input file with polygon vertices (default: stdin)')
+    parser.add_argument('--area-order', action='store_true',
+                       help='Visit candidates in descending area buckets (RTL area_order)')
     parser.add_argument('--verbose', '-v', action='store_true',
                        help='Print algorithm statistics')
     args = parser.parse_args()
@@ -320,7 +349,7 @@ def main():
         print(f"Processing polygon with {len(vertices)} vertices", file=sys.stderr)
 
     # Find maximum rectangle
-    finder = MaxRectangleFinder()
+    finder = MaxRectangleFinder(area_order=args.area_order)
     for x, y in vertices:
         finder.add_vertex(x, y)
 
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+ctypes binding for the native reference (max_rectangle_finder.cpp).
+
+NativeMaxRectangleFinder has the same interface as MaxRectangleFinder in
+max_rectangle_finder.py and returns identical results and statistics.
+Build the library with `make ref-lib` in verilator_benchs/.
+"""
+
+import ctypes
+import os
+import sys
+
+from max_rectangle_finder import parse_polygon_text
+
+
+DEFAULT_LIB = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           '..', 'verilator_benchs', 'lib', 'libmax_rect_ref.so')
+
+
+class NativeMaxRectangleFinder:
+    """Native drop-in for the software reference MaxRectangleFinder."""
+
+    def __init__(self, lib_path=None, threads=0, area_order=False):
+        """Load the native reference library.
+
+        Args:
+            lib_path: Path to libmax_rect_ref.so. If None, uses verilator_benchs/lib.
+            threads: OpenMP threads for candidate validation (0 = default)
+            area_order: Visit candidates in descending area buckets
+        """
+        lib_path = lib_path or DEFAULT_LIB
+        if not os.path.exists(lib_path):
+            raise FileNotFoundError(f"Native reference not found: {lib_path} (run 'make ref-lib')")
+
+        self.lib = ctypes.CDLL(lib_path)
+        self.lib.max_rect_ref_find.argtypes = [ctypes.POINTER(ctypes.c_int64), ctypes.c_uint32,
+                                               ctypes.c_uint32, ctypes.c_uint32,
+                                               ctypes.POINTER(ctypes.c_uint64)]
+        self.lib.max_rect_ref_find.restype = ctypes.c_uint64
+
+        self.threads = threads
+        self.area_order = area_order
+        self.vertices = []
+        self.result = 0
+        self.rectangles_tested = 0
+        self.rectangles_pruned = 0
+        self.valid_rectangles_found = 0
+
+    def add_vertex(self, x: int, y: int):
+        """Add a vertex to the polygon (unscaled, as in the Python reference)."""
+        self.vertices.append((x, y))
+
+    def find_max_rectangle(self) -> int:
+        """Find the maximum rectangle area (RTL output scaling)."""
+        n = len(self.vertices)
+        xy = (ctypes.c_int64 * (2 * n))(*(c for v in self.vertices for c in v))
+        stats = (ctypes.c_uint64 * 3)()
+
+        self.result = self.lib.max_rect_ref_find(xy, n, self.threads, int(self.area_order), stats)
+        self.rectangles_tested, self.rectangles_pruned, self.valid_rectangles_found = stats
+        return self.result
+
+    def get_statistics(self) -> dict:
+        """Return algorithm statistics (same keys as the Python reference)."""
+        return {
+            'vertices': len(self.vertices),
+            'rectangles_tested': self.rectangles_tested,
+            'rectangles_pruned': self.rectangles_pruned,
+            'valid_rectangles': self.valid_rectangles_found,
+            'max_area': self.result,
+        }
+
+
+def main():
+    """Command-line interface, same as max_rectangle_finder.py."""
+    import argparse
+
+    parser = argparse.ArgumentParser(
+        description='Find maximum rectangle within rectilinear polygon (native reference)'
+    )
+    parser.add_argument('input_file', nargs='?', type=argparse.FileType('r'),
+                        default=sys.stdin,
+                        help='Input file with polygon vertices (default: stdin)')
+    parser.add_argument('--threads', type=int, default=0,
+                        help='OpenMP threads (default: OpenMP default)')
+    parser.add_argument('--lib', default=None, help='Path to libmax_rect_ref.so')
+    parser.add_argument('--area-order', action='store_true',
+                        help='Visit candidates in descending area buckets (RTL area_order)')
+    parser.add_argument('--verbose', '-v', action='store_true',
+                        help='Print algorithm statistics')
+    args = parser.parse_args()
+
+    vertices = parse_polygon_text(args.input_file.read())
+    if len(vertices) < 3:
+        print("Error: Need at least 3 vertices", file=sys.stderr)
+        return 1
+
+    finder = NativeMaxRectangleFinder(args.lib, args.threads, args.area_order)
+    for x, y in vertices:
+        finder.add_vertex(x, y)
+
+    print(finder.find_max_rectangle())
+
+    if args.verbose:
+        stats = finder.get_statistics()
+        print(f"\nStatistics:", file=sys.stderr)
+        print(f"  Vertices: {stats['vertices']}", file=sys.stderr)
+        print(f"  Rectangles tested: {stats['rectangles_tested']}", file=sys.stderr)
+        print(f"  Rectangles pruned: {stats['rectangles_pruned']}", file=sys.stderr)
+        print(f"  Valid rectangles: {stats['valid_rectangles']}", file=sys.stderr)
+        print(f"  Max area: {stats['max_area']}", file=sys.stderr)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Parallel multi-testcase regression runner for rtl_max_rect.
+
+Runs every polygon file in a directory on a pool of worker threads. Each
+worker keeps one MaxRectangleFinder instance (own VerilatedContext and
+model) and runs its cases through it in chunks of --chunk polygons, one
+native run_jobs() call per chunk with an in-place reset between polygons.
+ctypes releases the GIL while native wrapper calls run, so the simulations
+proceed in parallel across cores. --fresh builds a new instance per case
+instead.
+
+Usage:
+    python3 batch_max_rect.py testcase_dir [--jobs N] [--pattern '*.txt'] [--chunk N]
+"""
+
+import glob
+import os
+import sys
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+from rtl_max_rect import MaxRectangleFinder, load_polygon_from_file
+
+
+def run_case(filepath, lib_path=None, max_cycles=10_000_000_000):
+    """Run one polygon file through its own simulation instance.
+
+    Args:
+        filepath: Polygon file (x,y per line)
+        lib_path: Shared library path (default: MaxRectangleFinder default)
+        max_cycles: Maximum search cycles
+
+    Returns:
+        Dict with per-case results and statistics
+    """
+    start_time = time.time()
+    vertices = load_polygon_from_file(filepath)
+
+    finder = MaxRectangleFinder(lib_path)
+    finder.load_polygon(vertices)
+    finder.start_search()
+    cycles = finder.wait_done(max_cycles)
+
+    return {
+        'file': filepath,
+        'vertices': len(vertices),
+        'done': finder.done,
+        'max_area': finder.max_area,
+        'cycles': cycles,
+        'rectangles_tested': finder.rectangles_tested,
+        'rectangles_pruned': finder.rectangles_pruned,
+        'elapsed': time.time() - start_time,
+    }
+
+
+_worker = threading.local()
+
+
+def run_chunk(filepaths, lib_path=None, max_cycles=10_000_000_000):
+    """Run several polygon files back to back on this worker's instance.
+
+    Args:
+        filepaths: Polygon files (x,y per line)
+        lib_path: Shared library path (default: MaxRectangleFinder default)
+        max_cycles: Maximum search cycles per case
+
+    Returns:
+        List of per-case result dicts (elapsed is None: one native call
+        covers the whole chunk)
+    """
+    finder = getattr(_worker, 'finder', None)
+    if finder is None:
+        finder = _worker.finder = MaxRectangleFinder(lib_path)
+    polygons = [load_polygon_from_file(f) for f in filepaths]
+    results = finder.run_jobs(polygons, max_cycles)
+    return [{
+        'file': filepath,
+        'vertices': len(vertices),
+        'done': r['done'],
+        'max_area': r['max_area'],
+        'cycles': r['search_cycles'],
+        'rectangles_tested': r['rectangles_tested'],
+        'rectangles_pruned': r['rectangles_pruned'],
+        'elapsed': None,
+    } for filepath, vertices, r in zip(filepaths, polygons, results)]
+
+
+def print_table(results, out=sys.stdout):
+    """Print per-case results as a fixed-width table."""
+    header = (f"{'case':<32} {'verts':>6} {'max_area':>16} {'cycles':>14} "
+              f"{'tested':>10} {'pruned':>10} {'wall_s':>9}")
+    print(header, file=out)
+    print('-' * len(header), file=out)
+    for r in results:
+        name = os.path.basename(r['file'])
+        status = '' if r['done'] else '  TIMEOUT'
+        elapsed = '-' if r['elapsed'] is None else f"{r['elapsed']:.3f}"
+        print(f"{name:<32} {r['vertices']:>6} {r['max_area']:>16} {r['cycles']:>14} "
+              f"{r['rectangles_tested']:>10} {r['rectangles_pruned']:>10} "
+              f"{elapsed:>9}{status}", file=out)
+
+
+def main():
+    """Run all testcases found in the given directory."""
+    import argparse
+
+    parser = argparse.ArgumentParser(description='Parallel rtl_max_rect regression runner')
+    parser.add_argument('testcase_dir', help='Directory with polygon files')
+    parser.add_argument('--pattern', default='*.txt',
+                        help='Glob pattern for polygon files (default: *.txt)')
+    parser.add_argument('--jobs', '-j', type=int, default=os.cpu_count(),
+                        help='Worker threads (default: number of CPUs)')
+    parser.add_argument('--max-cycles', type=int, default=10_000_000_000,
+                        help='Maximum search cycles per case (default: 10B)')
+    parser.add_argument('--lib', default=None, help='Shared library path')
+    parser.add_argument('--chunk', type=int, default=64,
+                        help='Cases per native run_jobs() call (default: 64)')
+    parser.add_argument('--fresh', action='store_true',
+                        help='Build a new instance per case instead of resetting one per worker')
+    args = parser.parse_args()
+
+    files = sorted(glob.glob(os.path.join(args.testcase_dir, args.pattern)))
+    if not files:
+        print(f"No files matching {args.pattern} in {args.testcase_dir}", file=sys.stderr)
+        return 1
+
+    print(f"Running {len(files)} cases on {args.jobs} workers", file=sys.stderr)
+
+    start_time = time.time()
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        if args.fresh:
+            futures = [pool.submit(run_case, f, args.lib, args.max_cycles) for f in files]
+            results = [f.result() for f in futures]
+        else:
+            chunk = max(1, args.chunk)
+            futures = [pool.submit(run_chunk, files[i:i + chunk], args.lib, args.max_cycles)
+                       for i in range(0, len(files), chunk)]
+            results = [r for f in futures for r in f.result()]
+    elapsed = time.time() - start_time
+
+    print_table(results)
+
+    total_cycles = sum(r['cycles'] for r in results)
+    failed = [r for r in results if not r['done']]
+    print(f"\nCases: {len(results)}, timeouts: {len(failed)}", file=sys.stderr)
+    print(f"Wall time: {elapsed:.3f}s", file=sys.stderr)
+    if elapsed > 0:
+        print(f"Aggregate rate: {total_cycles / elapsed / 1e6:.2f}M cycles/sec", file=sys.stderr)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""
+Validator parallelism benchmark for rtl_max_rect.
+
+Runs the same polygon through each validator-lane build
+(librtl_max_rect_l<K>_notrace.so) or, with --edges, each multi-edge build
+(librtl_max_rect_e<E>_notrace.so), with --index-blocks each edge-index
+build (librtl_max_rect_x<B>_notrace.so, 0 = no index), with --area-order
+the pair-order and area-order searches (librtl_max_rect_notrace.so and
+librtl_max_rect_ao_notrace.so), or with --cache-lines each external-memory
+build (librtl_max_rect_c<N>_notrace.so). For each it reports search cycles,
+speedup over the first variant, validation cycles per tested candidate, the
+share of edges the edge index skipped, how busy the lanes were (busy cycles / search cycles, averaged over lanes),
+and for external-memory builds the cache hit rate and the cycles stalled on misses.
+Search cycles are what the extra hardware saves on the FPGA; wall time is
+reported too, but each variant also costs more logic per simulated cycle.
+Every variant runs in its own subprocess so the separately built Verilator
+runtimes never share an address space.
+
+Usage:
+    python3 bench_lanes.py [input.txt] --lanes 1 2 4 8
+    python3 bench_lanes.py [input.txt] --edges 1 2 4 8
+    python3 bench_lanes.py [input.txt] --index-blocks 0 8 16 32
+    python3 bench_lanes.py [input.txt] --area-order
+    python3 bench_lanes.py [input.txt] --cache-lines 4 8 16 32 [--dram-latency 20]
+"""
+
+import json
+import os
+import subprocess
+import sys
+import time
+
+
+LIB_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "lib")
+
+
+def run_variant(lib_path, input_filepath, dram_latency):
+    """Run one library variant in-process and return its measurements."""
+    from rtl_max_rect import MaxRectangleFinder, load_polygon_from_file
+
+    vertices = load_polygon_from_file(input_filepath)
+    finder = MaxRectangleFinder(lib_path)
+    finder.configure_dram(dram_latency)
+    finder.load_polygon(vertices)
+    finder.enable_state_profile()
+    start_time = time.time()
+    finder.start_search()
+    cycles = finder.wait_done()
+    elapsed = time.time() - start_time
+
+    return {
+        'max_area': finder.max_area,
+        'done': finder.done,
+        'cycles': cycles,
+        'elapsed': elapsed,
+        'tested': finder.rectangles_tested,
+        'pruned': finder.rectangles_pruned,
+        'validation_cycles': finder.validation_cycles,
+        'edges_examined': finder.edges_examined,
+        'edges_skipped': finder.edges_skipped,
+        'lane_busy': finder.lane_busy_cycles(),
+        'cache_accesses': finder.cache_accesses,
+        'cache_hit_rate': finder.cache_hit_rate,
+        'stall_cycles': finder.cache_stall_cycles,
+    }
+
+
+def spawn_variant(lib_path, input_filepath, dram_latency):
+    """Run one library variant in a subprocess."""
+    cmd = [sys.executable, os.path.abspath(__file__), input_filepath, '--run-lib', lib_path,
+           '--dram-latency', str(dram_latency)]
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    if proc.returncode != 0:
+        print(proc.stderr, file=sys.stderr)
+        return None
+    return json.loads(proc.stdout)
+
+
+def main():
+    """Benchmark each validator-lane or multi-edge build."""
+    import argparse
+
+    parser = argparse.ArgumentParser(description='rtl_max_rect validator parallelism benchmark')
+    parser.add_argument('input_file', nargs='?', help='Input file with polygon vertices')
+    parser.add_argument('--lanes', type=int, nargs='+', default=[1, 2, 4, 8],
+                        help='Lane counts to benchmark (default: 1 2 4 8)')
+    parser.add_argument('--edges', type=int, nargs='+',
+                        help='Benchmark these edges-per-cycle builds instead of lane builds')
+    parser.add_argument('--index-blocks', type=int, nargs='+',
+                        help='Benchmark these edge-index block sizes (0 = no index) instead')
+    parser.add_argument('--area-order', action='store_true',
+                        help='Compare the pair-order and area-order builds instead')
+    parser.add_argument('--cache-lines', type=int, nargs='+',
+                        help='Benchmark these external-memory cache sizes (lines per port) instead')
+    parser.add_argument('--dram-latency', type=int, default=20,
+                        help='External memory request-to-data cycles (default: 20)')
+    parser.add_argument('--run-lib', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.input_file:
+        input_filepath = os.path.abspath(args.input_file)
+    else:
+        input_filepath = os.path.join(
+            os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))),
+            "testcase", "default_input.txt"
+        )
+
+    # Worker mode: measure a single variant and report as JSON
+    if args.run_lib:
+        print(json.dumps(run_variant(args.run_lib, input_filepath, args.dram_latency)))
+        return 0
+
+    if args.cache_lines:
+        column, counts, lib_name = 'lines', args.cache_lines, "librtl_max_rect_c{}_notrace.so".format
+    elif args.area_order:
+        column, counts = 'order', ['pair', 'area']
+        lib_name = {'pair': "librtl_max_rect_notrace.so", 'area': "librtl_max_rect_ao_notrace.so"}.get
+    elif args.index_blocks:
+        column, counts = 'block', args.index_blocks
+        lib_name = lambda b: f"librtl_max_rect_x{b}_notrace.so" if b else "librtl_max_rect_notrace.so"
+    elif args.edges:
+        column, counts, lib_name = 'edges', args.edges, "librtl_max_rect_e{}_notrace.so".format
+    else:
+        column, counts, lib_name = 'lanes', args.lanes, "librtl_max_rect_l{}_notrace.so".format
+
+    print(f"Benchmarking on: {input_filepath}", file=sys.stderr)
+    print(f"{column:>5} {'max_area':>12} {'cycles':>14} {'speedup':>8} {'tested':>9} "
+          f"{'pruned':>9} {'val_cyc':>8} {'skipped':>8} {'lane_util':>9} {'hits':>7} {'stalled':>8} "
+          f"{'wall_s':>9}")
+
+    baseline_cycles = None
+    baseline_area = None
+    status = 0
+    for k in counts:
+        lib_path = os.path.join(LIB_DIR, lib_name(k))
+        if not os.path.exists(lib_path):
+            print(f"{k:>5} missing {lib_path}")
+            status = 1
+            continue
+        stats = spawn_variant(lib_path, input_filepath, args.dram_latency)
+        if stats is None or not stats['done']:
+            print(f"{k:>5} failed")
+            status = 1
+            continue
+        if baseline_cycles is None:
+            baseline_cycles = stats['cycles']
+            baseline_area = stats['max_area']
+        elif stats['max_area'] != baseline_area:
+            print(f"{k:>5} max_area {stats['max_area']} differs from {baseline_area}", file=sys.stderr)
+            status = 1
+        speedup = baseline_cycles / stats['cycles'] if stats['cycles'] else 0.0
+        busy = stats['lane_busy']
+        util = sum(busy) / (len(busy) * stats['cycles']) if busy and stats['cycles'] else 0.0
+        per_rect = stats['validation_cycles'] / stats['tested'] if stats['tested'] else 0.0
+        visited = stats['edges_examined'] + stats['edges_skipped']
+        skipped = f"{100.0 * stats['edges_skipped'] / visited:.1f}%" if visited else "-"
+        external = stats['cache_accesses'] > 0
+        hits = f"{100.0 * stats['cache_hit_rate']:.1f}%" if external else "-"
+        stalled = f"{100.0 * stats['stall_cycles'] / stats['cycles']:.1f}%" if external and stats['cycles'] else "-"
+        print(f"{k:>5} {stats['max_area']:>12} {stats['cycles']:>14} {speedup:>7.2f}x "
+              f"{stats['tested']:>9} {stats['pruned']:>9} {per_rect:>8.1f} {skipped:>8} "
+              f"{100.0 * util:>8.1f}% {hits:>7} {stalled:>8} {stats['elapsed']:>9.3f}")
+
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
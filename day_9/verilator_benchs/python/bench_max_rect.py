@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""
+Scalable polygon benchmark suite for rtl_max_rect.
+
+Generates rectilinear polygons over a ladder of vertex counts, shapes and
+concavity levels, runs each through its own MaxRectangleFinder instance and
+reports simulated cycles, wall time, cycles/sec, rectangles/sec and the RTL
+statistics counters as JSON or CSV.
+
+Shapes (all simple, axis-aligned, no collinear vertices):
+    histogram - flat bottom, random column heights on top
+    comb      - flat bottom, alternating tall/short teeth
+    staircase - flat bottom, monotonically rising steps
+    double    - random column extents on both top and bottom
+
+Concavity (0..1) scales how far column heights may dip below the maximum.
+
+Usage:
+    python3 bench_max_rect.py [--sizes 16 64 256] [--shapes comb] [--format csv]
+"""
+
+import csv
+import json
+import os
+import random
+import sys
+import time
+
+from rtl_max_rect import MaxRectangleFinder
+
+
+SHAPES = ['histogram', 'comb', 'staircase', 'double']
+EXTENT = 100_000   # Polygon bounding box side (fits coord_width = 20)
+
+
+# =============================================================================
+# Polygon generation
+# =============================================================================
+
+def _distinct_levels(rng, count, lo, hi):
+    """Random integer levels in [lo, hi] with no two neighbours equal."""
+    hi = max(hi, lo + 1)
+    levels = []
+    for _ in range(count):
+        v = rng.randint(lo, hi)
+        while levels and v == levels[-1]:
+            v = rng.randint(lo, hi)
+        levels.append(v)
+    return levels
+
+
+def _column_edges(columns):
+    """X coordinates of the column boundaries."""
+    width = EXTENT // columns
+    return [i * width for i in range(columns + 1)]
+
+
+def _histogram_polygon(heights):
+    """Flat-bottomed polygon whose top follows the column heights."""
+    xs = _column_edges(len(heights))
+    vertices = [(xs[0], 0)]
+    for i, h in enumerate(heights):
+        vertices.append((xs[i], h))
+        vertices.append((xs[i + 1], h))
+    vertices.append((xs[-1], 0))
+    return vertices
+
+
+def generate_polygon(shape, num_vertices, concavity, seed=0):
+    """Generate a rectilinear polygon with (close to) num_vertices vertices.
+
+    Args:
+        shape: One of SHAPES
+        num_vertices: Target vertex count (rounded to the shape's step)
+        concavity: 0..1, depth of the dips relative to the bounding box
+        seed: RNG seed
+
+    Returns:
+        List of (x, y) tuples
+    """
+    if shape not in SHAPES:
+        raise ValueError(f"Unknown shape {shape!r}, expected one of {SHAPES}")
+    if not 0.0 <= concavity <= 1.0:
+        raise ValueError(f"concavity must be 0..1, got {concavity}")
+
+    rng = random.Random(f"{shape}:{num_vertices}:{concavity}:{seed}")
+    top = EXTENT
+    low = max(1, int(top * (1.0 - concavity)))
+
+    if shape == 'double':
+        # 4 vertices per column: top and bottom chains
+        columns = max(1, num_vertices // 4)
+        mid = EXTENT // 2
+        span = max(2, int(mid * concavity))
+        tops = _distinct_levels(rng, columns, mid + 1, mid + span)
+        bottoms = _distinct_levels(rng, columns, mid - span, mid - 1)
+        xs = _column_edges(columns)
+        vertices = []
+        for i, h in enumerate(tops):
+            vertices.append((xs[i], h))
+            vertices.append((xs[i + 1], h))
+        for i in range(columns - 1, -1, -1):
+            vertices.append((xs[i + 1], bottoms[i]))
+            vertices.append((xs[i], bottoms[i]))
+        return vertices
+
+    # 2 vertices per column plus the two bottom corners
+    columns = max(1, (num_vertices - 2) // 2)
+    if shape == 'histogram':
+        heights = _distinct_levels(rng, columns, low, top)
+    elif shape == 'comb':
+        short = min(low, top - 1)
+        heights = [top if i % 2 == 0 else short for i in range(columns)]
+    else:  # staircase
+        step = max(1, (top - low) // columns)
+        heights = [low + (i + 1) * step for i in range(columns)]
+
+    return _histogram_polygon(heights)
+
+
+# =============================================================================
+# Benchmark
+# =============================================================================
+
+def run_case(vertices, lib_path=None, max_cycles=2_000_000_000):
+    """Run one polygon through a fresh instance and collect statistics."""
+    finder = MaxRectangleFinder(lib_path)
+    finder.load_polygon(vertices)
+    finder.start_search()
+
+    start_time = time.perf_counter()
+    cycles = finder.wait_done(max_cycles)
+    elapsed = time.perf_counter() - start_time
+
+    tested = finder.rectangles_tested
+    return {
+        'done': finder.done,
+        'max_area': finder.max_area,
+        'cycles': cycles,
+        'wall_s': elapsed,
+        'cycles_per_s': cycles / elapsed if elapsed > 0 else 0.0,
+        'rects_per_s': tested / elapsed if elapsed > 0 else 0.0,
+        'rectangles_tested': tested,
+        'rectangles_pruned': finder.rectangles_pruned,
+        'validation_cycles': finder.validation_cycles,
+    }
+
+
+FIELDS = ['shape', 'concavity', 'target_vertices', 'vertices', 'status',
+          'max_area', 'cycles', 'wall_s', 'cycles_per_s', 'rects_per_s',
+          'rectangles_tested', 'rectangles_pruned', 'validation_cycles']
+
+
+def write_results(results, fmt, out):
+    """Write results as JSON (list of records) or CSV."""
+    if fmt == 'json':
+        json.dump(results, out, indent=2)
+        out.write('\n')
+    else:
+        writer = csv.DictWriter(out, fieldnames=FIELDS, extrasaction='ignore')
+        writer.writeheader()
+        for r in results:
+            writer.writerow(r)
+
+
+def main():
+    """Run the benchmark ladder."""
+    import argparse
+
+    parser = argparse.ArgumentParser(description='rtl_max_rect scaling benchmark')
+    parser.add_argument('--sizes', type=int, nargs='+', default=[16, 64, 256, 1024],
+                        help='Target vertex counts (default: 16 64 256 1024)')
+    parser.add_argument('--shapes', nargs='+', default=SHAPES, choices=SHAPES,
+                        help='Polygon shapes (default: all)')
+    parser.add_argument('--concavity', type=float, nargs='+', default=[0.2, 0.8],
+                        help='Concavity levels 0..1 (default: 0.2 0.8)')
+    parser.add_argument('--seed', type=int, default=0, help='Generator seed (default: 0)')
+    parser.add_argument('--max-vertices', type=int, default=1024,
+                        help='Vertex capacity of the library; larger cases are skipped (default: 1024)')
+    parser.add_argument('--max-cycles', type=int, default=2_000_000_000,
+                        help='Maximum search cycles per case (default: 2B)')
+    parser.add_argument('--lib', default=None, help='Shared library path')
+    parser.add_argument('--format', choices=['json', 'csv'], default='json',
+                        help='Output format (default: json)')
+    parser.add_argument('--output', '-o', default=None, help='Output file (default: stdout)')
+    parser.add_argument('--save-polygons', metavar='DIR',
+                        help='Also write each generated polygon to DIR')
+    args = parser.parse_args()
+
+    if args.save_polygons:
+        os.makedirs(args.save_polygons, exist_ok=True)
+
+    results = []
+    for size in args.sizes:
+        for shape in args.shapes:
+            for concavity in args.concavity:
+                vertices = generate_polygon(shape, size, concavity, args.seed)
+                record = {
+                    'shape': shape,
+                    'concavity': concavity,
+                    'target_vertices': size,
+                    'vertices': len(vertices),
+                }
+                name = f"{shape}_{size}_c{concavity:g}"
+
+                if args.save_polygons:
+                    with open(os.path.join(args.save_polygons, f"{name}.txt"), 'w') as f:
+                        f.writelines(f"{x},{y}\n" for x, y in vertices)
+
+                if len(vertices) > args.max_vertices:
+                    record['status'] = 'skipped'
+                    print(f"{name}: skipped ({len(vertices)} > {args.max_vertices} vertices)",
+                          file=sys.stderr)
+                    results.append(record)
+                    continue
+
+                record.update(run_case(vertices, args.lib, args.max_cycles))
+                record['status'] = 'ok' if record.pop('done') else 'timeout'
+                print(f"{name}: {record['status']}, {record['cycles']} cycles, "
+                      f"{record['wall_s']:.3f}s, {record['cycles_per_s'] / 1e6:.2f}M cycles/sec",
+                      file=sys.stderr)
+                results.append(record)
+
+    if args.output:
+        with open(args.output, 'w', newline='') as f:
+            write_results(results, args.format, f)
+    else:
+        write_results(results, args.format, sys.stdout)
+
+    return 1 if any(r['status'] == 'timeout' for r in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Profile-guided build benchmark for the Verilated models.
+
+Runs the same generated polygons (bench_max_rect.generate_polygon) through a
+plain -O3 library and its profile-guided rebuild and reports wall time and
+speedup per case. Both libraries must return the same result for every
+case. Each library runs in its own subprocess, like bench_threads.py, so the
+two Verilator runtimes never share an address space.
+
+With --train the workload runs once, in-process, on an instrumented
+library. GCC writes its .gcda files when the process exits, and models
+Verilated with --prof-pgo write profile.vlt when their instance is destroyed.
+
+Modules:
+    rtl_max_rect     - MaxRectangleFinder search, one fresh instance per case
+    impl_uart_bridge - full UART exchange through UartBridge.process_polygon
+
+Usage:
+    python3 bench_pgo.py rtl_max_rect --train ../lib/librtl_max_rect_pgogen_notrace.so
+    python3 bench_pgo.py rtl_max_rect --base ../lib/librtl_max_rect_notrace.so \\
+        --pgo ../lib/librtl_max_rect_pgo_notrace.so
+"""
+
+import json
+import os
+import subprocess
+import sys
+import time
+
+from bench_max_rect import SHAPES, generate_polygon
+
+
+MODULES = ['rtl_max_rect', 'impl_uart_bridge']
+
+
+def workload(sizes, shapes, concavities, seed):
+    """(name, vertices) for every size, shape and concavity level."""
+    cases = []
+    for size in sizes:
+        for shape in shapes:
+            for concavity in concavities:
+                cases.append((f"{shape}_{size}_c{concavity:g}",
+                              generate_polygon(shape, size, concavity, seed)))
+    return cases
+
+
+def run_one(module, lib_path, threads, vertices, max_cycles):
+    """Run one polygon on a fresh instance; returns (result, cycles, wall_s)."""
+    if module == 'rtl_max_rect':
+        from rtl_max_rect import MaxRectangleFinder
+
+        finder = MaxRectangleFinder(lib_path, threads=threads)
+        finder.load_polygon(vertices)
+        finder.start_search()
+        start_time = time.perf_counter()
+        cycles = finder.wait_done(max_cycles)
+        elapsed = time.perf_counter() - start_time
+        result = finder.max_area if finder.done else None
+        del finder
+        return result, cycles, elapsed
+
+    from impl_uart_bridge import UartBridge
+
+    bridge = UartBridge(lib_path, threads=threads)
+    input_data = ''.join(f"{x},{y}\n" for x, y in vertices)
+    start_time = time.perf_counter()
+    result, cycles = bridge.process_polygon(input_data, max_cycles)
+    elapsed = time.perf_counter() - start_time
+    del bridge
+    return result, cycles, elapsed
+
+
+def run_workload(module, lib_path, threads, cases, repeats, max_cycles):
+    """Run every case repeats times; keeps the best wall time per case."""
+    rows = []
+    for name, vertices in cases:
+        best = None
+        for _ in range(repeats):
+            result, cycles, elapsed = run_one(module, lib_path, threads, vertices, max_cycles)
+            if best is None or elapsed < best:
+                best = elapsed
+        rows.append({'name': name, 'vertices': len(vertices), 'result': result,
+                     'cycles': cycles, 'wall_s': best})
+    return rows
+
+
+def spawn_workload(lib_path, args):
+    """Run the workload on one library in a subprocess."""
+    cmd = [sys.executable, os.path.abspath(__file__), args.module, '--run-lib', lib_path,
+           '--threads', str(args.threads), '--repeats', str(args.repeats),
+           '--max-cycles', str(args.max_cycles), '--seed', str(args.seed),
+           '--sizes', *map(str, args.sizes), '--shapes', *args.shapes,
+           '--concavity', *map(str, args.concavity)]
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    if proc.returncode != 0:
+        print(proc.stderr, file=sys.stderr)
+        return None
+    return json.loads(proc.stdout)
+
+
+def main():
+    """Train an instrumented library, or compare a plain and a PGO build."""
+    import argparse
+
+    parser = argparse.ArgumentParser(description='Plain vs. profile-guided library benchmark')
+    parser.add_argument('module', choices=MODULES, help='Wrapper the libraries were built from')
+    parser.add_argument('--train', metavar='LIB', help='Run the workload once on an instrumented library')
+    parser.add_argument('--base', metavar='LIB', help='Plain -O3 library')
+    parser.add_argument('--pgo', metavar='LIB', help='Profile-guided library')
+    parser.add_argument('--threads', type=int, default=0,
+                        help='Context threads for --threads models (default: 0)')
+    parser.add_argument('--sizes', type=int, nargs='+', default=[16, 64, 256],
+                        help='Target vertex counts (default: 16 64 256)')
+    parser.add_argument('--shapes', nargs='+', default=SHAPES, choices=SHAPES,
+                        help='Polygon shapes (default: all)')
+    parser.add_argument('--concavity', type=float, nargs='+', default=[0.2, 0.8],
+                        help='Concavity levels 0..1 (default: 0.2 0.8)')
+    parser.add_argument('--seed', type=int, default=0, help='Generator seed (default: 0)')
+    parser.add_argument('--repeats', type=int, default=3,
+                        help='Runs per case, best time kept (default: 3)')
+    parser.add_argument('--max-cycles', type=int, default=50_000_000_000,
+                        help='Cycle limit per case (default: 50B)')
+    parser.add_argument('--json', metavar='FILE', help='Also write the rows as JSON')
+    parser.add_argument('--run-lib', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    cases = workload(args.sizes, args.shapes, args.concavity, args.seed)
+
+    # Worker mode: measure a single library and report as JSON
+    if args.run_lib:
+        rows = run_workload(args.module, args.run_lib, args.threads, cases, args.repeats, args.max_cycles)
+        print(json.dumps(rows))
+        return 0
+
+    if args.train:
+        print(f"Training {args.train} on {len(cases)} cases...", file=sys.stderr)
+        rows = run_workload(args.module, args.train, args.threads, cases, 1, args.max_cycles)
+        cycles = sum(r['cycles'] for r in rows)
+        print(f"  {cycles} cycles in {sum(r['wall_s'] for r in rows):.3f}s", file=sys.stderr)
+        return 1 if any(r['result'] is None for r in rows) else 0
+
+    if not args.base or not args.pgo:
+        parser.error("pass --train LIB, or both --base LIB and --pgo LIB")
+    for lib_path in (args.base, args.pgo):
+        if not os.path.exists(lib_path):
+            print(f"Missing {lib_path}", file=sys.stderr)
+            return 1
+
+    base = spawn_workload(args.base, args)
+    pgo = spawn_workload(args.pgo, args)
+    if base is None or pgo is None:
+        return 1
+
+    print(f"{'case':<22} {'vertices':>8} {'cycles':>14} {'base_s':>9} {'pgo_s':>9} {'speedup':>8}")
+    status = 0
+    rows = []
+    for b, p in zip(base, pgo):
+        if b['result'] != p['result'] or b['cycles'] != p['cycles']:
+            print(f"{b['name']:<22} result mismatch: base {b['result']} ({b['cycles']} cycles), "
+                  f"pgo {p['result']} ({p['cycles']} cycles)", file=sys.stderr)
+            status = 1
+        speedup = b['wall_s'] / p['wall_s'] if p['wall_s'] > 0 else 0.0
+        rows.append({'name': b['name'], 'vertices': b['vertices'], 'cycles': b['cycles'],
+                     'base_s': b['wall_s'], 'pgo_s': p['wall_s'], 'speedup': speedup})
+        print(f"{b['name']:<22} {b['vertices']:>8} {b['cycles']:>14} {b['wall_s']:>9.3f} "
+              f"{p['wall_s']:>9.3f} {speedup:>7.2f}x")
+
+    base_total = sum(r['base_s'] for r in rows)
+    pgo_total = sum(r['pgo_s'] for r in rows)
+    total_speedup = base_total / pgo_total if pgo_total > 0 else 0.0
+    print(f"{'total':<22} {'':>8} {sum(r['cycles'] for r in rows):>14} {base_total:>9.3f} "
+          f"{pgo_total:>9.3f} {total_speedup:>7.2f}x")
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'module': args.module, 'base': args.base, 'pgo': args.pgo,
+                       'speedup': total_speedup, 'cases': rows}, f, indent=2)
+        print(f"Wrote {args.json}", file=sys.stderr)
+
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
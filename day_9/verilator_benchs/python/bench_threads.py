@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""
+Thread-scaling benchmark for the multithreaded impl_uart_bridge models.
+
+Runs the same polygon through libimpl_uart_bridge.so (single-threaded
+baseline) and each libimpl_uart_bridge_mt<N>.so, and reports simulated
+cycles per second. Every variant runs in its own subprocess so the
+separately built Verilator runtimes never share an address space.
+
+Usage:
+    python3 bench_threads.py [input.txt] --threads 1 2 4 8
+"""
+
+import json
+import os
+import subprocess
+import sys
+import time
+
+
+LIB_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "lib")
+
+
+def run_variant(lib_path, threads, input_filepath):
+    """Run one library variant in-process and return its measurements."""
+    from impl_uart_bridge import UartBridge
+
+    with open(input_filepath, 'r') as f:
+        input_data = f.read()
+
+    bridge = UartBridge(lib_path, threads=threads)
+    start_time = time.time()
+    result, cycles = bridge.process_polygon(input_data)
+    elapsed = time.time() - start_time
+
+    return {
+        'result': result,
+        'cycles': cycles,
+        'elapsed': elapsed,
+    }
+
+
+def spawn_variant(lib_path, threads, input_filepath):
+    """Run one library variant in a subprocess."""
+    cmd = [sys.executable, os.path.abspath(__file__), input_filepath,
+           '--run-lib', lib_path, '--run-threads', str(threads)]
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    if proc.returncode != 0:
+        print(proc.stderr, file=sys.stderr)
+        return None
+    return json.loads(proc.stdout)
+
+
+def main():
+    """Benchmark the baseline and multithreaded builds."""
+    import argparse
+
+    parser = argparse.ArgumentParser(description='impl_uart_bridge thread-scaling benchmark')
+    parser.add_argument('input_file', nargs='?', help='Input file with polygon vertices')
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 2, 4, 8],
+                        help='Thread counts to benchmark (default: 1 2 4 8)')
+    parser.add_argument('--run-lib', help=argparse.SUPPRESS)
+    parser.add_argument('--run-threads', type=int, default=0, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.input_file:
+        input_filepath = os.path.abspath(args.input_file)
+    else:
+        input_filepath = os.path.join(
+            os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))),
+            "testcase", "default_input.txt"
+        )
+
+    # Worker mode: measure a single variant and report as JSON
+    if args.run_lib:
+        print(json.dumps(run_variant(args.run_lib, args.run_threads, input_filepath)))
+        return 0
+
+    variants = [('st', 0, os.path.join(LIB_DIR, "libimpl_uart_bridge.so"))]
+    for t in args.threads:
+        variants.append((f'mt{t}', t, os.path.join(LIB_DIR, f"libimpl_uart_bridge_mt{t}.so")))
+
+    print(f"Benchmarking on: {input_filepath}", file=sys.stderr)
+    print(f"{'variant':<8} {'threads':>7} {'cycles':>14} {'wall_s':>9} {'Mcyc/s':>9} {'speedup':>8}")
+
+    baseline_rate = None
+    status = 0
+    for name, threads, lib_path in variants:
+        if not os.path.exists(lib_path):
+            print(f"{name:<8} {'':>7} missing {lib_path}")
+            status = 1
+            continue
+        stats = spawn_variant(lib_path, threads, input_filepath)
+        if stats is None:
+            print(f"{name:<8} {threads:>7} failed")
+            status = 1
+            continue
+        rate = stats['cycles'] / stats['elapsed'] if stats['elapsed'] > 0 else 0.0
+        if baseline_rate is None:
+            baseline_rate = rate
+        speedup = rate / baseline_rate if baseline_rate else 0.0
+        print(f"{name:<8} {threads:>7} {stats['cycles']:>14} {stats['elapsed']:>9.3f} "
+              f"{rate / 1e6:>9.2f} {speedup:>7.2f}x")
+
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
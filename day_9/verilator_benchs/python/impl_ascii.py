@@ -5,7 +5,7 @@ Python ctypes wrapper for impl_ascii (MaxRectangleAsciiWrapper) Verilator module
 Usage:
     from impl_ascii import AsciiWrapper
 
-    wrapper = AsciiWrapper()
+    wrapper = AsciiWrapper(trace=bool(args.waveform))
     result = wrapper.process_polygon("0,0\n100,0\n100,100\n0,100\n\n")
     print(f"Result: {result}")
 """
@@ -14,81 +14,107 @@ import ctypes
 import os
 import sys
 
+from sim_signals import SimSignalsMixin
 
-class AsciiWrapper:
+
+class AsciiWrapper(SimSignalsMixin):
     """Python wrapper for MaxRectangleAsciiWrapper RTL simulation via Verilator."""
 
-    def __init__(self, lib_path=None):
+    OUTPUT_BUFFER_SIZE = 256  # Result line is at most 14 bytes
+    SEND_MAX_WAIT = 0xFFFFFFFF  # Per-character ready timeout for process_polygon
+
+    def __init__(self, lib_path=None, threads=0, trace=False):
         """Initialize the Verilator module wrapper.
 
         Args:
             lib_path: Path to shared library. If None, uses default location.
+            threads: Simulation threads for --threads builds (0 = default)
+            trace: Load the traced library (required for enable_waveform).
+                Otherwise the default is the trace-free libimpl_ascii_notrace.so,
+                falling back to the traced library if it has not been built.
         """
         if lib_path is None:
-            lib_path = os.path.join(
-                os.path.dirname(__file__),
-                "../lib/libimpl_ascii.so"
-            )
+            lib_dir = os.path.join(os.path.dirname(__file__), "../lib")
+            lib_path = os.path.join(lib_dir, "libimpl_ascii.so")
+            notrace_path = os.path.join(lib_dir, "libimpl_ascii_notrace.so")
+            if not trace and os.path.exists(notrace_path):
+                lib_path = notrace_path
 
         if not os.path.exists(lib_path):
             raise FileNotFoundError(f"Shared library not found: {lib_path}")
 
         self.lib = ctypes.CDLL(lib_path)
         self._setup_functions()
-        self.lib.init_module()
+        self._sampling = None
+        self.handle = self.lib.create_instance(threads)
 
     def _setup_functions(self):
         """Define C function signatures."""
         # Lifecycle
-        self.lib.init_module.argtypes = []
-        self.lib.init_module.restype = None
-        self.lib.cleanup_module.argtypes = []
-        self.lib.cleanup_module.restype = None
+        self.lib.create_instance.argtypes = [ctypes.c_uint32]
+        self.lib.create_instance.restype = ctypes.c_void_p
+        self.lib.destroy_instance.argtypes = [ctypes.c_void_p]
+        self.lib.destroy_instance.restype = None
 
         # Waveform control
-        self.lib.enable_waveform.argtypes = [ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
+        self.lib.enable_waveform.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
         self.lib.enable_waveform.restype = None
-        self.lib.disable_waveform.argtypes = []
+        self.lib.disable_waveform.argtypes = [ctypes.c_void_p]
         self.lib.disable_waveform.restype = None
+        self.lib.has_waveform_support.argtypes = []
+        self.lib.has_waveform_support.restype = ctypes.c_uint8
+        self._setup_signal_functions()
 
         # Clock
-        self.lib.clock_cycle.argtypes = []
+        self.lib.clock_cycle.argtypes = [ctypes.c_void_p]
         self.lib.clock_cycle.restype = None
-        self.lib.clock_n.argtypes = [ctypes.c_uint32]
+        self.lib.clock_n.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
         self.lib.clock_n.restype = None
 
         # Input signals
-        self.lib.set_ascii_in.argtypes = [ctypes.c_uint8]
+        self.lib.set_ascii_in.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_ascii_in.restype = None
-        self.lib.set_ascii_in_valid.argtypes = [ctypes.c_uint8]
+        self.lib.set_ascii_in_valid.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_ascii_in_valid.restype = None
-        self.lib.set_ascii_out_ready.argtypes = [ctypes.c_uint8]
+        self.lib.set_ascii_out_ready.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_ascii_out_ready.restype = None
 
         # Output signals
-        self.lib.get_ascii_in_ready.argtypes = []
+        self.lib.get_ascii_in_ready.argtypes = [ctypes.c_void_p]
         self.lib.get_ascii_in_ready.restype = ctypes.c_uint8
-        self.lib.get_ascii_out.argtypes = []
+        self.lib.get_ascii_out.argtypes = [ctypes.c_void_p]
         self.lib.get_ascii_out.restype = ctypes.c_uint8
-        self.lib.get_ascii_out_valid.argtypes = []
+        self.lib.get_ascii_out_valid.argtypes = [ctypes.c_void_p]
         self.lib.get_ascii_out_valid.restype = ctypes.c_uint8
-        self.lib.get_processing.argtypes = []
+        self.lib.get_processing.argtypes = [ctypes.c_void_p]
         self.lib.get_processing.restype = ctypes.c_uint8
-        self.lib.get_done.argtypes = []
+        self.lib.get_done.argtypes = [ctypes.c_void_p]
         self.lib.get_done.restype = ctypes.c_uint8
 
         # Convenience functions
-        self.lib.send_char.argtypes = [ctypes.c_uint8, ctypes.c_uint32]
+        self.lib.send_char.argtypes = [ctypes.c_void_p, ctypes.c_uint8, ctypes.c_uint32]
         self.lib.send_char.restype = ctypes.c_uint8
-        self.lib.receive_char.argtypes = []
+        self.lib.receive_char.argtypes = [ctypes.c_void_p]
         self.lib.receive_char.restype = ctypes.c_uint16
-        self.lib.run_until_done.argtypes = [ctypes.c_uint64]
+        self.lib.run_until_done.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
         self.lib.run_until_done.restype = ctypes.c_uint64
 
+        # Streaming functions
+        self.lib.send_buffer.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_uint32]
+        self.lib.send_buffer.restype = ctypes.c_size_t
+        self.lib.drain_output.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t,
+                                          ctypes.POINTER(ctypes.c_size_t), ctypes.c_uint64]
+        self.lib.drain_output.restype = ctypes.c_uint64
+        self.lib.run_polygon.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t,
+                                         ctypes.c_char_p, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t),
+                                         ctypes.c_uint32, ctypes.c_uint64]
+        self.lib.run_polygon.restype = ctypes.c_uint64
+
     def __del__(self):
         """Cleanup on destruction."""
-        if hasattr(self, 'lib'):
-            self.lib.cleanup_module()
+        if getattr(self, 'handle', None):
+            self.lib.destroy_instance(self.handle)
+            self.handle = None
 
     # =========================================================================
     # Waveform control
@@ -102,13 +128,15 @@ class AsciiWrapper:
             from_cycle: Start capturing from this cycle (default 0)
             to_cycle: Stop capturing at this cycle (default: unlimited)
         """
+        if not self.lib.has_waveform_support():
+            raise RuntimeError("Library built without tracing; create with trace=True")
         if to_cycle is None:
             to_cycle = 0xFFFFFFFFFFFFFFFF  # UINT64_MAX
-        self.lib.enable_waveform(filename.encode(), from_cycle, to_cycle)
+        self.lib.enable_waveform(self.handle, filename.encode(), from_cycle, to_cycle)
 
     def disable_waveform(self):
         """Disable waveform capture and close the file."""
-        self.lib.disable_waveform()
+        self.lib.disable_waveform(self.handle)
 
     # =========================================================================
     # Clock control
@@ -117,9 +145,9 @@ class AsciiWrapper:
     def clock(self, n=1):
         """Advance simulation by n clock cycles."""
         if n == 1:
-            self.lib.clock_cycle()
+            self.lib.clock_cycle(self.handle)
         else:
-            self.lib.clock_n(n)
+            self.lib.clock_n(self.handle, n)
 
     # =========================================================================
     # Input/Output
@@ -137,24 +165,43 @@ class AsciiWrapper:
         """
         if isinstance(c, str):
             c = ord(c)
-        return bool(self.lib.send_char(c, max_wait))
+        return bool(self.lib.send_char(self.handle, c, max_wait))
 
-    def send_string(self, s):
+    def send_string(self, s, max_wait=1000):
         """Send a string of characters.
 
+        Output the module produces meanwhile is not collected;
+        process_polygon() keeps it.
+
         Args:
-            s: String to send
+            s: String (or bytes) to send
+            max_wait: Maximum cycles to wait for ready per character
 
         Returns:
             Number of characters successfully sent
         """
-        count = 0
-        for c in s:
-            if self.send_char(c):
-                count += 1
-            else:
-                break
-        return count
+        data = s.encode() if isinstance(s, str) else bytes(s)
+        return self.lib.send_buffer(self.handle, data, len(data), max_wait)
+
+    def drain_output(self, max_cycles=50_000_000_000):
+        """Clock until done, collecting the output.
+
+        Args:
+            max_cycles: Maximum cycles to wait
+
+        Returns:
+            Tuple of (output_string, cycles_taken), with \r and \n removed
+        """
+        buf = ctypes.create_string_buffer(self.OUTPUT_BUFFER_SIZE)
+        out_len = ctypes.c_size_t(0)
+        cycles = self.lib.drain_output(self.handle, buf, self.OUTPUT_BUFFER_SIZE,
+                                       ctypes.byref(out_len), max_cycles)
+        return self._decode_output(buf.raw[:out_len.value]), cycles
+
+    @staticmethod
+    def _decode_output(raw):
+        """Decode received bytes, dropping line endings."""
+        return ''.join(c for c in raw.decode('latin-1') if c not in '\r\n')
 
     def receive_output(self, max_cycles=1000):
         """Receive output characters.
@@ -167,7 +214,7 @@ class AsciiWrapper:
         """
         output = []
         for _ in range(max_cycles):
-            result = self.lib.receive_char()
+            result = self.lib.receive_char(self.handle)
             if result & 0x100:  # Valid flag set
                 char = chr(result & 0xFF)
                 if char not in '\r\n':
@@ -182,22 +229,22 @@ class AsciiWrapper:
     @property
     def processing(self):
         """True if module is processing."""
-        return bool(self.lib.get_processing())
+        return bool(self.lib.get_processing(self.handle))
 
     @property
     def done(self):
         """True if processing is complete."""
-        return bool(self.lib.get_done())
+        return bool(self.lib.get_done(self.handle))
 
     @property
     def ascii_in_ready(self):
         """True if ready to accept input."""
-        return bool(self.lib.get_ascii_in_ready())
+        return bool(self.lib.get_ascii_in_ready(self.handle))
 
     @property
     def ascii_out_valid(self):
         """True if output is valid."""
-        return bool(self.lib.get_ascii_out_valid())
+        return bool(self.lib.get_ascii_out_valid(self.handle))
 
     # =========================================================================
     # High-level API
@@ -206,41 +253,26 @@ class AsciiWrapper:
     def process_polygon(self, input_data, max_cycles=50_000_000_000):
         """Process a polygon and return the result.
 
+        The handshake and output collection both run inside the wrapper,
+        so the whole exchange is a single native call.
+
         Args:
             input_data: String of polygon vertices (x,y per line)
             max_cycles: Maximum simulation cycles
 
         Returns:
-            Result string (the max area as decimal)
+            Tuple of (result_string, cycles_taken), where cycles_taken counts
+            the cycles after the input was accepted
         """
-        # Send input data
-        for c in input_data:
-            self.lib.set_ascii_in(ord(c))
-            self.lib.set_ascii_in_valid(1)
-            while not self.lib.get_ascii_in_ready():
-                self.clock()
-            self.clock()
-
-        # Send null to signal end of polygon
-        self.lib.set_ascii_in(0)
-        self.lib.set_ascii_in_valid(1)
-        while not self.lib.get_ascii_in_ready():
-            self.clock()
-        self.clock()
-        self.lib.set_ascii_in_valid(0)
-
-        # Wait for done and collect output
-        output = []
-        cycles = 0
-        while not self.done and cycles < max_cycles:
-            self.clock()
-            if self.lib.get_ascii_out_valid():
-                c = chr(self.lib.get_ascii_out())
-                if c not in '\r\n':
-                    output.append(c)
-            cycles += 1
+        # Add null terminator to signal end of polygon
+        data = input_data.encode() + b'\0'
 
-        return ''.join(output), cycles
+        buf = ctypes.create_string_buffer(self.OUTPUT_BUFFER_SIZE)
+        out_len = ctypes.c_size_t(0)
+        cycles = self.lib.run_polygon(self.handle, data, len(data),
+                                      buf, self.OUTPUT_BUFFER_SIZE, ctypes.byref(out_len),
+                                      self.SEND_MAX_WAIT, max_cycles)
+        return self._decode_output(buf.raw[:out_len.value]), cycles
 
 
 # =============================================================================
@@ -278,7 +310,7 @@ def main():
     print(f"Input bytes: {len(input_data)}", file=sys.stderr)
 
     # Create wrapper and run
-    wrapper = AsciiWrapper()
+    wrapper = AsciiWrapper(trace=bool(args.waveform))
 
     # Enable waveform if requested
     if args.waveform:
@@ -5,7 +5,7 @@ Python ctypes wrapper for impl_uart (UART Loopback) Verilator module.
 Usage:
     from impl_uart import UartLoopback
 
-    uart = UartLoopback()
+    uart = UartLoopback(trace=bool(args.waveform))
     uart.send_byte(0x55)
     received = uart.receive_byte()
 """
@@ -14,80 +14,104 @@ import ctypes
 import os
 import sys
 
+from sim_signals import SimSignalsMixin
 
-class UartLoopback:
+
+class UartLoopback(SimSignalsMixin):
     """Python wrapper for UART Loopback RTL simulation via Verilator."""
 
     BAUD_DIV = 234  # 27MHz @ 115200 baud
 
-    def __init__(self, lib_path=None):
+    # Event bits for run_until_event() (match EVENT_* in the wrapper)
+    EVENT_TX = 1 << 0  # tx line level
+    EVENT_TX_BUSY = 1 << 1
+    EVENT_RX_BUSY = 1 << 2
+    EVENT_VALID = 1 << 3
+    EVENT_FRAME_ERROR = 1 << 4
+    EVENT_BREAK = 1 << 5
+    EVENT_ALL = (1 << 6) - 1
+
+    def __init__(self, lib_path=None, threads=0, trace=False):
         """Initialize the Verilator module wrapper.
 
         Args:
             lib_path: Path to shared library. If None, uses default location.
+            threads: Simulation threads for --threads builds (0 = default)
+            trace: Load the traced library (required for enable_waveform).
+                Otherwise the default is the trace-free libimpl_uart_notrace.so,
+                falling back to the traced library if it has not been built.
         """
         if lib_path is None:
-            lib_path = os.path.join(
-                os.path.dirname(__file__),
-                "../lib/libimpl_uart.so"
-            )
+            lib_dir = os.path.join(os.path.dirname(__file__), "../lib")
+            lib_path = os.path.join(lib_dir, "libimpl_uart.so")
+            notrace_path = os.path.join(lib_dir, "libimpl_uart_notrace.so")
+            if not trace and os.path.exists(notrace_path):
+                lib_path = notrace_path
 
         if not os.path.exists(lib_path):
             raise FileNotFoundError(f"Shared library not found: {lib_path}")
 
         self.lib = ctypes.CDLL(lib_path)
         self._setup_functions()
-        self.lib.init_module()
+        self._sampling = None
+        self.handle = self.lib.create_instance(threads)
 
     def _setup_functions(self):
         """Define C function signatures."""
         # Lifecycle
-        self.lib.init_module.argtypes = []
-        self.lib.init_module.restype = None
-        self.lib.cleanup_module.argtypes = []
-        self.lib.cleanup_module.restype = None
+        self.lib.create_instance.argtypes = [ctypes.c_uint32]
+        self.lib.create_instance.restype = ctypes.c_void_p
+        self.lib.destroy_instance.argtypes = [ctypes.c_void_p]
+        self.lib.destroy_instance.restype = None
 
         # Waveform control
-        self.lib.enable_waveform.argtypes = [ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
+        self.lib.enable_waveform.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
         self.lib.enable_waveform.restype = None
-        self.lib.disable_waveform.argtypes = []
+        self.lib.disable_waveform.argtypes = [ctypes.c_void_p]
         self.lib.disable_waveform.restype = None
+        self.lib.has_waveform_support.argtypes = []
+        self.lib.has_waveform_support.restype = ctypes.c_uint8
+        self._setup_signal_functions()
 
         # Clock
-        self.lib.clock_cycle.argtypes = []
+        self.lib.clock_cycle.argtypes = [ctypes.c_void_p]
         self.lib.clock_cycle.restype = None
-        self.lib.clock_n.argtypes = [ctypes.c_uint32]
+        self.lib.clock_n.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
         self.lib.clock_n.restype = None
 
         # TX signals
-        self.lib.set_tx_enable.argtypes = [ctypes.c_uint8]
+        self.lib.set_tx_enable.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_tx_enable.restype = None
-        self.lib.set_data.argtypes = [ctypes.c_uint8]
+        self.lib.set_data.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_data.restype = None
-        self.lib.get_busy.argtypes = []
+        self.lib.get_busy.argtypes = [ctypes.c_void_p]
         self.lib.get_busy.restype = ctypes.c_uint8
-        self.lib.get_tx.argtypes = []
+        self.lib.get_tx.argtypes = [ctypes.c_void_p]
         self.lib.get_tx.restype = ctypes.c_uint8
 
         # RX signals (set_rx removed - internal loopback)
-        self.lib.get_valid.argtypes = []
+        self.lib.get_valid.argtypes = [ctypes.c_void_p]
         self.lib.get_valid.restype = ctypes.c_uint8
-        self.lib.get_frame_error.argtypes = []
+        self.lib.get_frame_error.argtypes = [ctypes.c_void_p]
         self.lib.get_frame_error.restype = ctypes.c_uint8
         # get_parity_ok removed - not available when parity is disabled
-        self.lib.get_break_detected.argtypes = []
+        self.lib.get_break_detected.argtypes = [ctypes.c_void_p]
         self.lib.get_break_detected.restype = ctypes.c_uint8
 
         # Convenience functions
-        self.lib.send_byte.argtypes = [ctypes.c_uint8]
+        self.lib.send_byte.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.send_byte.restype = ctypes.c_uint32
-        self.lib.receive_byte.argtypes = [ctypes.c_uint32]
+        self.lib.receive_byte.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
         self.lib.receive_byte.restype = ctypes.c_uint16
+        self.lib.run_until_event.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint32,
+                                             ctypes.POINTER(ctypes.c_uint32)]
+        self.lib.run_until_event.restype = ctypes.c_uint64
 
     def __del__(self):
         """Cleanup on destruction."""
-        if hasattr(self, 'lib'):
-            self.lib.cleanup_module()
+        if getattr(self, 'handle', None):
+            self.lib.destroy_instance(self.handle)
+            self.handle = None
 
     # =========================================================================
     # Waveform control
@@ -101,13 +125,15 @@ class UartLoopback:
             from_cycle: Start capturing from this cycle (default 0)
             to_cycle: Stop capturing at this cycle (default: unlimited)
         """
+        if not self.lib.has_waveform_support():
+            raise RuntimeError("Library built without tracing; create with trace=True")
         if to_cycle is None:
             to_cycle = 0xFFFFFFFFFFFFFFFF  # UINT64_MAX
-        self.lib.enable_waveform(filename.encode(), from_cycle, to_cycle)
+        self.lib.enable_waveform(self.handle, filename.encode(), from_cycle, to_cycle)
 
     def disable_waveform(self):
         """Disable waveform capture and close the file."""
-        self.lib.disable_waveform()
+        self.lib.disable_waveform(self.handle)
 
     # =========================================================================
     # Clock control
@@ -116,9 +142,9 @@ class UartLoopback:
     def clock(self, n=1):
         """Advance simulation by n clock cycles."""
         if n == 1:
-            self.lib.clock_cycle()
+            self.lib.clock_cycle(self.handle)
         else:
-            self.lib.clock_n(n)
+            self.lib.clock_n(self.handle, n)
 
     # =========================================================================
     # TX API
@@ -133,7 +159,7 @@ class UartLoopback:
         Returns:
             Cycles taken
         """
-        return self.lib.send_byte(byte)
+        return self.lib.send_byte(self.handle, byte)
 
     def send_bytes(self, data):
         """Send multiple bytes via TX.
@@ -165,7 +191,7 @@ class UartLoopback:
         if max_cycles is None:
             max_cycles = self.BAUD_DIV * 15
 
-        result = self.lib.receive_byte(max_cycles)
+        result = self.lib.receive_byte(self.handle, max_cycles)
         if result & 0x100:
             return result & 0xFF
         return None
@@ -188,6 +214,30 @@ class UartLoopback:
             data.append(b)
         return data
 
+    # =========================================================================
+    # Event-driven stepping
+    # =========================================================================
+
+    def run_until_event(self, mask=None, max_cycles=None):
+        """Clock natively until a watched output changes level.
+
+        Inputs keep their current values while running.
+
+        Args:
+            mask: OR of EVENT_* bits to watch (default: EVENT_ALL)
+            max_cycles: Maximum cycles to run (default: BAUD_DIV * 15)
+
+        Returns:
+            Tuple of (cycles_taken, fired_mask); fired_mask is 0 on timeout
+        """
+        if mask is None:
+            mask = self.EVENT_ALL
+        if max_cycles is None:
+            max_cycles = self.BAUD_DIV * 15
+        fired = ctypes.c_uint32(0)
+        cycles = self.lib.run_until_event(self.handle, max_cycles, mask, ctypes.byref(fired))
+        return cycles, fired.value
+
     # =========================================================================
     # Properties
     # =========================================================================
@@ -195,24 +245,24 @@ class UartLoopback:
     @property
     def busy(self):
         """True if TX is busy."""
-        return bool(self.lib.get_busy())
+        return bool(self.lib.get_busy(self.handle))
 
     @property
     def valid(self):
         """True if RX has valid data."""
-        return bool(self.lib.get_valid())
+        return bool(self.lib.get_valid(self.handle))
 
     @property
     def frame_error(self):
         """True if RX frame error detected."""
-        return bool(self.lib.get_frame_error())
+        return bool(self.lib.get_frame_error(self.handle))
 
     # parity_ok property removed - not available when parity is disabled
 
     @property
     def break_detected(self):
         """True if RX break detected."""
-        return bool(self.lib.get_break_detected())
+        return bool(self.lib.get_break_detected(self.handle))
 
 
 # =============================================================================
@@ -236,7 +286,7 @@ def main():
     print("UART Loopback Test", file=sys.stderr)
 
     # Create UART instance
-    uart = UartLoopback()
+    uart = UartLoopback(trace=bool(args.waveform))
 
     # Enable waveform if requested
     if args.waveform:
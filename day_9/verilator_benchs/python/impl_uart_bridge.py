@@ -8,7 +8,7 @@ serial interface for the MaxRectangleFinder.
 Usage:
     from impl_uart_bridge import UartBridge
 
-    bridge = UartBridge()
+    bridge = UartBridge(trace=bool(args.waveform))
     result = bridge.process_polygon("0,0\n100,0\n100,100\n0,100\n\n")
     print(f"Result: {result}")
 """
@@ -17,95 +17,121 @@ import ctypes
 import os
 import sys
 
+from sim_signals import SimSignalsMixin
 
-class UartBridge:
+
+class UartBridge(SimSignalsMixin):
     """Python wrapper for UartBridgeTop RTL simulation via Verilator."""
 
     BAUD_DIV = 234  # 27MHz @ 115200 baud
 
-    def __init__(self, lib_path=None):
+    # Event bits for run_until_event() (match EVENT_* in the wrapper)
+    EVENT_UART_TX = 1 << 0  # uart_tx line level
+    EVENT_TX_READY = 1 << 1
+    EVENT_TX_OVERFLOW = 1 << 2
+    EVENT_RX_VALID = 1 << 3
+    EVENT_RX_OVERFLOW = 1 << 4
+    EVENT_PROCESSING = 1 << 5
+    EVENT_DONE = 1 << 6
+    EVENT_ALL = (1 << 7) - 1
+    OUTPUT_BUFFER_SIZE = 256  # Result line is at most 14 bytes
+
+    def __init__(self, lib_path=None, threads=0, trace=False):
         """Initialize the Verilator module wrapper.
 
         Args:
             lib_path: Path to shared library. If None, uses default location.
+            threads: Simulation threads for --threads builds (0 = default)
+            trace: Load the traced library (required for enable_waveform).
+                Otherwise the default is the trace-free libimpl_uart_bridge_notrace.so,
+                falling back to the traced library if it has not been built.
         """
         if lib_path is None:
-            lib_path = os.path.join(
-                os.path.dirname(__file__),
-                "../lib/libimpl_uart_bridge.so"
-            )
+            lib_dir = os.path.join(os.path.dirname(__file__), "../lib")
+            lib_path = os.path.join(lib_dir, "libimpl_uart_bridge.so")
+            notrace_path = os.path.join(lib_dir, "libimpl_uart_bridge_notrace.so")
+            if not trace and os.path.exists(notrace_path):
+                lib_path = notrace_path
 
         if not os.path.exists(lib_path):
             raise FileNotFoundError(f"Shared library not found: {lib_path}")
 
         self.lib = ctypes.CDLL(lib_path)
         self._setup_functions()
-        self.lib.init_module()
-
-        # TX state machine for sending bytes
-        self._tx_shift_reg = 0xFFFF  # Idle high
-        self._tx_bit_counter = 0
-        self._tx_cycle_counter = 0
-        self._tx_transmitting = False
-        self._tx_queue = []
-
-        # RX state machine for receiving bytes
-        self._rx_state = 0  # 0=idle, 1=start, 2=data, 3=stop
-        self._rx_bit_counter = 0
-        self._rx_cycle_counter = 0
-        self._rx_shift_reg = 0
-        self._rx_received = []
+        self._sampling = None
+        self.handle = self.lib.create_instance(threads)
 
     def _setup_functions(self):
         """Define C function signatures."""
         # Lifecycle
-        self.lib.init_module.argtypes = []
-        self.lib.init_module.restype = None
-        self.lib.cleanup_module.argtypes = []
-        self.lib.cleanup_module.restype = None
+        self.lib.create_instance.argtypes = [ctypes.c_uint32]
+        self.lib.create_instance.restype = ctypes.c_void_p
+        self.lib.destroy_instance.argtypes = [ctypes.c_void_p]
+        self.lib.destroy_instance.restype = None
+        self.lib.reset_dut.argtypes = [ctypes.c_void_p]
+        self.lib.reset_dut.restype = None
 
         # Waveform control
-        self.lib.enable_waveform.argtypes = [ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
+        self.lib.enable_waveform.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
         self.lib.enable_waveform.restype = None
-        self.lib.disable_waveform.argtypes = []
+        self.lib.disable_waveform.argtypes = [ctypes.c_void_p]
         self.lib.disable_waveform.restype = None
+        self.lib.has_waveform_support.argtypes = []
+        self.lib.has_waveform_support.restype = ctypes.c_uint8
+        self._setup_signal_functions()
+
+        # Checkpoints
+        self.lib.save_checkpoint.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        self.lib.save_checkpoint.restype = ctypes.c_uint8
+        self.lib.restore_checkpoint.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        self.lib.restore_checkpoint.restype = ctypes.c_uint8
 
         # Clock
-        self.lib.clock_cycle.argtypes = []
+        self.lib.clock_cycle.argtypes = [ctypes.c_void_p]
         self.lib.clock_cycle.restype = None
-        self.lib.clock_n.argtypes = [ctypes.c_uint32]
+        self.lib.clock_n.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
         self.lib.clock_n.restype = None
 
         # UART signals
-        self.lib.set_uart_rx.argtypes = [ctypes.c_uint8]
+        self.lib.set_uart_rx.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_uart_rx.restype = None
-        self.lib.get_uart_tx.argtypes = []
+        self.lib.get_uart_tx.argtypes = [ctypes.c_void_p]
         self.lib.get_uart_tx.restype = ctypes.c_uint8
 
         # Flow control
-        self.lib.get_tx_ready.argtypes = []
+        self.lib.get_tx_ready.argtypes = [ctypes.c_void_p]
         self.lib.get_tx_ready.restype = ctypes.c_uint8
-        self.lib.get_tx_overflow.argtypes = []
+        self.lib.get_tx_overflow.argtypes = [ctypes.c_void_p]
         self.lib.get_tx_overflow.restype = ctypes.c_uint8
-        self.lib.get_rx_valid.argtypes = []
+        self.lib.get_rx_valid.argtypes = [ctypes.c_void_p]
         self.lib.get_rx_valid.restype = ctypes.c_uint8
-        self.lib.get_rx_overflow.argtypes = []
+        self.lib.get_rx_overflow.argtypes = [ctypes.c_void_p]
         self.lib.get_rx_overflow.restype = ctypes.c_uint8
 
         # Status
-        self.lib.get_processing.argtypes = []
+        self.lib.get_processing.argtypes = [ctypes.c_void_p]
         self.lib.get_processing.restype = ctypes.c_uint8
-        self.lib.get_done.argtypes = []
+        self.lib.get_done.argtypes = [ctypes.c_void_p]
         self.lib.get_done.restype = ctypes.c_uint8
 
         # Convenience
-        self.lib.run_until_done.argtypes = [ctypes.c_uint64]
+        self.lib.run_until_done.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
         self.lib.run_until_done.restype = ctypes.c_uint64
+        self.lib.run_until_event.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint32,
+                                             ctypes.POINTER(ctypes.c_uint32)]
+        self.lib.run_until_event.restype = ctypes.c_uint64
+        self.lib.run_polygon.argtypes = [
+            ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t,
+            ctypes.c_char_p, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t),
+            ctypes.c_uint32, ctypes.c_uint64, ctypes.c_uint8,
+        ]
+        self.lib.run_polygon.restype = ctypes.c_uint64
 
     def __del__(self):
         """Cleanup on destruction."""
-        if hasattr(self, 'lib'):
-            self.lib.cleanup_module()
+        if getattr(self, 'handle', None):
+            self.lib.destroy_instance(self.handle)
+            self.handle = None
 
     # =========================================================================
     # Waveform control
@@ -119,100 +145,59 @@ class UartBridge:
             from_cycle: Start capturing from this cycle (default 0)
             to_cycle: Stop capturing at this cycle (default: unlimited)
         """
+        if not self.lib.has_waveform_support():
+            raise RuntimeError("Library built without tracing; create with trace=True")
         if to_cycle is None:
             to_cycle = 0xFFFFFFFFFFFFFFFF  # UINT64_MAX
-        self.lib.enable_waveform(filename.encode(), from_cycle, to_cycle)
+        self.lib.enable_waveform(self.handle, filename.encode(), from_cycle, to_cycle)
 
     def disable_waveform(self):
         """Disable waveform capture and close the file."""
-        self.lib.disable_waveform()
+        self.lib.disable_waveform(self.handle)
 
     # =========================================================================
-    # UART TX State Machine (Testbench -> DUT)
+    # Checkpoints
     # =========================================================================
 
-    def _tx_enqueue(self, byte):
-        """Queue a byte for transmission."""
-        self._tx_queue.append(byte)
-
-    def _tx_tick(self):
-        """Process one clock cycle of TX state machine.
+    def save_checkpoint(self, path):
+        """Save the full model state and cycle count to a file.
 
-        Returns:
-            Current TX line value (0 or 1)
+        Requires a library built from a --savable model (the Makefile
+        default for this module). Waveform state is not saved.
         """
-        # Start new transmission if idle and have data
-        if not self._tx_transmitting and self._tx_queue:
-            byte = self._tx_queue.pop(0)
-            # Build frame: [stop=1][data][start=0]
-            self._tx_shift_reg = (1 << 9) | (byte << 1) | 0
-            self._tx_bit_counter = 10  # 1 start + 8 data + 1 stop
-            self._tx_cycle_counter = self.BAUD_DIV
-            self._tx_transmitting = True
-
-        output = 1  # Idle high
-
-        if self._tx_transmitting:
-            output = self._tx_shift_reg & 1
-            self._tx_cycle_counter -= 1
-            if self._tx_cycle_counter == 0:
-                self._tx_shift_reg >>= 1
-                self._tx_shift_reg |= (1 << 15)  # Shift in 1s
-                self._tx_bit_counter -= 1
-                self._tx_cycle_counter = self.BAUD_DIV
-                if self._tx_bit_counter == 0:
-                    self._tx_transmitting = False
-
-        return output
+        if not self.lib.save_checkpoint(self.handle, path.encode()):
+            raise RuntimeError(f"Failed to save checkpoint: {path}")
+
+    def restore_checkpoint(self, path):
+        """Restore a checkpoint saved by the same library build."""
+        if not os.path.exists(path):
+            raise FileNotFoundError(f"Checkpoint not found: {path}")
+        if not self.lib.restore_checkpoint(self.handle, path.encode()):
+            raise RuntimeError(f"Failed to restore checkpoint: {path}")
 
     # =========================================================================
-    # UART RX State Machine (DUT -> Testbench)
+    # Event-driven stepping
     # =========================================================================
 
-    def _rx_tick(self, rx_bit):
-        """Process one clock cycle of RX state machine.
+    def run_until_event(self, mask=None, max_cycles=None):
+        """Clock natively until a watched output changes level.
+
+        uart_rx holds its current level while running.
 
         Args:
-            rx_bit: Current RX line value
+            mask: OR of EVENT_* bits to watch (default: EVENT_ALL)
+            max_cycles: Maximum cycles to run (default: BAUD_DIV * 15)
 
         Returns:
-            Received byte if complete, None otherwise
+            Tuple of (cycles_taken, fired_mask); fired_mask is 0 on timeout
         """
-        result = None
-
-        if self._rx_state == 0:  # Idle - wait for start bit
-            if rx_bit == 0:
-                self._rx_state = 1
-                self._rx_cycle_counter = self.BAUD_DIV // 2  # Sample at midpoint
-
-        elif self._rx_state == 1:  # Start bit verification
-            self._rx_cycle_counter -= 1
-            if self._rx_cycle_counter == 0:
-                if rx_bit == 0:
-                    self._rx_state = 2
-                    self._rx_bit_counter = 0
-                    self._rx_cycle_counter = self.BAUD_DIV
-                    self._rx_shift_reg = 0
-                else:
-                    self._rx_state = 0  # False start
-
-        elif self._rx_state == 2:  # Data bits
-            self._rx_cycle_counter -= 1
-            if self._rx_cycle_counter == 0:
-                self._rx_shift_reg = (self._rx_shift_reg >> 1) | (rx_bit << 7)
-                self._rx_bit_counter += 1
-                self._rx_cycle_counter = self.BAUD_DIV
-                if self._rx_bit_counter == 8:
-                    self._rx_state = 3
-
-        elif self._rx_state == 3:  # Stop bit
-            self._rx_cycle_counter -= 1
-            if self._rx_cycle_counter == 0:
-                if rx_bit == 1:
-                    result = self._rx_shift_reg
-                self._rx_state = 0
-
-        return result
+        if mask is None:
+            mask = self.EVENT_ALL
+        if max_cycles is None:
+            max_cycles = self.BAUD_DIV * 15
+        fired = ctypes.c_uint32(0)
+        cycles = self.lib.run_until_event(self.handle, max_cycles, mask, ctypes.byref(fired))
+        return cycles, fired.value
 
     # =========================================================================
     # Properties
@@ -221,30 +206,38 @@ class UartBridge:
     @property
     def processing(self):
         """True if module is processing."""
-        return bool(self.lib.get_processing())
+        return bool(self.lib.get_processing(self.handle))
 
     @property
     def done(self):
         """True if processing is complete."""
-        return bool(self.lib.get_done())
+        return bool(self.lib.get_done(self.handle))
 
     @property
     def tx_ready(self):
         """True if TX FIFO can accept data."""
-        return bool(self.lib.get_tx_ready())
+        return bool(self.lib.get_tx_ready(self.handle))
 
     @property
     def rx_valid(self):
         """True if RX FIFO has data."""
-        return bool(self.lib.get_rx_valid())
+        return bool(self.lib.get_rx_valid(self.handle))
 
     # =========================================================================
     # High-level API
     # =========================================================================
 
+    def reset(self):
+        """Reset the model in place; much cheaper than a new UartBridge."""
+        self.lib.reset_dut(self.handle)
+
     def process_polygon(self, input_data, max_cycles=50_000_000_000, verbose=False):
         """Process a polygon via UART and return the result.
 
+        The host-side UART serializer/deserializer runs inside the wrapper,
+        so the whole exchange (including the output drain window) is a
+        single native call.
+
         Args:
             input_data: String of polygon vertices (x,y per line)
             max_cycles: Maximum simulation cycles
@@ -253,58 +246,37 @@ class UartBridge:
         Returns:
             Tuple of (result_string, cycles_taken)
         """
-        # Queue all input data
-        for c in input_data:
-            self._tx_enqueue(ord(c))
         # Add null terminator
-        self._tx_enqueue(0)
-
-        # Run simulation
-        output = []
-        cycles = 0
-        last_progress = 0
-
-        while cycles < max_cycles:
-            # Drive RX input from TX state machine
-            tx_bit = self._tx_tick()
-            self.lib.set_uart_rx(tx_bit)
-
-            # Clock the DUT
-            self.lib.clock_cycle()
-
-            # Sample TX output and process through RX state machine
-            rx_bit = self.lib.get_uart_tx()
-            received = self._rx_tick(rx_bit)
-            if received is not None:
-                c = chr(received)
-                if c not in '\r\n':
-                    output.append(c)
-
-            cycles += 1
-
-            # Check for done
-            if self.done and not self._tx_transmitting and not self._tx_queue:
-                # Wait for all remaining output (max 14 bytes: 13 digits + newline)
-                # Each byte takes BAUD_DIV * 10 cycles, so wait BAUD_DIV * 150
-                for _ in range(self.BAUD_DIV * 150):
-                    self.lib.set_uart_rx(1)  # Idle
-                    self.lib.clock_cycle()
-                    rx_bit = self.lib.get_uart_tx()
-                    received = self._rx_tick(rx_bit)
-                    if received is not None:
-                        c = chr(received)
-                        if c not in '\r\n':
-                            output.append(c)
-                    cycles += 1
-                break
-
-            # Progress update
-            if verbose and cycles - last_progress >= 10_000_000:
-                print(f"Cycle {cycles // 1_000_000}M, TX pending: {len(self._tx_queue)}, "
-                      f"output len: {len(output)}", file=sys.stderr)
-                last_progress = cycles
-
-        return ''.join(output), cycles
+        data = input_data.encode() + b'\0'
+
+        output = ctypes.create_string_buffer(self.OUTPUT_BUFFER_SIZE)
+        output_len = ctypes.c_size_t(0)
+
+        cycles = self.lib.run_polygon(self.handle, data, len(data),
+                                      output, len(output), ctypes.byref(output_len),
+                                      self.BAUD_DIV, max_cycles, 1 if verbose else 0)
+
+        result = output.raw[:output_len.value].decode('latin-1')
+        return ''.join(c for c in result if c not in '\r\n'), cycles
+
+    def process_polygons(self, inputs, max_cycles=50_000_000_000):
+        """Process several polygons back to back on this instance.
+
+        The model is reset between polygons instead of being rebuilt.
+
+        Args:
+            inputs: Iterable of input strings, as for process_polygon
+            max_cycles: Maximum simulation cycles per polygon
+
+        Returns:
+            List of (result_string, cycles_taken) tuples
+        """
+        results = []
+        for k, input_data in enumerate(inputs):
+            if k:
+                self.reset()
+            results.append(self.process_polygon(input_data, max_cycles))
+        return results
 
 
 # =============================================================================
@@ -342,7 +314,7 @@ def main():
     print(f"Input bytes: {len(input_data)}", file=sys.stderr)
 
     # Create bridge and run
-    bridge = UartBridge()
+    bridge = UartBridge(trace=bool(args.waveform))
 
     # Enable waveform if requested
     if args.waveform:
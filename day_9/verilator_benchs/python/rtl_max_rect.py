@@ -5,7 +5,7 @@ Python ctypes wrapper for rtl_max_rect (MaxRectangleFinder) Verilator module.
 Usage:
     from rtl_max_rect import MaxRectangleFinder
 
-    finder = MaxRectangleFinder()
+    finder = MaxRectangleFinder(trace=bool(args.waveform))
     finder.load_polygon([(0, 0), (100, 0), (100, 100), (0, 100)])
     finder.start_search()
     finder.wait_done()
@@ -15,102 +15,244 @@ Usage:
 import ctypes
 import os
 import sys
+import time
 
+from sim_signals import SimSignalsMixin
 
-class MaxRectangleFinder:
+
+class MaxRectangleFinder(SimSignalsMixin):
     """Python wrapper for MaxRectangleFinder RTL simulation via Verilator."""
 
-    def __init__(self, lib_path=None):
+    # FSM state encoding (debug_state), in declaration order of the RTL FSM
+    FSM_STATES = [
+        "IDLE", "LOAD_VERTICES", "WAIT_START", "LOAD_POLY_ONCE",
+        "INIT_SEARCH", "FETCH_J", "REGISTER_PAIR", "GENERATE_RECT",
+        "VALIDATE_WAIT", "NEXT_RECT", "FETCH_I", "COMPLETE",
+    ]
+    NUM_FSM_STATES = 16  # debug_state is 4 bits
+
+    def __init__(self, lib_path=None, threads=0, trace=False, lanes=1, edges=1,
+                 area_order=False, edge_index=0, preload=False, cache_lines=0):
         """Initialize the Verilator module wrapper.
 
         Args:
             lib_path: Path to shared library. If None, uses default location.
+            threads: Simulation threads for --threads builds (0 = default)
+            trace: Load the traced library (required for enable_waveform).
+                Otherwise the default is the trace-free librtl_max_rect_notrace.so,
+                falling back to the traced library if it has not been built.
+            lanes: With lib_path None and lanes > 1, load the trace-free
+                validator-lane build librtl_max_rect_l<lanes>_notrace.so
+            edges: With lib_path None and edges > 1, load the trace-free
+                multi-edge build librtl_max_rect_e<edges>_notrace.so
+            area_order: With lib_path None, load the trace-free
+                area-descending search build librtl_max_rect_ao_notrace.so
+            edge_index: With lib_path None and edge_index > 0, load the
+                trace-free edge-index build librtl_max_rect_x<edge_index>_notrace.so
+            preload: With lib_path None, load the trace-free backdoor preload
+                build librtl_max_rect_pl_notrace.so (see preload_polygon)
+            cache_lines: With lib_path None and cache_lines > 0, load the
+                trace-free external-memory build librtl_max_rect_c<cache_lines>_notrace.so
+                (see configure_dram)
         """
-        if lib_path is None:
-            lib_path = os.path.join(
-                os.path.dirname(__file__),
-                "../lib/librtl_max_rect.so"
-            )
+        if lib_path is None and ((lanes > 1) + (edges > 1) + bool(area_order) + bool(edge_index)
+                                 + bool(preload) + bool(cache_lines)) > 1:
+            raise ValueError("No combined lanes/edges/area-order/edge-index/preload/external build; "
+                             "pass lib_path")
+        if lib_path is None and lanes > 1:
+            lib_path = os.path.join(os.path.dirname(__file__), "../lib",
+                                    f"librtl_max_rect_l{lanes}_notrace.so")
+        elif lib_path is None and edges > 1:
+            lib_path = os.path.join(os.path.dirname(__file__), "../lib",
+                                    f"librtl_max_rect_e{edges}_notrace.so")
+        elif lib_path is None and edge_index:
+            lib_path = os.path.join(os.path.dirname(__file__), "../lib",
+                                    f"librtl_max_rect_x{edge_index}_notrace.so")
+        elif lib_path is None and area_order:
+            lib_path = os.path.join(os.path.dirname(__file__), "../lib",
+                                    "librtl_max_rect_ao_notrace.so")
+        elif lib_path is None and preload:
+            lib_path = os.path.join(os.path.dirname(__file__), "../lib",
+                                    "librtl_max_rect_pl_notrace.so")
+        elif lib_path is None and cache_lines:
+            lib_path = os.path.join(os.path.dirname(__file__), "../lib",
+                                    f"librtl_max_rect_c{cache_lines}_notrace.so")
+        elif lib_path is None:
+            lib_dir = os.path.join(os.path.dirname(__file__), "../lib")
+            lib_path = os.path.join(lib_dir, "librtl_max_rect.so")
+            notrace_path = os.path.join(lib_dir, "librtl_max_rect_notrace.so")
+            if not trace and os.path.exists(notrace_path):
+                lib_path = notrace_path
 
         if not os.path.exists(lib_path):
             raise FileNotFoundError(f"Shared library not found: {lib_path}")
 
         self.lib = ctypes.CDLL(lib_path)
         self._setup_functions()
-        self.lib.init_module()
+        self._sampling = None
+        self.handle = self.lib.create_instance(threads)
 
     def _setup_functions(self):
         """Define C function signatures."""
         # Lifecycle
-        self.lib.init_module.argtypes = []
-        self.lib.init_module.restype = None
-        self.lib.cleanup_module.argtypes = []
-        self.lib.cleanup_module.restype = None
+        self.lib.create_instance.argtypes = [ctypes.c_uint32]
+        self.lib.create_instance.restype = ctypes.c_void_p
+        self.lib.destroy_instance.argtypes = [ctypes.c_void_p]
+        self.lib.destroy_instance.restype = None
+        self.lib.reset_dut.argtypes = [ctypes.c_void_p]
+        self.lib.reset_dut.restype = ctypes.c_uint8
 
         # Waveform control
-        self.lib.enable_waveform.argtypes = [ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
+        self.lib.enable_waveform.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
         self.lib.enable_waveform.restype = None
-        self.lib.disable_waveform.argtypes = []
+        self.lib.disable_waveform.argtypes = [ctypes.c_void_p]
         self.lib.disable_waveform.restype = None
+        self.lib.has_waveform_support.argtypes = []
+        self.lib.has_waveform_support.restype = ctypes.c_uint8
+        self._setup_signal_functions()
+
+        # Checkpoints
+        self.lib.save_checkpoint.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        self.lib.save_checkpoint.restype = ctypes.c_uint8
+        self.lib.restore_checkpoint.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        self.lib.restore_checkpoint.restype = ctypes.c_uint8
 
         # Clock
-        self.lib.clock_cycle.argtypes = []
+        self.lib.clock_cycle.argtypes = [ctypes.c_void_p]
         self.lib.clock_cycle.restype = None
-        self.lib.clock_n.argtypes = [ctypes.c_uint32]
+        self.lib.clock_n.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
         self.lib.clock_n.restype = None
-        self.lib.get_cycle_count.argtypes = []
+        self.lib.get_cycle_count.argtypes = [ctypes.c_void_p]
         self.lib.get_cycle_count.restype = ctypes.c_uint64
 
         # Input signals
-        self.lib.set_vertex_x.argtypes = [ctypes.c_uint32]
+        self.lib.set_vertex_x.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
         self.lib.set_vertex_x.restype = None
-        self.lib.set_vertex_y.argtypes = [ctypes.c_uint32]
+        self.lib.set_vertex_y.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
         self.lib.set_vertex_y.restype = None
-        self.lib.set_vertex_valid.argtypes = [ctypes.c_uint8]
+        self.lib.set_vertex_valid.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_vertex_valid.restype = None
-        self.lib.set_vertex_last.argtypes = [ctypes.c_uint8]
+        self.lib.set_vertex_last.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_vertex_last.restype = None
-        self.lib.set_start_search.argtypes = [ctypes.c_uint8]
+        self.lib.set_start_search.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
         self.lib.set_start_search.restype = None
 
         # Output signals
-        self.lib.get_busy.argtypes = []
+        self.lib.get_busy.argtypes = [ctypes.c_void_p]
         self.lib.get_busy.restype = ctypes.c_uint8
-        self.lib.get_done.argtypes = []
+        self.lib.get_done.argtypes = [ctypes.c_void_p]
         self.lib.get_done.restype = ctypes.c_uint8
-        self.lib.get_valid.argtypes = []
+        self.lib.get_valid.argtypes = [ctypes.c_void_p]
         self.lib.get_valid.restype = ctypes.c_uint8
-        self.lib.get_max_area.argtypes = []
+        self.lib.get_max_area.argtypes = [ctypes.c_void_p]
         self.lib.get_max_area.restype = ctypes.c_uint64
-        self.lib.get_rectangles_tested.argtypes = []
+        self.lib.get_rectangles_tested.argtypes = [ctypes.c_void_p]
         self.lib.get_rectangles_tested.restype = ctypes.c_uint32
-        self.lib.get_rectangles_pruned.argtypes = []
+        self.lib.get_rectangles_pruned.argtypes = [ctypes.c_void_p]
         self.lib.get_rectangles_pruned.restype = ctypes.c_uint32
-        self.lib.get_vertices_loaded.argtypes = []
+        self.lib.get_vertices_loaded.argtypes = [ctypes.c_void_p]
         self.lib.get_vertices_loaded.restype = ctypes.c_uint32
-        self.lib.get_validation_cycles.argtypes = []
+        self.lib.get_validation_cycles.argtypes = [ctypes.c_void_p]
         self.lib.get_validation_cycles.restype = ctypes.c_uint32
-        self.lib.get_debug_state.argtypes = []
+        self.lib.get_debug_state.argtypes = [ctypes.c_void_p]
         self.lib.get_debug_state.restype = ctypes.c_uint8
-        self.lib.get_debug_num_vertices.argtypes = []
+        self.lib.get_debug_num_vertices.argtypes = [ctypes.c_void_p]
         self.lib.get_debug_num_vertices.restype = ctypes.c_uint32
-        self.lib.get_debug_rect_count.argtypes = []
+        self.lib.get_debug_rect_count.argtypes = [ctypes.c_void_p]
         self.lib.get_debug_rect_count.restype = ctypes.c_uint32
-        self.lib.get_debug_max_area.argtypes = []
+        self.lib.get_debug_max_area.argtypes = [ctypes.c_void_p]
         self.lib.get_debug_max_area.restype = ctypes.c_uint64
 
         # Convenience functions
-        self.lib.load_vertex.argtypes = [ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint8]
+        self.lib.load_vertex.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint8]
         self.lib.load_vertex.restype = None
-        self.lib.start_search.argtypes = []
+        self.lib.load_vertices.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32]
+        self.lib.load_vertices.restype = None
+        self.lib.has_preload_support.argtypes = []
+        self.lib.has_preload_support.restype = ctypes.c_uint8
+        self.lib.preload_vertices.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32]
+        self.lib.preload_vertices.restype = ctypes.c_uint8
+        self.lib.start_search.argtypes = [ctypes.c_void_p]
         self.lib.start_search.restype = None
-        self.lib.run_until_done.argtypes = [ctypes.c_uint64]
+        self.lib.run_until_done.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
         self.lib.run_until_done.restype = ctypes.c_uint64
+        self.lib.run_until_done_profiled.argtypes = [ctypes.c_void_p, ctypes.c_uint64,
+                                                     ctypes.POINTER(ctypes.c_uint64)]
+        self.lib.run_until_done_profiled.restype = ctypes.c_uint64
+
+        # Background run
+        self.lib.start_async.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+        self.lib.start_async.restype = ctypes.c_uint8
+        self.lib.get_async_running.argtypes = [ctypes.c_void_p]
+        self.lib.get_async_running.restype = ctypes.c_uint8
+        self.lib.get_async_progress.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint32]
+        self.lib.get_async_progress.restype = ctypes.c_uint32
+        self.lib.cancel_async.argtypes = [ctypes.c_void_p]
+        self.lib.cancel_async.restype = None
+        self.lib.wait_async.argtypes = [ctypes.c_void_p]
+        self.lib.wait_async.restype = ctypes.c_uint64
+
+        # Job queue
+        self.lib.run_jobs.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint32),
+                                      ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32,
+                                      ctypes.c_uint64, ctypes.POINTER(ctypes.c_uint64)]
+        self.lib.run_jobs.restype = ctypes.c_uint32
+
+        # FSM state profile
+        self.lib.enable_state_profile.argtypes = [ctypes.c_void_p, ctypes.c_uint8]
+        self.lib.enable_state_profile.restype = None
+        self.lib.reset_state_profile.argtypes = [ctypes.c_void_p]
+        self.lib.reset_state_profile.restype = None
+        self.lib.get_state_profile.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint32]
+        self.lib.get_state_profile.restype = ctypes.c_uint32
+        self.lib.get_num_lanes.argtypes = []
+        self.lib.get_num_lanes.restype = ctypes.c_uint32
+        self.lib.get_lane_busy_cycles.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64),
+                                                  ctypes.c_uint32]
+        self.lib.get_lane_busy_cycles.restype = ctypes.c_uint32
+        self.lib.has_verdict_ports.argtypes = []
+        self.lib.has_verdict_ports.restype = ctypes.c_uint8
+        self.lib.get_verdict_stats.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64),
+                                               ctypes.c_uint32]
+        self.lib.get_verdict_stats.restype = ctypes.c_uint32
+        self.lib.get_edges_examined.argtypes = [ctypes.c_void_p]
+        self.lib.get_edges_examined.restype = ctypes.c_uint32
+        self.lib.get_edges_skipped.argtypes = [ctypes.c_void_p]
+        self.lib.get_edges_skipped.restype = ctypes.c_uint32
+
+        # External vertex memory
+        self.lib.has_external_memory.argtypes = []
+        self.lib.has_external_memory.restype = ctypes.c_uint8
+        self.lib.configure_dram.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32]
+        self.lib.configure_dram.restype = None
+        self.lib.get_cache_accesses.argtypes = [ctypes.c_void_p]
+        self.lib.get_cache_accesses.restype = ctypes.c_uint32
+        self.lib.get_cache_misses.argtypes = [ctypes.c_void_p]
+        self.lib.get_cache_misses.restype = ctypes.c_uint32
+        self.lib.get_cache_stall_cycles.argtypes = [ctypes.c_void_p]
+        self.lib.get_cache_stall_cycles.restype = ctypes.c_uint32
+        self.lib.get_dram_bursts.argtypes = [ctypes.c_void_p]
+        self.lib.get_dram_bursts.restype = ctypes.c_uint64
+        self.lib.get_dram_busy_cycles.argtypes = [ctypes.c_void_p]
+        self.lib.get_dram_busy_cycles.restype = ctypes.c_uint64
+
+        # Validator scoreboard
+        self.lib.enable_scoreboard.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint32),
+                                               ctypes.c_uint32, ctypes.c_uint8]
+        self.lib.enable_scoreboard.restype = ctypes.c_uint8
+        self.lib.disable_scoreboard.argtypes = [ctypes.c_void_p]
+        self.lib.disable_scoreboard.restype = None
+        self.lib.get_scoreboard_checked.argtypes = [ctypes.c_void_p]
+        self.lib.get_scoreboard_checked.restype = ctypes.c_uint64
+        self.lib.get_scoreboard_mismatch.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64),
+                                                     ctypes.c_uint32]
+        self.lib.get_scoreboard_mismatch.restype = ctypes.c_uint64
 
     def __del__(self):
         """Cleanup on destruction."""
-        if hasattr(self, 'lib'):
-            self.lib.cleanup_module()
+        if getattr(self, 'handle', None):
+            self.lib.destroy_instance(self.handle)
+            self.handle = None
 
     # =========================================================================
     # Waveform control
@@ -124,13 +266,35 @@ class MaxRectangleFinder:
             from_cycle: Start capturing from this cycle (default 0)
             to_cycle: Stop capturing at this cycle (default: unlimited)
         """
+        if not self.lib.has_waveform_support():
+            raise RuntimeError("Library built without tracing; create with trace=True")
         if to_cycle is None:
             to_cycle = 0xFFFFFFFFFFFFFFFF  # UINT64_MAX
-        self.lib.enable_waveform(filename.encode(), from_cycle, to_cycle)
+        self.lib.enable_waveform(self.handle, filename.encode(), from_cycle, to_cycle)
 
     def disable_waveform(self):
         """Disable waveform capture and close the file."""
-        self.lib.disable_waveform()
+        self.lib.disable_waveform(self.handle)
+
+    # =========================================================================
+    # Checkpoints
+    # =========================================================================
+
+    def save_checkpoint(self, path):
+        """Save the full model state and cycle count to a file.
+
+        Requires a library built from a --savable model (the Makefile
+        default for this module). Waveform state is not saved.
+        """
+        if not self.lib.save_checkpoint(self.handle, path.encode()):
+            raise RuntimeError(f"Failed to save checkpoint: {path}")
+
+    def restore_checkpoint(self, path):
+        """Restore a checkpoint saved by the same library build."""
+        if not os.path.exists(path):
+            raise FileNotFoundError(f"Checkpoint not found: {path}")
+        if not self.lib.restore_checkpoint(self.handle, path.encode()):
+            raise RuntimeError(f"Failed to restore checkpoint: {path}")
 
     # =========================================================================
     # Clock control
@@ -139,14 +303,14 @@ class MaxRectangleFinder:
     def clock(self, n=1):
         """Advance simulation by n clock cycles."""
         if n == 1:
-            self.lib.clock_cycle()
+            self.lib.clock_cycle(self.handle)
         else:
-            self.lib.clock_n(n)
+            self.lib.clock_n(self.handle, n)
 
     @property
     def cycle_count(self):
         """Current simulation cycle count."""
-        return self.lib.get_cycle_count()
+        return self.lib.get_cycle_count(self.handle)
 
     # =========================================================================
     # Vertex loading
@@ -154,17 +318,68 @@ class MaxRectangleFinder:
 
     def load_vertex(self, x, y, last=False):
         """Load a single vertex."""
-        self.lib.load_vertex(x, y, 1 if last else 0)
+        self.lib.load_vertex(self.handle, x, y, 1 if last else 0)
+
+    @staticmethod
+    def _vertex_buffer(vertices):
+        """Return (pointer, count) for an interleaved {x0, y0, x1, y1, ...} buffer."""
+        if hasattr(vertices, 'ctypes'):
+            if vertices.dtype.itemsize != 4 or vertices.dtype.kind != 'u':
+                raise ValueError("vertex array must have dtype uint32")
+            if vertices.ndim != 2 or vertices.shape[1] != 2:
+                raise ValueError("vertex array must have shape (N, 2)")
+            if not vertices.flags['C_CONTIGUOUS']:
+                raise ValueError("vertex array must be C-contiguous")
+            count = vertices.shape[0]
+            buf = vertices.ctypes.data_as(ctypes.POINTER(ctypes.c_uint32))
+        else:
+            count = len(vertices)
+            buf = (ctypes.c_uint32 * (2 * count))()
+            for i, (x, y) in enumerate(vertices):
+                buf[2 * i] = x
+                buf[2 * i + 1] = y
+        return buf, count
 
     def load_polygon(self, vertices):
-        """Load a complete polygon.
+        """Load a complete polygon in a single native call.
+
+        Args:
+            vertices: List of (x, y) tuples, or a C-contiguous uint32 numpy
+                array of shape (N, 2), which is passed without copying
+        """
+        buf, count = self._vertex_buffer(vertices)
+        if count:
+            self.lib.load_vertices(self.handle, buf, count)
+
+    @property
+    def has_preload_support(self):
+        """True if this library can preload polygons (the preload build)."""
+        return bool(self.lib.has_preload_support())
+
+    def preload_polygon(self, vertices):
+        """Write a polygon straight into the vertex BRAMs, taking no cycles.
+
+        Instead of streaming one vertex per cycle, the vertices are written
+        into the finder's and the validators' BRAMs, num_vertices is set and
+        the FSM is put in WAIT_START, so start_search() begins the search
+        without LOAD_POLY_ONCE. Must be called while the FSM is idle (before
+        the first load or after a search completes). Requires the preload
+        build.
 
         Args:
-            vertices: List of (x, y) tuples
+            vertices: As for load_polygon
+
+        Returns:
+            True if the validator BRAMs were preloaded too, False if only the
+            finder's was and LOAD_POLY_ONCE still copies the polygon
         """
-        for i, (x, y) in enumerate(vertices):
-            is_last = (i == len(vertices) - 1)
-            self.load_vertex(x, y, last=is_last)
+        buf, count = self._vertex_buffer(vertices)
+        result = self.lib.preload_vertices(self.handle, buf, count)
+        if not result:
+            raise RuntimeError("preload_vertices failed; the preload build is required, "
+                               "the FSM must be idle and the model must have every preload "
+                               "signal (see stderr)")
+        return result == 2
 
     # =========================================================================
     # Search control
@@ -172,7 +387,7 @@ class MaxRectangleFinder:
 
     def start_search(self):
         """Start the rectangle search."""
-        self.lib.start_search()
+        self.lib.start_search(self.handle)
 
     def wait_done(self, max_cycles=10_000_000_000):
         """Wait for search to complete.
@@ -183,7 +398,287 @@ class MaxRectangleFinder:
         Returns:
             Number of cycles taken
         """
-        return self.lib.run_until_done(max_cycles)
+        return self.lib.run_until_done(self.handle, max_cycles)
+
+    # =========================================================================
+    # Background run
+    # =========================================================================
+
+    ASYNC_PROGRESS_FIELDS = 5
+
+    def start_async(self, max_cycles=10_000_000_000):
+        """Run wait_done(max_cycles) on a native thread and return at once.
+
+        Until the run ends, only progress(), async_running, cancel() and
+        wait_async() may be used on this instance.
+        """
+        if not self.lib.start_async(self.handle, max_cycles):
+            raise RuntimeError("A background run is already in flight")
+
+    @property
+    def async_running(self):
+        """True while a background run is in flight."""
+        return bool(self.lib.get_async_running(self.handle))
+
+    def progress(self):
+        """Progress of the background run, updated every 4096 cycles.
+
+        Returns:
+            Dict with cycles (since start_async), rect_count, max_area,
+            state (FSM state name) and done
+        """
+        buf = (ctypes.c_uint64 * self.ASYNC_PROGRESS_FIELDS)()
+        self.lib.get_async_progress(self.handle, buf, self.ASYNC_PROGRESS_FIELDS)
+        state = buf[3]
+        return {
+            'cycles': buf[0],
+            'rect_count': buf[1],
+            'max_area': buf[2],
+            'state': self.FSM_STATES[state] if state < len(self.FSM_STATES) else f"STATE_{state}",
+            'done': bool(buf[4]),
+        }
+
+    def cancel(self):
+        """Stop the background run within 4096 cycles; the search can be resumed later."""
+        self.lib.cancel_async(self.handle)
+
+    def wait_async(self, timeout=None, poll=0.01):
+        """Wait for the background run to end.
+
+        Args:
+            timeout: Seconds to wait, or None to block until it ends
+            poll: Polling interval with a timeout (seconds)
+
+        Returns:
+            Cycles the run took, or None if it is still running after timeout
+        """
+        if timeout is not None:
+            deadline = time.monotonic() + timeout
+            while self.async_running:
+                if time.monotonic() >= deadline:
+                    return None
+                time.sleep(poll)
+        return self.lib.wait_async(self.handle)
+
+    # =========================================================================
+    # Job queue
+    # =========================================================================
+
+    JOB_RESULT_FIELDS = 9
+
+    def reset(self):
+        """Reset the model in place for the next polygon.
+
+        Much cheaper than a new MaxRectangleFinder: the model, context and
+        any waveform or recorder stay, and the wrapper's counters (state
+        profile, scoreboard tallies, DRAM statistics) are cleared. A
+        polygon passed to enable_scoreboard() is dropped, so the scoreboard
+        follows the next polygon loaded.
+        """
+        if not self.lib.reset_dut(self.handle):
+            raise RuntimeError("A background run is in flight")
+
+    def run_jobs(self, polygons, max_cycles=10_000_000_000):
+        """Run many polygons back to back on this instance in one native call.
+
+        Each polygon gets reset(), a load (preload where the library supports
+        it), start_search() and wait_done(max_cycles).
+
+        Args:
+            polygons: Sequence of vertex lists (as for load_polygon)
+            max_cycles: Maximum search cycles per polygon
+
+        Returns:
+            List of dicts with done, valid, max_area, rectangles_tested,
+            rectangles_pruned, load_cycles, search_cycles, scoreboard_checked
+            and scoreboard_mismatches, one per polygon. The scoreboard
+            counts are per polygon and zero with the scoreboard off.
+            Polygons with fewer than 3 vertices are skipped (done False).
+        """
+        num_jobs = len(polygons)
+        counts = (ctypes.c_uint32 * max(num_jobs, 1))()
+        for k, vertices in enumerate(polygons):
+            counts[k] = len(vertices)
+        xy = (ctypes.c_uint32 * max(2 * sum(counts), 1))()
+        pos = 0
+        for vertices in polygons:
+            for x, y in vertices:
+                xy[pos] = x
+                xy[pos + 1] = y
+                pos += 2
+        out = (ctypes.c_uint64 * (max(num_jobs, 1) * self.JOB_RESULT_FIELDS))()
+        self.lib.run_jobs(self.handle, xy, counts, num_jobs, max_cycles, out)
+
+        results = []
+        for k in range(num_jobs):
+            r = out[k * self.JOB_RESULT_FIELDS:(k + 1) * self.JOB_RESULT_FIELDS]
+            results.append({
+                'done': bool(r[0]),
+                'valid': bool(r[1]),
+                'max_area': r[2],
+                'rectangles_tested': r[3],
+                'rectangles_pruned': r[4],
+                'load_cycles': r[5],
+                'search_cycles': r[6],
+                'scoreboard_checked': r[7],
+                'scoreboard_mismatches': r[8],
+            })
+        return results
+
+    # =========================================================================
+    # FSM state profile
+    # =========================================================================
+
+    def enable_state_profile(self, enable=True):
+        """Count cycles spent in, and entries into, each FSM state."""
+        self.lib.enable_state_profile(self.handle, 1 if enable else 0)
+
+    def reset_state_profile(self):
+        """Clear the state profile counters."""
+        self.lib.reset_state_profile(self.handle)
+
+    def state_profile(self):
+        """Return the state profile.
+
+        Returns:
+            Dict mapping state name to (cycles, entries), for states with
+            any recorded cycles
+        """
+        n = self.NUM_FSM_STATES
+        buf = (ctypes.c_uint64 * (2 * n))()
+        self.lib.get_state_profile(self.handle, buf, 2 * n)
+        profile = {}
+        for i in range(n):
+            if buf[i]:
+                name = self.FSM_STATES[i] if i < len(self.FSM_STATES) else f"STATE_{i}"
+                profile[name] = (buf[i], buf[n + i])
+        return profile
+
+    @property
+    def num_lanes(self):
+        """Validator lanes in the loaded model."""
+        return self.lib.get_num_lanes()
+
+    def lane_busy_cycles(self):
+        """Return the cycles each validator lane was busy, as a list.
+
+        Counted while the state profile is enabled, cleared by
+        reset_state_profile().
+        """
+        n = self.num_lanes
+        buf = (ctypes.c_uint64 * n)()
+        self.lib.get_lane_busy_cycles(self.handle, buf, n)
+        return list(buf)
+
+    VERDICT_OUTCOMES = ('valid', 'check1_fail', 'check2_fail', 'corner_fail')
+    NUM_LATENCY_BUCKETS = 32
+    NUM_EXIT_BINS = 16
+
+    @property
+    def has_verdict_ports(self):
+        """True if the model reports verdicts (verdict_stats, scoreboard).
+
+        False for multi-lane models, and for a netlist generated from RTL
+        older than the verdict ports.
+        """
+        return bool(self.lib.has_verdict_ports())
+
+    def verdict_stats(self):
+        """Return per-candidate validation statistics.
+
+        Counted while the state profile is enabled, cleared by
+        reset_state_profile(). All zero without verdict ports.
+
+        Returns:
+            Dict keyed by VERDICT_OUTCOMES, each with count, cycles (total)
+            and latency (NUM_LATENCY_BUCKETS counts, bucket b holding
+            validations of [2**(b-1), 2**b) cycles), plus 'exit' with
+            check1_fail / check2_fail (NUM_EXIT_BINS counts of where in the
+            edge walk the rejection happened, as a fraction of the polygon),
+            edges_walked and full_scan_edges (what the same rejections
+            would have cost without early exit, num_vertices + 1 edges
+            each as the validator walks the start edge twice)
+        """
+        n = self.lib.get_verdict_stats(self.handle, None, 0)
+        buf = (ctypes.c_uint64 * n)()
+        self.lib.get_verdict_stats(self.handle, buf, n)
+        k = len(self.VERDICT_OUTCOMES)
+        b = self.NUM_LATENCY_BUCKETS
+        e = self.NUM_EXIT_BINS
+        stats = {}
+        for i, name in enumerate(self.VERDICT_OUTCOMES):
+            base = 2 * k + i * b
+            stats[name] = {'count': buf[i], 'cycles': buf[k + i], 'latency': list(buf[base:base + b])}
+        base = 2 * k + k * b
+        stats['exit'] = {
+            'check1_fail': list(buf[base:base + e]),
+            'check2_fail': list(buf[base + e:base + 2 * e]),
+            'edges_walked': buf[base + 2 * e],
+            'full_scan_edges': buf[base + 2 * e + 1],
+        }
+        return stats
+
+    # =========================================================================
+    # Validator scoreboard
+    # =========================================================================
+
+    MISMATCH_FIELDS = ('cycle', 'kind', 'i', 'j', 'rect_x', 'rect_y',
+                       'rect_width', 'rect_height', 'expected', 'got')
+    MISMATCH_KINDS = {1: 'verdict', 2: 'dispatch', 3: 'pass', 4: 'fail_edge'}
+
+    def enable_scoreboard(self, polygon=None, stop_on_mismatch=True):
+        """Check every validator verdict against the native reference.
+
+        Each candidate the DUT generates is validated in C++ as well, with
+        the hardware validator's semantics and the finder's start-vertex
+        hint, and the DUT's skip/prune/validate decision, verdict_outcome
+        and (for CHECK 1/2 exits) fail edge are compared with it. The first
+        mismatch is printed (with a flight recorder dump if one is enabled).
+        Needs a single-lane model with verdict ports (has_verdict_ports).
+
+        Args:
+            polygon: List of (x, y) tuples in DUT coordinates; if None, the
+                polygon loaded through load_vertex()/load_polygon() is used.
+                reset() and run_jobs() drop it for the loaded polygon
+            stop_on_mismatch: Make wait_done() return at the first mismatch
+        """
+        buf, count = None, 0
+        if polygon is not None:
+            count = len(polygon)
+            buf = (ctypes.c_uint32 * (2 * count))()
+            for i, (x, y) in enumerate(polygon):
+                buf[2 * i] = x
+                buf[2 * i + 1] = y
+        if not self.lib.enable_scoreboard(self.handle, buf, count, 1 if stop_on_mismatch else 0):
+            raise RuntimeError("Scoreboard needs a single-lane model with verdict ports (see stderr)")
+
+    def disable_scoreboard(self):
+        """Stop checking verdicts."""
+        self.lib.disable_scoreboard(self.handle)
+
+    def scoreboard_result(self):
+        """Return the scoreboard counters.
+
+        Returns:
+            Dict with 'checked' (verdicts compared), 'mismatches', and 'first'
+            (dict of MISMATCH_FIELDS for the first mismatch, or None). For
+            verdict mismatches expected/got are VERDICT_OUTCOMES names.
+        """
+        n = len(self.MISMATCH_FIELDS)
+        buf = (ctypes.c_uint64 * n)()
+        mismatches = self.lib.get_scoreboard_mismatch(self.handle, buf, n)
+        first = None
+        if mismatches:
+            first = dict(zip(self.MISMATCH_FIELDS, buf))
+            first['kind'] = self.MISMATCH_KINDS.get(first['kind'], first['kind'])
+            if first['kind'] == 'verdict':
+                for key in ('expected', 'got'):
+                    first[key] = self.VERDICT_OUTCOMES[first[key] % len(self.VERDICT_OUTCOMES)]
+        return {
+            'checked': self.lib.get_scoreboard_checked(self.handle),
+            'mismatches': mismatches,
+            'first': first,
+        }
 
     # =========================================================================
     # Properties
@@ -192,42 +687,88 @@ class MaxRectangleFinder:
     @property
     def busy(self):
         """True if module is busy."""
-        return bool(self.lib.get_busy())
+        return bool(self.lib.get_busy(self.handle))
 
     @property
     def done(self):
         """True if search is complete."""
-        return bool(self.lib.get_done())
+        return bool(self.lib.get_done(self.handle))
 
     @property
     def valid(self):
         """True if a valid rectangle was found."""
-        return bool(self.lib.get_valid())
+        return bool(self.lib.get_valid(self.handle))
 
     @property
     def max_area(self):
         """Maximum rectangle area found."""
-        return self.lib.get_max_area()
+        return self.lib.get_max_area(self.handle)
 
     @property
     def rectangles_tested(self):
         """Number of rectangles tested."""
-        return self.lib.get_rectangles_tested()
+        return self.lib.get_rectangles_tested(self.handle)
 
     @property
     def rectangles_pruned(self):
         """Number of rectangles pruned."""
-        return self.lib.get_rectangles_pruned()
+        return self.lib.get_rectangles_pruned(self.handle)
 
     @property
     def vertices_loaded(self):
         """Number of vertices loaded."""
-        return self.lib.get_vertices_loaded()
+        return self.lib.get_vertices_loaded(self.handle)
 
     @property
     def validation_cycles(self):
         """Total cycles spent in validation."""
-        return self.lib.get_validation_cycles()
+        return self.lib.get_validation_cycles(self.handle)
+
+    @property
+    def edges_examined(self):
+        """Edges checked by the validators (edge-index builds, else 0)."""
+        return self.lib.get_edges_examined(self.handle)
+
+    @property
+    def edges_skipped(self):
+        """Edges skipped by the validator edge index (edge-index builds, else 0)."""
+        return self.lib.get_edges_skipped(self.handle)
+
+    @property
+    def has_external_memory(self):
+        """True if vertices are fetched from external memory (the external build)."""
+        return bool(self.lib.has_external_memory())
+
+    def configure_dram(self, latency=20, cycles_per_beat=1):
+        """Set the external memory timing: cycles from a burst request to its
+        first vertex, and between the following vertices (external builds)."""
+        self.lib.configure_dram(self.handle, latency, cycles_per_beat)
+
+    @property
+    def cache_accesses(self):
+        """Vertex reads served by the caches since start_search (external builds, else 0)."""
+        return self.lib.get_cache_accesses(self.handle)
+
+    @property
+    def cache_misses(self):
+        """Cache lines fetched from external memory since start_search."""
+        return self.lib.get_cache_misses(self.handle)
+
+    @property
+    def cache_stall_cycles(self):
+        """Cycles the search was frozen waiting for external memory."""
+        return self.lib.get_cache_stall_cycles(self.handle)
+
+    @property
+    def cache_hit_rate(self):
+        """Share of vertex reads that did not miss (0.0 without accesses)."""
+        accesses = self.cache_accesses
+        return 1.0 - self.cache_misses / accesses if accesses else 0.0
+
+    @property
+    def dram_bursts(self):
+        """Bursts served by the external memory model since start_search."""
+        return self.lib.get_dram_bursts(self.handle)
 
 
 # =============================================================================
@@ -249,9 +790,109 @@ def load_polygon_from_file(filepath):
     return vertices
 
 
+def parse_trigger(spec):
+    """Parse SIGNAL:OP[:VALUE] into set_capture_trigger() arguments.
+
+    VALUE may be an integer or, for debug_state, an FSM state name.
+    """
+    parts = spec.split(':')
+    if len(parts) not in (2, 3):
+        raise ValueError(f"Trigger must be SIGNAL:OP[:VALUE], got {spec!r}")
+    signal, op = parts[0], parts[1]
+    value = 0
+    if len(parts) == 3:
+        if signal == 'debug_state' and parts[2] in MaxRectangleFinder.FSM_STATES:
+            value = MaxRectangleFinder.FSM_STATES.index(parts[2])
+        else:
+            value = int(parts[2], 0)
+    return signal, op, value
+
+
+def print_verdict_stats(stats, out=sys.stderr):
+    """Print verdict_stats() as per-outcome latency and early-exit tables."""
+    outcomes = MaxRectangleFinder.VERDICT_OUTCOMES
+    verdicts = sum(stats[name]['count'] for name in outcomes)
+    if not verdicts:
+        return
+    all_cycles = sum(stats[name]['cycles'] for name in outcomes) or 1
+    print(f"\nValidator verdicts:", file=out)
+    print(f"  {'outcome':<12} {'count':>12} {'%':>7} {'cycles':>14} {'% cyc':>7} {'mean':>9}  latency buckets",
+          file=out)
+    for name in outcomes:
+        s = stats[name]
+        if not s['count']:
+            continue
+        buckets = ' '.join(f"<{1 << b}:{c}" for b, c in enumerate(s['latency']) if c)
+        print(f"  {name:<12} {s['count']:>12} {100.0 * s['count'] / verdicts:>6.2f}% "
+              f"{s['cycles']:>14} {100.0 * s['cycles'] / all_cycles:>6.2f}% "
+              f"{s['cycles'] / s['count']:>9.1f}  {buckets}", file=out)
+    ex = stats['exit']
+    if ex['full_scan_edges']:
+        saved = 1.0 - ex['edges_walked'] / ex['full_scan_edges']
+        print(f"  Rejections walked {ex['edges_walked']} of {ex['full_scan_edges']} edges "
+              f"({100.0 * saved:.1f}% saved by early exit)", file=out)
+        bins = len(ex['check1_fail'])
+        print(f"  Exit position by 1/{bins} of the walk:", file=out)
+        for name in ('check1_fail', 'check2_fail'):
+            print(f"    {name:<12} {' '.join(f'{c:>6}' for c in ex[name])}", file=out)
+
+
+def run_with_progress(finder, interval, stop_at_area=None, max_cycles=10_000_000_000):
+    """Search on the background thread, printing progress every interval seconds.
+
+    Cancels the search once max_area reaches stop_at_area.
+
+    Returns:
+        Tuple of (cycles taken, True if cancelled by stop_at_area)
+    """
+    finder.start_async(max_cycles)
+    stopped = False
+    last = time.monotonic()
+    while True:
+        cycles = finder.wait_async(timeout=0.05)
+        if cycles is not None:
+            return cycles, stopped
+        p = finder.progress()
+        if stop_at_area is not None and not stopped and p['max_area'] >= stop_at_area:
+            finder.cancel()
+            stopped = True
+        now = time.monotonic()
+        if interval and now - last >= interval:
+            print(f"  Cycle {p['cycles'] / 1e6:.1f}M: {p['rect_count']} rectangles, "
+                  f"max area {p['max_area']}, {p['state']}", file=sys.stderr)
+            last = now
+
+
+def check_jobs(finder, vertices, max_cycles=10_000_000_000):
+    """Run two different polygons through run_jobs() with the scoreboard on.
+
+    The jobs are the polygon, its mirror image (x flipped, vertex order
+    reversed to keep the orientation) and the polygon again. The scoreboard
+    is enabled with the first polygon, and every job must be checked
+    against its own polygon with no mismatches and the same max_area.
+
+    Returns:
+        True if every job passed
+    """
+    span = min(x for x, _ in vertices) + max(x for x, _ in vertices)
+    mirrored = [(span - x, y) for x, y in reversed(vertices)]
+    finder.enable_scoreboard(vertices, stop_on_mismatch=False)
+    results = finder.run_jobs([vertices, mirrored, vertices], max_cycles)
+    finder.disable_scoreboard()
+
+    ok = True
+    for k, r in enumerate(results):
+        passed = (r['done'] and r['scoreboard_checked'] and not r['scoreboard_mismatches']
+                  and r['max_area'] == results[0]['max_area'])
+        print(f"  Job {k}: max area {r['max_area']}, {r['scoreboard_checked']} verdicts checked, "
+              f"{r['scoreboard_mismatches']} mismatches{'' if passed else ' FAILED'}",
+              file=sys.stderr)
+        ok = ok and passed
+    return ok
+
+
 def main():
     """Run test with optional input file."""
-    import time
     import argparse
 
     parser = argparse.ArgumentParser(description='MaxRectangleFinder Verilator test')
@@ -261,8 +902,60 @@ def main():
                         help='Start waveform capture at this cycle (default: 0)')
     parser.add_argument('--waveform-to-cycle', type=int, default=None,
                         help='Stop waveform capture at this cycle (default: unlimited)')
+    parser.add_argument('--lanes', type=int, default=1,
+                        help='Use the validator-lane build with this many lanes (default: 1)')
+    parser.add_argument('--edges', type=int, default=1,
+                        help='Use the build checking this many edges per cycle (default: 1)')
+    parser.add_argument('--area-order', action='store_true',
+                        help='Use the area-descending search build')
+    parser.add_argument('--edge-index', type=int, default=0, metavar='BLOCK',
+                        help='Use the build with a validator edge index of this block size')
+    parser.add_argument('--preload', action='store_true',
+                        help='Use the preload build and write the polygon into the BRAMs directly')
+    parser.add_argument('--cache-lines', type=int, default=0, metavar='N',
+                        help='Use the external-memory build with N cache lines per port')
+    parser.add_argument('--dram-latency', type=int, default=20,
+                        help='External memory: cycles from request to first vertex (default: 20)')
+    parser.add_argument('--dram-cycles-per-beat', type=int, default=1,
+                        help='External memory: cycles between burst vertices (default: 1)')
+    parser.add_argument('--repeat', type=int, default=1,
+                        help='Load the polygon and run the search this many times (default: 1)')
+    parser.add_argument('--profile-states', action='store_true',
+                        help='Report cycles spent in each FSM state')
+    parser.add_argument('--save-checkpoint', metavar='FILE',
+                        help='Save a checkpoint after the polygon is loaded')
+    parser.add_argument('--restore-checkpoint', metavar='FILE',
+                        help='Start from a saved checkpoint instead of loading the polygon')
+    parser.add_argument('--flight-recorder', metavar='FILE',
+                        help='Record the last cycles in memory and write them to FILE on timeout')
+    parser.add_argument('--flight-recorder-depth', type=int, default=65536,
+                        help='Cycles kept by the flight recorder (default: 65536)')
+    parser.add_argument('--capture', metavar='FILE',
+                        help='Write a window around --trigger to FILE')
+    parser.add_argument('--trigger', metavar='SIGNAL:OP[:VALUE]',
+                        help='Capture start condition, e.g. debug_state:enter:VALIDATE_WAIT '
+                             'or max_area:change')
+    parser.add_argument('--stop-trigger', metavar='SIGNAL:OP[:VALUE]',
+                        help='End the post-trigger window early on this condition')
+    parser.add_argument('--capture-pre', type=int, default=10000,
+                        help='Cycles captured before the trigger (default: 10000)')
+    parser.add_argument('--capture-post', type=int, default=10000,
+                        help='Cycles captured after the trigger (default: 10000)')
+    parser.add_argument('--max-captures', type=int, default=1,
+                        help='Captures to write before disarming, 0 = unlimited (default: 1)')
+    parser.add_argument('--scoreboard', action='store_true',
+                        help='Check every validator verdict against the native reference')
+    parser.add_argument('--progress', type=float, default=0, metavar='SECONDS',
+                        help='Search on a background thread and print progress this often')
+    parser.add_argument('--stop-at-area', type=int, default=None, metavar='AREA',
+                        help='Search on a background thread and stop once max_area reaches AREA')
+    parser.add_argument('--check-jobs', action='store_true',
+                        help='Check run_jobs() on the polygon and its mirror image with the scoreboard on')
     args = parser.parse_args()
 
+    if args.capture and not args.trigger:
+        parser.error("--capture requires --trigger")
+
     # Get input file or use default test
     if args.input_file:
         input_filepath = args.input_file
@@ -279,7 +972,12 @@ def main():
     print(f"Vertices loaded: {len(vertices)}", file=sys.stderr)
 
     # Create finder and run
-    finder = MaxRectangleFinder()
+    finder = MaxRectangleFinder(trace=bool(args.waveform or args.flight_recorder or args.capture),
+                                lanes=args.lanes, edges=args.edges, area_order=args.area_order,
+                                edge_index=args.edge_index, preload=args.preload,
+                                cache_lines=args.cache_lines)
+    if args.cache_lines:
+        finder.configure_dram(args.dram_latency, args.dram_cycles_per_beat)
 
     # Enable waveform if requested
     if args.waveform:
@@ -289,34 +987,128 @@ def main():
                   f"{args.waveform_to_cycle if args.waveform_to_cycle else 'end'}", file=sys.stderr)
         finder.enable_waveform(args.waveform, args.waveform_from_cycle, args.waveform_to_cycle)
 
+    if args.flight_recorder:
+        finder.enable_flight_recorder(args.flight_recorder_depth, args.flight_recorder)
+
+    if args.capture:
+        finder.set_capture_trigger(*parse_trigger(args.trigger))
+        if args.stop_trigger:
+            finder.set_capture_trigger(*parse_trigger(args.stop_trigger), stop=True)
+        finder.enable_triggered_capture(args.capture, args.capture_pre, args.capture_post,
+                                        args.max_captures)
+
+    if args.check_jobs:
+        print("Checking run_jobs() with the scoreboard:", file=sys.stderr)
+        return 0 if check_jobs(finder, vertices) else 1
+
+    if args.profile_states:
+        finder.enable_state_profile()
+
+    if args.scoreboard:
+        finder.enable_scoreboard(vertices)
+
     start_time = time.time()
+    load_cycles = 0
+    search_cycles = []
+    stopped_early = False
 
-    # Load polygon
-    finder.load_polygon(vertices)
-    print(f"Polygon loaded, vertices_loaded={finder.vertices_loaded}", file=sys.stderr)
+    for run in range(max(args.repeat, 1)):
+        # Load polygon, or resume from a checkpoint saved after loading
+        load_start = finder.cycle_count
+        if args.restore_checkpoint and run == 0:
+            finder.restore_checkpoint(args.restore_checkpoint)
+            print(f"Checkpoint restored at cycle {finder.cycle_count}, "
+                  f"vertices_loaded={finder.vertices_loaded}", file=sys.stderr)
+        elif args.preload:
+            full = finder.preload_polygon(vertices)
+            if run == 0:
+                print(f"Polygon preloaded ({'finder and validators' if full else 'finder only'})",
+                      file=sys.stderr)
+        else:
+            finder.load_polygon(vertices)
+            if run == 0:
+                print(f"Polygon loaded, vertices_loaded={finder.vertices_loaded}", file=sys.stderr)
+            if args.save_checkpoint and run == 0:
+                finder.save_checkpoint(args.save_checkpoint)
+                print(f"Checkpoint saved: {args.save_checkpoint}", file=sys.stderr)
+        load_cycles += finder.cycle_count - load_start
 
-    # Run search
-    finder.start_search()
-    cycles = finder.wait_done()
+        # Run search
+        finder.start_search()
+        if args.progress or args.stop_at_area is not None:
+            cycles, stopped_early = run_with_progress(finder, args.progress, args.stop_at_area)
+            search_cycles.append(cycles)
+        else:
+            search_cycles.append(finder.wait_done())
+        if not finder.done:
+            break
 
     elapsed = time.time() - start_time
+    cycles = sum(search_cycles)
+
+    if args.flight_recorder and not finder.done:
+        print(f"Timed out, flight recorder written: {args.flight_recorder}", file=sys.stderr)
+
+    if args.capture:
+        finder.disable_triggered_capture()
+        print(f"Triggered captures written: {finder.capture_count}", file=sys.stderr)
 
     # Print results
     print(f"\nResults:", file=sys.stderr)
     print(f"  Done: {finder.done}", file=sys.stderr)
+    if stopped_early:
+        print(f"  Stopped early: max area reached {args.stop_at_area}", file=sys.stderr)
     print(f"  Valid: {finder.valid}", file=sys.stderr)
     print(f"  Max area: {finder.max_area}", file=sys.stderr)
     print(f"  Rectangles tested: {finder.rectangles_tested}", file=sys.stderr)
     print(f"  Rectangles pruned: {finder.rectangles_pruned}", file=sys.stderr)
+    if args.edge_index:
+        examined, skipped = finder.edges_examined, finder.edges_skipped
+        print(f"  Edges examined: {examined}, skipped: {skipped} "
+              f"({100.0 * skipped / max(examined + skipped, 1):.1f}%)", file=sys.stderr)
+    if args.cache_lines:
+        print(f"  Cache: {finder.cache_accesses} reads, {finder.cache_misses} misses "
+              f"({100.0 * finder.cache_hit_rate:.1f}% hits), {finder.cache_stall_cycles} stall cycles",
+              file=sys.stderr)
     print(f"  Cycles: {cycles}", file=sys.stderr)
+    if len(search_cycles) > 1:
+        print(f"  Searches: {len(search_cycles)}, {cycles // len(search_cycles)} cycles each, "
+              f"{load_cycles} load cycles in total", file=sys.stderr)
     print(f"  Time: {elapsed:.3f}s", file=sys.stderr)
     if elapsed > 0:
         print(f"  Rate: {cycles / elapsed / 1e6:.2f}M cycles/sec", file=sys.stderr)
 
+    if args.profile_states:
+        profile = finder.state_profile()
+        total = sum(c for c, _ in profile.values()) or 1
+        print(f"\nFSM state profile:", file=sys.stderr)
+        print(f"  {'state':<16} {'cycles':>14} {'%':>7} {'entries':>12} {'cyc/entry':>10}", file=sys.stderr)
+        for name, (c, e) in sorted(profile.items(), key=lambda kv: -kv[1][0]):
+            print(f"  {name:<16} {c:>14} {100.0 * c / total:>6.2f}% {e:>12} "
+                  f"{c / e if e else 0:>10.1f}", file=sys.stderr)
+        print(f"\nValidator lanes:", file=sys.stderr)
+        for lane, busy in enumerate(finder.lane_busy_cycles()):
+            print(f"  lane {lane:<3} {busy:>14} busy cycles {100.0 * busy / total:>6.2f}%",
+                  file=sys.stderr)
+        if finder.has_verdict_ports:
+            print_verdict_stats(finder.verdict_stats())
+
+    if args.scoreboard:
+        sb = finder.scoreboard_result()
+        print(f"\nScoreboard: {sb['checked']} verdicts checked, {sb['mismatches']} mismatches",
+              file=sys.stderr)
+        if sb['first']:
+            m = sb['first']
+            print(f"  First mismatch at cycle {m['cycle']}: {m['kind']} for pair ({m['i']}, {m['j']}), "
+                  f"rect ({m['rect_x']}, {m['rect_y']}) {m['rect_width']}x{m['rect_height']}, "
+                  f"expected {m['expected']}, got {m['got']}", file=sys.stderr)
+
     # Output just the area for scripting
     print(finder.max_area)
 
-    return 0 if finder.done else 1
+    if args.scoreboard and finder.scoreboard_result()['mismatches']:
+        return 1
+    return 0 if finder.done or stopped_early else 1
 
 
 if __name__ == "__main__":
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""
+Flight recorder, triggered capture and sample capture for the Verilator
+module wrappers.
+
+Every wrapper library exports the same entry points (sim_signal_api.h) over
+its own signal table, so the ctypes signatures and the Python methods live
+here once. A wrapper class inherits SimSignalsMixin, calls
+_setup_signal_functions() from its _setup_functions() and sets
+self._sampling = None before the first start_sampling().
+"""
+
+import ctypes
+
+
+class SimSignalsMixin:
+    """Flight recorder and sampling methods shared by the module wrappers.
+
+    Expects self.lib (the loaded ctypes.CDLL) and self.handle.
+    """
+
+    # Triggered capture conditions (see set_capture_trigger)
+    TRIGGER_OPS = {'eq': 1, 'ne': 2, 'enter': 3, 'leave': 4,
+                   'cross_up': 5, 'cross_down': 6, 'change': 7}
+
+    def _setup_signal_functions(self):
+        """Define the flight recorder and sample capture C signatures."""
+        self.lib.enable_flight_recorder.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_char_p]
+        self.lib.enable_flight_recorder.restype = ctypes.c_uint8
+        self.lib.disable_flight_recorder.argtypes = [ctypes.c_void_p]
+        self.lib.disable_flight_recorder.restype = None
+        self.lib.dump_flight_recorder.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        self.lib.dump_flight_recorder.restype = ctypes.c_uint8
+        self.lib.set_capture_trigger.argtypes = [ctypes.c_void_p, ctypes.c_uint8, ctypes.c_char_p,
+                                                 ctypes.c_uint32, ctypes.c_uint64]
+        self.lib.set_capture_trigger.restype = ctypes.c_uint8
+        self.lib.enable_triggered_capture.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint64,
+                                                      ctypes.c_char_p, ctypes.c_uint64]
+        self.lib.enable_triggered_capture.restype = ctypes.c_uint8
+        self.lib.disable_triggered_capture.argtypes = [ctypes.c_void_p]
+        self.lib.disable_triggered_capture.restype = None
+        self.lib.get_capture_count.argtypes = [ctypes.c_void_p]
+        self.lib.get_capture_count.restype = ctypes.c_uint64
+
+        # Sample capture
+        self.lib.find_signal.argtypes = [ctypes.c_char_p]
+        self.lib.find_signal.restype = ctypes.c_int32
+        self.lib.get_num_signals.argtypes = []
+        self.lib.get_num_signals.restype = ctypes.c_uint32
+        self.lib.get_signal_name.argtypes = [ctypes.c_uint32]
+        self.lib.get_signal_name.restype = ctypes.c_char_p
+        self.lib.enable_sampling.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32,
+                                             ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint64, ctypes.c_uint32]
+        self.lib.enable_sampling.restype = ctypes.c_uint8
+        self.lib.disable_sampling.argtypes = [ctypes.c_void_p]
+        self.lib.disable_sampling.restype = None
+        self.lib.rewind_sampling.argtypes = [ctypes.c_void_p]
+        self.lib.rewind_sampling.restype = None
+        self.lib.get_sample_count.argtypes = [ctypes.c_void_p]
+        self.lib.get_sample_count.restype = ctypes.c_uint64
+        self.lib.get_samples_dropped.argtypes = [ctypes.c_void_p]
+        self.lib.get_samples_dropped.restype = ctypes.c_uint64
+        self.lib.get_sample_start_cycle.argtypes = [ctypes.c_void_p]
+        self.lib.get_sample_start_cycle.restype = ctypes.c_uint64
+
+    # =========================================================================
+    # Flight recorder
+    # =========================================================================
+
+    def enable_flight_recorder(self, depth=65536, dump_on_timeout=None):
+        """Keep the last `depth` cycles of the port signals in memory.
+
+        Nothing is written until dump_flight_recorder() is called, or until
+        one of the module's run_until_* calls times out if dump_on_timeout is
+        set (modules without a run loop only use it as the default
+        dump_flight_recorder() path). Requires a traced library (trace=True).
+
+        Args:
+            depth: Number of cycles kept in the ring buffer
+            dump_on_timeout: FST file written automatically on timeout
+        """
+        path = dump_on_timeout.encode() if dump_on_timeout else None
+        if not self.lib.enable_flight_recorder(self.handle, depth, path):
+            raise RuntimeError("Flight recorder needs a traced library; create with trace=True")
+
+    def disable_flight_recorder(self):
+        """Stop recording and free the ring buffer."""
+        self.lib.disable_flight_recorder(self.handle)
+
+    def dump_flight_recorder(self, filename=None):
+        """Write the recorded cycles to an FST file.
+
+        Args:
+            filename: Output path (default: the dump_on_timeout path)
+
+        Returns:
+            True if a file was written
+        """
+        return bool(self.lib.dump_flight_recorder(self.handle, filename.encode() if filename else None))
+
+    def set_capture_trigger(self, signal, op, value=0, stop=False):
+        """Set the start (or stop) condition for triggered capture.
+
+        Args:
+            signal: Flight recorder signal name, e.g. 'debug_state'
+            op: One of TRIGGER_OPS ('enter', 'cross_up', 'change', ...), or None to clear
+            value: Comparison value (ignored for 'change')
+            stop: Set the stop condition that ends the post-trigger window early
+        """
+        code = 0 if op is None else self.TRIGGER_OPS.get(op)
+        if code is None:
+            raise ValueError(f"Unknown trigger op {op!r}, expected one of {list(self.TRIGGER_OPS)}")
+        if not self.lib.set_capture_trigger(self.handle, 1 if stop else 0, signal.encode(), code, value):
+            raise ValueError(f"Unknown trigger signal {signal!r} (or library built without tracing)")
+
+    def enable_triggered_capture(self, filename, pre=10000, post=10000, max_captures=1):
+        """Write a window of the flight recorder signals around each trigger.
+
+        When the start trigger fires, `pre` cycles before it through `post`
+        cycles after it (or the stop trigger) are written to filename. Later
+        captures get a _1, _2, ... suffix. Requires a traced library.
+
+        Args:
+            filename: Output FST file
+            pre: Cycles kept before the trigger
+            post: Cycles recorded after the trigger
+            max_captures: Captures before disarming (0 = unlimited)
+        """
+        if not self.lib.enable_triggered_capture(self.handle, pre, post, filename.encode(), max_captures):
+            raise RuntimeError("Triggered capture needs a start trigger and a traced library")
+
+    def disable_triggered_capture(self):
+        """Disarm triggered capture, writing a capture still in progress."""
+        self.lib.disable_triggered_capture(self.handle)
+
+    @property
+    def capture_count(self):
+        """Number of triggered captures written."""
+        return self.lib.get_capture_count(self.handle)
+
+    # =========================================================================
+    # Sample capture
+    # =========================================================================
+
+    @property
+    def signal_names(self):
+        """Signals start_sampling accepts (the flight recorder signal table)."""
+        return [self.lib.get_signal_name(i).decode() for i in range(self.lib.get_num_signals())]
+
+    def start_sampling(self, signals, capacity=None, buffer=None, every=1):
+        """Copy signals into a buffer natively while the simulation runs.
+
+        Every clocking call (clock, run_until_*, ...) stores one row per
+        `every` cycles, column-major, until the buffer is full. Nothing is
+        encoded or written, so trace-free libraries work too.
+
+        Args:
+            signals: Signal names, e.g. ['debug_state', 'max_area']
+            capacity: Rows to allocate when no buffer is given
+            buffer: Caller-owned C-contiguous uint64 numpy array of shape
+                (len(signals), capacity), filled in place without copying
+            every: Keep one cycle in `every`
+
+        Returns:
+            The buffer being filled (a ctypes array if none was given)
+        """
+        ids = []
+        for name in signals:
+            index = self.lib.find_signal(name.encode())
+            if index < 0:
+                raise ValueError(f"Unknown signal {name!r}, expected one of {self.signal_names}")
+            ids.append(index)
+        if buffer is None:
+            if not capacity:
+                raise ValueError("start_sampling needs a capacity or a buffer")
+            buffer = (ctypes.c_uint64 * (len(ids) * capacity))()
+            ptr = buffer
+        else:
+            if buffer.dtype.itemsize != 8 or buffer.dtype.kind != 'u':
+                raise ValueError("sample buffer must have dtype uint64")
+            if buffer.ndim != 2 or buffer.shape[0] != len(ids):
+                raise ValueError(f"sample buffer must have shape ({len(ids)}, capacity)")
+            if not buffer.flags['C_CONTIGUOUS']:
+                raise ValueError("sample buffer must be C-contiguous")
+            capacity = buffer.shape[1]
+            ptr = buffer.ctypes.data_as(ctypes.POINTER(ctypes.c_uint64))
+        id_array = (ctypes.c_uint32 * len(ids))(*ids)
+        if not self.lib.enable_sampling(self.handle, id_array, len(ids), ptr, capacity, every):
+            raise ValueError("enable_sampling rejected the signals or buffer")
+        self._sampling = (list(signals), buffer, capacity)  # Keeps the buffer alive
+        return buffer
+
+    def stop_sampling(self):
+        """Stop sampling and release the buffer."""
+        self.lib.disable_sampling(self.handle)
+        self._sampling = None
+
+    def rewind_sampling(self):
+        """Refill the buffer from row 0, e.g. after consuming samples()."""
+        self.lib.rewind_sampling(self.handle)
+
+    @property
+    def sample_count(self):
+        """Rows filled since sampling started or was rewound."""
+        return self.lib.get_sample_count(self.handle)
+
+    @property
+    def samples_dropped(self):
+        """Samples lost because the buffer was full."""
+        return self.lib.get_samples_dropped(self.handle)
+
+    @property
+    def sample_start_cycle(self):
+        """Cycle of row 0; row r is cycle sample_start_cycle + r * every."""
+        return self.lib.get_sample_start_cycle(self.handle)
+
+    def samples(self):
+        """Filled rows per signal, {name: column}: numpy views for a numpy
+        buffer, lists otherwise."""
+        if not self._sampling:
+            return {}
+        names, buffer, capacity = self._sampling
+        count = self.sample_count
+        if hasattr(buffer, 'ctypes') and hasattr(buffer, 'ndim'):
+            return {name: buffer[k, :count] for k, name in enumerate(names)}
+        return {name: buffer[k * capacity:k * capacity + count] for k, name in enumerate(names)}
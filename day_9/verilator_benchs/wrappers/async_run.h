@@ -0,0 +1,94 @@
+/**
+ * Background clock loop for the module wrappers.
+ *
+ * AsyncRun owns one native thread that runs a wrapper's clock loop in chunks
+ * of ASYNC_CHUNK_CYCLES. Between chunks the loop publishes a short progress
+ * record (the cycle count and signal values picked by the wrapper) and checks
+ * for a cancel request. Another thread can then follow progress and stop
+ * the run early, and the loop pays nothing per cycle for it.
+ *
+ * The record is published under a sequence counter, so a snapshot never mixes
+ * values from two chunks. While a run is in flight the thread owns the
+ * instance: other threads may only take snapshots, cancel, or join.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+static constexpr uint32_t ASYNC_MAX_VALUES = 8;
+static constexpr uint64_t ASYNC_CHUNK_CYCLES = 4096;  // Cycles between progress updates
+
+struct AsyncRun {
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> cancel{false};
+    std::atomic<uint32_t> seq{0};                      // Odd while a record is being written
+    std::atomic<uint64_t> values[ASYNC_MAX_VALUES] = {};
+    std::atomic<uint32_t> num_values{0};
+    uint64_t result = 0;                               // Loop return value, valid once joined
+
+    // Run loop() on the background thread; false if a run is still in flight
+    template <typename Loop>
+    bool start(Loop loop) {
+        if (running.load(std::memory_order_acquire)) {
+            return false;
+        }
+        join();
+        cancel.store(false, std::memory_order_relaxed);
+        running.store(true, std::memory_order_release);
+        thread = std::thread([this, loop]() {
+            result = loop();
+            running.store(false, std::memory_order_release);
+        });
+        return true;
+    }
+
+    // Wait for the run to finish (no-op without one), returns its result
+    uint64_t join() {
+        if (thread.joinable()) {
+            thread.join();
+        }
+        return result;
+    }
+
+    // Loop side: true once cancellation was requested
+    bool cancelled() const {
+        return cancel.load(std::memory_order_relaxed);
+    }
+
+    // Loop side: replace the progress record with v[0 .. n)
+    void publish(const uint64_t* v, uint32_t n) {
+        n = n < ASYNC_MAX_VALUES ? n : ASYNC_MAX_VALUES;
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (uint32_t k = 0; k < n; k++) {
+            values[k].store(v[k], std::memory_order_relaxed);
+        }
+        num_values.store(n, std::memory_order_relaxed);
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Reader side: copy at most cap values of one complete record, returns
+    // the number of values in a record
+    uint32_t snapshot(uint64_t* out, uint32_t cap) const {
+        for (;;) {
+            uint32_t s = seq.load(std::memory_order_acquire);
+            if (s & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint32_t n = num_values.load(std::memory_order_relaxed);
+            for (uint32_t k = 0; k < cap && k < n; k++) {
+                out[k] = values[k].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s) {
+                return n;
+            }
+        }
+    }
+};
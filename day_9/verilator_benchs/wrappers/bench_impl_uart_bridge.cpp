@@ -0,0 +1,127 @@
+/**
+ * Standalone throughput bench for impl_uart_bridge (UartBridgeTop).
+ *
+ * Linked with impl_uart_bridge.cpp and driven through the same run_polygon()
+ * call as the Python class, without an interpreter in the loop. Each input
+ * file is memory-mapped and streamed over the serial link as-is (plus the
+ * terminating NUL); the result line is printed to stdout (one line per file)
+ * and statistics to stderr.
+ *
+ * Usage: bench_impl_uart_bridge [--max-cycles N] [--baud-div N] [--threads N]
+ *                               [--verbose] input.txt...
+ */
+
+#include "bench_input.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Instance;
+
+extern "C" {
+Instance* create_instance(uint32_t threads);
+void destroy_instance(Instance* inst);
+uint8_t get_done(Instance* inst);
+uint64_t run_polygon(Instance* inst, const uint8_t* input, size_t input_len,
+                     uint8_t* output, size_t output_cap, size_t* output_len,
+                     uint32_t baud_div, uint64_t max_cycles, uint8_t verbose);
+}
+
+static constexpr uint32_t DEFAULT_BAUD_DIV = 234;  // 27MHz @ 115200 baud
+static constexpr size_t OUTPUT_BUFFER_SIZE = 256;  // Result line is at most 14 bytes
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--max-cycles N] [--baud-div N] [--threads N] [--verbose] "
+                    "input.txt...\n", prog);
+}
+
+int main(int argc, char** argv) {
+    uint64_t max_cycles = 50000000000ull;  // Same default as process_polygon()
+    uint32_t baud_div = DEFAULT_BAUD_DIV;
+    uint32_t threads = 0;
+    uint8_t verbose = 0;
+    std::vector<const char*> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--max-cycles") && i + 1 < argc) {
+            max_cycles = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--baud-div") && i + 1 < argc) {
+            baud_div = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if (!strcmp(argv[i], "--verbose")) {
+            verbose = 1;
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty() || baud_div == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int status = 0;
+    std::vector<uint8_t> copy;
+    uint8_t output[OUTPUT_BUFFER_SIZE];
+    for (const char* path : inputs) {
+        MappedFile file;
+        if (!map_file(path, &file)) {
+            status = 1;
+            continue;
+        }
+
+        // The bridge expects a NUL after the text. Send it straight from the
+        // mapping when the page tail provides one, otherwise from a copy.
+        const uint8_t* input = reinterpret_cast<const uint8_t*>(file.data);
+        if (!mapped_nul_terminated(&file)) {
+            copy.assign(input, input + file.size);
+            copy.push_back(0);
+            input = copy.data();
+        }
+        size_t input_bytes = file.size;
+        size_t input_len = input_bytes + 1;
+
+        Instance* inst = create_instance(threads);
+        size_t output_len = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t cycles = run_polygon(inst, input, input_len, output, sizeof(output), &output_len,
+                                      baud_div, max_cycles, verbose);
+        auto t1 = std::chrono::steady_clock::now();
+        unmap_file(&file);
+
+        std::string result;
+        for (size_t i = 0; i < output_len; i++) {
+            if (output[i] != '\r' && output[i] != '\n') {
+                result += static_cast<char>(output[i]);
+            }
+        }
+
+        double elapsed = std::chrono::duration<double>(t1 - t0).count();
+        bool done = get_done(inst);
+
+        fprintf(stderr, "%s:\n", path);
+        fprintf(stderr, "  Input bytes: %zu\n", input_bytes);
+        fprintf(stderr, "  Done: %d\n", done ? 1 : 0);
+        fprintf(stderr, "  Result: %s\n", result.c_str());
+        fprintf(stderr, "  Cycles: %llu\n", static_cast<unsigned long long>(cycles));
+        fprintf(stderr, "  Time: %.3fs\n", elapsed);
+        if (elapsed > 0) {
+            fprintf(stderr, "  Rate: %.2fM cycles/sec\n", cycles / elapsed / 1e6);
+        }
+
+        // Output just the result for scripting
+        printf("%s\n", result.c_str());
+        if (!done) {
+            status = 1;
+        }
+        destroy_instance(inst);
+    }
+    return status;
+}
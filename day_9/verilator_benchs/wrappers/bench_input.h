@@ -0,0 +1,110 @@
+/**
+ * Input helpers for the standalone bench executables (bench_<module>.cpp).
+ *
+ * Polygon text files are memory-mapped read-only and parsed in place, with
+ * the same rules as load_polygon_from_file() in the Python testbenches:
+ * one "x,y" vertex per line, and an empty line ends the polygon.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t mapped = 0;  // Mapping length, 0 if nothing is mapped
+};
+
+// Map path read-only. Returns false (with a message on stderr) on failure.
+// An empty file gives size 0 and no mapping.
+static inline bool map_file(const char* path, MappedFile* f) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return false;
+    }
+    f->size = static_cast<size_t>(st.st_size);
+    f->mapped = 0;
+    f->data = nullptr;
+    if (f->size > 0) {
+        void* p = mmap(nullptr, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            perror(path);
+            close(fd);
+            return false;
+        }
+        madvise(p, f->size, MADV_SEQUENTIAL);
+        f->data = static_cast<const char*>(p);
+        f->mapped = f->size;
+    }
+    close(fd);
+    return true;
+}
+
+static inline void unmap_file(MappedFile* f) {
+    if (f->mapped) {
+        munmap(const_cast<char*>(f->data), f->mapped);
+    }
+    f->data = nullptr;
+    f->size = 0;
+    f->mapped = 0;
+}
+
+// True if the byte just past the end of the file is readable and zero.
+// Within the last mapped page the kernel zero-fills past EOF, so this holds
+// whenever the size is not a multiple of the page size.
+static inline bool mapped_nul_terminated(const MappedFile* f) {
+    long page = sysconf(_SC_PAGESIZE);
+    return f->mapped && page > 0 && f->size % static_cast<size_t>(page) != 0;
+}
+
+// Parse "x,y" lines into interleaved xy pairs. Lines without a comma are
+// skipped; parsing stops at the first empty line. Returns the vertex count.
+static inline size_t parse_polygon(const char* p, size_t n, std::vector<uint32_t>* xy) {
+    const char* end = p + n;
+    xy->clear();
+    while (p < end) {
+        const char* eol = p;
+        while (eol < end && *eol != '\n') {
+            eol++;
+        }
+        const char* q = p;
+        const char* line_end = eol;
+        while (q < line_end && (*q == ' ' || *q == '\t' || *q == '\r')) q++;
+        while (line_end > q && (line_end[-1] == ' ' || line_end[-1] == '\t' || line_end[-1] == '\r')) line_end--;
+        if (q == line_end) {
+            break;  // Empty line ends polygon
+        }
+
+        uint32_t v[2] = {0, 0};
+        int field = 0;
+        for (; q < line_end && field < 2; q++) {
+            if (*q >= '0' && *q <= '9') {
+                v[field] = v[field] * 10 + static_cast<uint32_t>(*q - '0');
+            } else if (*q == ',') {
+                field++;
+            }
+        }
+        if (field >= 1) {
+            xy->push_back(v[0]);
+            xy->push_back(v[1]);
+        }
+        p = eol + 1;
+    }
+    return xy->size() / 2;
+}
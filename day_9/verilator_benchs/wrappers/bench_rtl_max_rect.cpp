@@ -0,0 +1,111 @@
+/**
+ * Standalone throughput bench for rtl_max_rect (MaxRectangleFinder).
+ *
+ * Linked with rtl_max_rect.cpp and driven through the same C API as the
+ * Python class, without an interpreter in the loop. Each input file is
+ * memory-mapped, parsed natively and run on a fresh instance; the max area
+ * is printed to stdout (one line per file) and statistics to stderr.
+ *
+ * Usage: bench_rtl_max_rect [--max-cycles N] [--threads N] input.txt...
+ */
+
+#include "bench_input.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+struct Instance;
+
+extern "C" {
+Instance* create_instance(uint32_t threads);
+void destroy_instance(Instance* inst);
+uint64_t get_cycle_count(Instance* inst);
+uint8_t get_done(Instance* inst);
+uint8_t get_valid(Instance* inst);
+uint64_t get_max_area(Instance* inst);
+uint32_t get_rectangles_tested(Instance* inst);
+uint32_t get_rectangles_pruned(Instance* inst);
+uint32_t get_vertices_loaded(Instance* inst);
+uint32_t get_validation_cycles(Instance* inst);
+void load_vertices(Instance* inst, const uint32_t* xy, uint32_t count);
+void start_search(Instance* inst);
+uint64_t run_until_done(Instance* inst, uint64_t max_cycles);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--max-cycles N] [--threads N] input.txt...\n", prog);
+}
+
+int main(int argc, char** argv) {
+    uint64_t max_cycles = 10000000000ull;  // Same default as wait_done()
+    uint32_t threads = 0;
+    std::vector<const char*> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--max-cycles") && i + 1 < argc) {
+            max_cycles = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int status = 0;
+    std::vector<uint32_t> xy;
+    for (const char* path : inputs) {
+        auto t0 = std::chrono::steady_clock::now();
+
+        MappedFile file;
+        if (!map_file(path, &file)) {
+            status = 1;
+            continue;
+        }
+        size_t count = parse_polygon(file.data, file.size, &xy);
+        unmap_file(&file);
+
+        Instance* inst = create_instance(threads);
+        auto t1 = std::chrono::steady_clock::now();
+        load_vertices(inst, xy.data(), static_cast<uint32_t>(count));
+        start_search(inst);
+        uint64_t cycles = run_until_done(inst, max_cycles);
+        auto t2 = std::chrono::steady_clock::now();
+
+        double setup_s = std::chrono::duration<double>(t1 - t0).count();
+        double run_s = std::chrono::duration<double>(t2 - t1).count();
+        bool done = get_done(inst);
+
+        fprintf(stderr, "%s:\n", path);
+        fprintf(stderr, "  Vertices: %zu (loaded %u)\n", count, get_vertices_loaded(inst));
+        fprintf(stderr, "  Done: %d, Valid: %d\n", done ? 1 : 0, get_valid(inst) ? 1 : 0);
+        fprintf(stderr, "  Max area: %llu\n", static_cast<unsigned long long>(get_max_area(inst)));
+        fprintf(stderr, "  Rectangles tested: %u, pruned: %u\n",
+                get_rectangles_tested(inst), get_rectangles_pruned(inst));
+        fprintf(stderr, "  Validation cycles: %u\n", get_validation_cycles(inst));
+        fprintf(stderr, "  Cycles: %llu (search), %llu (total)\n",
+                static_cast<unsigned long long>(cycles),
+                static_cast<unsigned long long>(get_cycle_count(inst)));
+        fprintf(stderr, "  Time: %.3fs (+%.3fs setup)\n", run_s, setup_s);
+        if (run_s > 0) {
+            fprintf(stderr, "  Rate: %.2fM cycles/sec\n", get_cycle_count(inst) / run_s / 1e6);
+        }
+
+        // Output just the area for scripting
+        printf("%llu\n", static_cast<unsigned long long>(get_max_area(inst)));
+        if (!done) {
+            status = 1;
+        }
+        destroy_instance(inst);
+    }
+    return status;
+}
@@ -0,0 +1,85 @@
+/**
+ * Cycle-level external memory model for rtl_max_rect's vertex cache.
+ *
+ * Serves one burst at a time on the cache's memory port: a request accepted
+ * on mem_req_valid & mem_req_ready returns burst_beats consecutive words on
+ * mem_resp_valid, the first `latency` cycles after the request and then one
+ * every cycles_per_beat cycles. Words past the end of the polygon read as 0.
+ *
+ * The wrapper drives the DUT inputs from dram_drive() before each clock
+ * edge and calls dram_advance() after it with what the DUT presented, so the
+ * model never needs a combinational view of the design.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct DramModel {
+    std::vector<uint64_t> words;    // Vertex words, {y, x} as in the BRAMs
+    uint32_t latency = 20;          // Request accepted -> first beat, cycles (>= 1)
+    uint32_t cycles_per_beat = 1;   // Spacing of the following beats (>= 1)
+    uint32_t burst_beats = 8;       // Words per request (cache line_vertices)
+
+    // Burst in flight
+    bool active = false;
+    uint64_t addr = 0;
+    uint32_t beats_left = 0;
+    uint32_t wait = 0;
+
+    // Statistics (since dram_reset_stats)
+    uint64_t bursts = 0;
+    uint64_t beats = 0;
+    uint64_t busy_cycles = 0;       // Cycles with a burst in flight
+};
+
+// DUT inputs for the coming clock edge
+struct DramDrive {
+    bool req_ready;
+    bool resp_valid;
+    uint64_t resp_data;
+};
+
+static inline DramDrive dram_drive(const DramModel* d) {
+    DramDrive drv;
+    drv.req_ready = !d->active;
+    drv.resp_valid = d->active && d->wait == 0;
+    drv.resp_data = drv.resp_valid && d->addr < d->words.size() ? d->words[d->addr] : 0;
+    return drv;
+}
+
+// Update the model after a clock edge driven with drv, where the DUT
+// presented req_valid / req_addr
+static inline void dram_advance(DramModel* d, const DramDrive& drv, bool req_valid, uint64_t req_addr) {
+    if (d->active) {
+        d->busy_cycles++;
+        if (drv.resp_valid) {
+            d->beats++;
+            d->addr++;
+            d->wait = d->cycles_per_beat - 1;
+            d->active = --d->beats_left != 0;
+        } else {
+            d->wait--;
+        }
+    } else if (req_valid && drv.req_ready) {
+        d->active = true;
+        d->addr = req_addr;
+        d->beats_left = d->burst_beats;
+        d->wait = d->latency - 1;
+        d->bursts++;
+    }
+}
+
+static inline void dram_reset_stats(DramModel* d) {
+    d->bursts = 0;
+    d->beats = 0;
+    d->busy_cycles = 0;
+}
+
+// Drop a burst in flight (the DUT is being reset)
+static inline void dram_cancel(DramModel* d) {
+    d->active = false;
+    d->beats_left = 0;
+    d->wait = 0;
+}
@@ -0,0 +1,255 @@
+/**
+ * In-memory flight recorder for top-level signals.
+ *
+ * Keeps the last `depth` cycles of a wrapper-defined signal table in a ring
+ * buffer and writes them to an FST file only when asked, so long runs pay no
+ * trace I/O but still leave a waveform of the cycles before a failure.
+ *
+ * TriggerCapture builds on the ring: a start condition on one signal keeps
+ * the `pre` cycles before it, recording continues for `post` cycles (or until
+ * a stop condition), and only that window is written.
+ *
+ * Uses the FST writer that verilated_fst_c.cpp already compiles in, so the
+ * recorder itself is only available in traced (SIM_TRACE=1) builds; the
+ * signal table and trigger types are always defined so wrappers need no
+ * conditionals.
+ */
+
+#pragma once
+
+#ifndef SIM_TRACE
+#define SIM_TRACE 1
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+// One recorded signal: name in the FST scope and bit width (1..64)
+struct RecorderSignal {
+    const char* name;
+    uint32_t width;
+};
+
+// Index of the signal called name, or -1
+static inline int32_t recorder_find_signal(const RecorderSignal* signals, uint32_t n,
+                                           const char* name) {
+    for (uint32_t i = 0; name && i < n; i++) {
+        if (std::strcmp(signals[i].name, name) == 0) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+// Trigger conditions. Level conditions test the current cycle; edge
+// conditions compare it with the previous cycle and never fire on the first
+// recorded cycle.
+static constexpr uint32_t TRIGGER_OFF = 0;
+static constexpr uint32_t TRIGGER_EQ = 1;          // value == v
+static constexpr uint32_t TRIGGER_NE = 2;          // value != v
+static constexpr uint32_t TRIGGER_ENTER = 3;       // becomes v
+static constexpr uint32_t TRIGGER_LEAVE = 4;       // stops being v
+static constexpr uint32_t TRIGGER_CROSS_UP = 5;    // goes from < v to >= v
+static constexpr uint32_t TRIGGER_CROSS_DOWN = 6;  // goes from >= v to < v
+static constexpr uint32_t TRIGGER_CHANGE = 7;      // any change (v ignored)
+static constexpr uint32_t TRIGGER_NUM_OPS = 8;
+
+struct RecorderTrigger {
+    uint32_t signal = 0;
+    uint32_t op = TRIGGER_OFF;
+    uint64_t value = 0;
+
+    bool fires(const uint64_t* row, const uint64_t* prev) const {
+        uint64_t cur = row[signal];
+        switch (op) {
+        case TRIGGER_EQ: return cur == value;
+        case TRIGGER_NE: return cur != value;
+        default: break;
+        }
+        if (!prev) {
+            return false;
+        }
+        uint64_t old = prev[signal];
+        switch (op) {
+        case TRIGGER_ENTER: return cur == value && old != value;
+        case TRIGGER_LEAVE: return cur != value && old == value;
+        case TRIGGER_CROSS_UP: return cur >= value && old < value;
+        case TRIGGER_CROSS_DOWN: return cur < value && old >= value;
+        case TRIGGER_CHANGE: return cur != old;
+        default: return false;
+        }
+    }
+};
+
+#if SIM_TRACE
+
+#include "gtkwave/fstapi.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct FlightRecorder {
+    const RecorderSignal* signals = nullptr;
+    uint32_t num_signals = 0;
+    uint64_t depth = 0;
+    std::vector<uint64_t> values;  // depth * num_signals, one row per slot
+    std::vector<uint64_t> cycles;  // cycle number held in each slot
+    uint64_t head = 0;             // next slot to write
+    uint64_t count = 0;            // number of valid slots
+    std::string auto_dump_path;    // written on run timeouts if non-empty
+
+    FlightRecorder(const RecorderSignal* sigs, uint32_t n, uint64_t cycles_kept)
+        : signals(sigs), num_signals(n), depth(cycles_kept ? cycles_kept : 1),
+          values(depth * n), cycles(depth) {}
+
+    // Claim the next ring slot for `cycle`; the caller fills num_signals values
+    uint64_t* next_slot(uint64_t cycle) {
+        uint64_t* slot = &values[head * num_signals];
+        cycles[head] = cycle;
+        head = (head + 1 == depth) ? 0 : head + 1;
+        if (count < depth) {
+            count++;
+        }
+        return slot;
+    }
+
+    // Row recorded `back` cycles ago (0 = latest), or null if not recorded
+    const uint64_t* row(uint64_t back) const {
+        if (back >= count) {
+            return nullptr;
+        }
+        return &values[((head + depth - 1 - back) % depth) * num_signals];
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    // Write the recorded cycles from from_cycle on (oldest first) to an FST
+    // file. Cycle c is emitted as clk=0 at time 2c and clk=1 plus the sampled
+    // values at 2c+1, matching the wrapper's sim_time. Returns false if
+    // nothing was recorded or the file could not be created.
+    bool dump(const char* filename, uint64_t from_cycle = 0) const {
+        if (count == 0 || !filename || !*filename) {
+            return false;
+        }
+        void* fst = fstWriterCreate(filename, 1);
+        if (!fst) {
+            return false;
+        }
+        fstWriterSetPackType(fst, FST_WR_PT_LZ4);
+        fstWriterSetTimescaleFromString(fst, "1ps");
+
+        fstWriterSetScope(fst, FST_ST_VCD_MODULE, "TOP", nullptr);
+        fstHandle clk = fstWriterCreateVar(fst, FST_VT_VCD_WIRE, FST_VD_IMPLICIT, 1, "clk", 0);
+        std::vector<fstHandle> handles(num_signals);
+        for (uint32_t i = 0; i < num_signals; i++) {
+            handles[i] = fstWriterCreateVar(fst, FST_VT_VCD_WIRE, FST_VD_IMPLICIT,
+                                            signals[i].width, signals[i].name, 0);
+        }
+        fstWriterSetUpscope(fst);
+
+        char bits[65];
+        uint64_t first = (head + depth - count) % depth;
+        const uint64_t* prev = nullptr;
+        for (uint64_t n = 0; n < count; n++) {
+            uint64_t slot = (first + n) % depth;
+            if (cycles[slot] < from_cycle) {
+                continue;
+            }
+            const uint64_t* row = &values[slot * num_signals];
+            uint64_t t = cycles[slot] * 2;
+
+            fstWriterEmitTimeChange(fst, t);
+            fstWriterEmitValueChange(fst, clk, "0");
+            fstWriterEmitTimeChange(fst, t + 1);
+            fstWriterEmitValueChange(fst, clk, "1");
+            for (uint32_t i = 0; i < num_signals; i++) {
+                if (prev && prev[i] == row[i]) {
+                    continue;
+                }
+                uint32_t w = signals[i].width;
+                for (uint32_t b = 0; b < w; b++) {
+                    bits[b] = ((row[i] >> (w - 1 - b)) & 1) ? '1' : '0';
+                }
+                bits[w] = '\0';
+                fstWriterEmitValueChange(fst, handles[i], bits);
+            }
+            prev = row;
+        }
+
+        fstWriterClose(fst);
+        return true;
+    }
+};
+
+static constexpr uint32_t CAPTURE_OFF = 0;
+static constexpr uint32_t CAPTURE_ARMED = 1;  // Waiting for the start trigger
+static constexpr uint32_t CAPTURE_POST = 2;   // Triggered, recording post cycles
+static constexpr uint32_t CAPTURE_DONE = 3;   // max_captures reached
+
+struct TriggerCapture {
+    RecorderTrigger start;
+    RecorderTrigger stop;            // Optional early end of the post window
+    uint32_t state = CAPTURE_OFF;
+    uint64_t pre = 0;                // Cycles kept before the trigger
+    uint64_t post = 0;               // Cycles recorded after the trigger
+    uint64_t post_left = 0;
+    uint64_t from_cycle = 0;         // First cycle of the pending capture
+    uint64_t captures = 0;           // Files written so far
+    uint64_t max_captures = 1;       // 0 = re-arm forever
+    std::string path;
+
+    bool active() const { return state == CAPTURE_ARMED || state == CAPTURE_POST; }
+
+    // Capture 0 goes to path, capture n to path with "_n" before the extension
+    std::string filename(uint64_t index) const {
+        if (index == 0) {
+            return path;
+        }
+        size_t dot = path.rfind('.');
+        size_t slash = path.rfind('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            dot = path.size();
+        }
+        return path.substr(0, dot) + "_" + std::to_string(index) + path.substr(dot);
+    }
+
+    // Evaluate the triggers on the row just recorded for `cycle`
+    void update(const FlightRecorder& rec, uint64_t cycle) {
+        const uint64_t* cur = rec.row(0);
+        const uint64_t* prev = rec.row(1);
+        if (state == CAPTURE_ARMED) {
+            if (start.fires(cur, prev)) {
+                from_cycle = cycle >= pre ? cycle - pre : 0;
+                post_left = post;
+                state = CAPTURE_POST;
+                if (post_left == 0) {
+                    finish(rec);
+                }
+            }
+        } else if (state == CAPTURE_POST) {
+            if (stop.fires(cur, prev) || --post_left == 0) {
+                finish(rec);
+            }
+        }
+    }
+
+    // Write the pending capture (pre window through the latest recorded
+    // cycle) and re-arm
+    bool finish(const FlightRecorder& rec) {
+        uint64_t cycle = rec.count ? rec.cycles[(rec.head + rec.depth - 1) % rec.depth] : from_cycle;
+        std::string name = filename(captures);
+        bool ok = rec.dump(name.c_str(), from_cycle);
+        captures++;
+        if (ok) {
+            fprintf(stderr, "Capture written to %s (cycles %lu-%lu)\n", name.c_str(),
+                    static_cast<unsigned long>(from_cycle), static_cast<unsigned long>(cycle));
+        }
+        state = (max_captures == 0 || captures < max_captures) ? CAPTURE_ARMED : CAPTURE_DONE;
+        return ok;
+    }
+};
+
+#endif // SIM_TRACE
@@ -1,138 +1,185 @@
 /**
  * C wrapper for impl_ascii (MaxRectangleAsciiWrapper) Verilator module.
  * Exposes module signals as C functions for Python ctypes.
+ *
+ * All functions take the opaque handle returned by create_instance().
  */
 
-#include "Vtop.h"
-#include "verilated.h"
-#include "verilated_fst_c.h"
+#include "sim_instance.h"
+#include <cstddef>
 #include <cstdint>
 
-static Vtop* dut = nullptr;
-static VerilatedContext* ctx = nullptr;
-static VerilatedFstC* tfp = nullptr;
-static uint64_t sim_time = 0;
-static uint64_t trace_from_cycle = 0;
-static uint64_t trace_to_cycle = UINT64_MAX;
-static bool tracing_enabled = false;
+struct Instance : SimInstance {};
 
-extern "C" {
+//==============================================================================
+// Flight Recorder Signals
+//==============================================================================
+
+static const RecorderSignal RECORDER_SIGNALS[] = {
+    {"ascii_in", 8},
+    {"ascii_in_valid", 1},
+    {"ascii_in_ready", 1},
+    {"ascii_out", 8},
+    {"ascii_out_valid", 1},
+    {"ascii_out_ready", 1},
+    {"processing", 1},
+    {"done", 1},
+};
+static constexpr uint32_t NUM_RECORDER_SIGNALS = sizeof(RECORDER_SIGNALS) / sizeof(RECORDER_SIGNALS[0]);
+
+static void sample_signals(const Vtop* dut, uint64_t* out) {
+    out[0] = dut->ascii_in;
+    out[1] = dut->ascii_in_valid;
+    out[2] = dut->ascii_in_ready;
+    out[3] = dut->ascii_out;
+    out[4] = dut->ascii_out_valid;
+    out[5] = dut->ascii_out_ready;
+    out[6] = dut->processing;
+    out[7] = dut->done;
+}
 
 //==============================================================================
-// Lifecycle
+// Streaming Helpers
 //==============================================================================
 
-void init_module() {
-    ctx = new VerilatedContext;
-    dut = new Vtop(ctx);
-    sim_time = 0;
-    // Reset sequence
-    dut->rst = 1;
-    for (int i = 0; i < 5; i++) {
-        dut->clk = 0; dut->eval();
-        dut->clk = 1; dut->eval();
+// Output collected across a streaming exchange (cap bytes kept, rest dropped)
+struct OutputSink {
+    uint8_t* out;
+    size_t cap;
+    size_t len = 0;
+
+    void collect(const Vtop* dut) {
+        if (dut->ascii_out_valid && dut->ascii_out_ready && len < cap) {
+            out[len++] = dut->ascii_out;
+        }
     }
-    dut->rst = 0;
-    // Initialize inputs
-    dut->ascii_in = 0;
+};
+
+// send_buffer(), also collecting ascii_out into sink (if not null) on every
+// cycle so output produced while the input is still streaming is kept
+static size_t stream_input(Instance* inst, const uint8_t* buf, size_t len, uint32_t max_wait,
+                           OutputSink* sink) {
+    Vtop* dut = inst->dut;
+    dut->ascii_in_valid = 1;
+
+    size_t sent = 0;
+    sim_with_observe(inst, [&](auto observe) {
+        auto clock = [&]() {
+            sim_clock_cycle_t(inst, observe);
+            if (sink) {
+                sink->collect(dut);
+            }
+        };
+        for (; sent < len; sent++) {
+            dut->ascii_in = buf[sent];
+            uint32_t waited = 0;
+            while (!dut->ascii_in_ready && waited < max_wait) {
+                clock();
+                waited++;
+            }
+            if (!dut->ascii_in_ready) {
+                break;
+            }
+            clock();
+        }
+    });
+
     dut->ascii_in_valid = 0;
-    dut->ascii_out_ready = 1;  // Always ready to receive output
+    return sent;
 }
 
-void cleanup_module() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
-    }
-    if (dut) {
-        dut->final();
-        delete dut;
-        dut = nullptr;
-    }
-    if (ctx) {
-        delete ctx;
-        ctx = nullptr;
+// drain_output() into sink, returns cycles taken
+static uint64_t stream_output(Instance* inst, OutputSink* sink, uint64_t max_cycles) {
+    Vtop* dut = inst->dut;
+    uint64_t cycles = 0;
+
+    sim_with_observe(inst, [&](auto observe) {
+        while (!dut->done && cycles < max_cycles) {
+            sim_clock_cycle_t(inst, observe);
+            sink->collect(dut);
+            cycles++;
+        }
+    });
+    if (!dut->done) {
+        sim_recorder_timeout(inst);
     }
-    tracing_enabled = false;
+    return cycles;
 }
 
+extern "C" {
+
 //==============================================================================
-// Waveform Control
+// Lifecycle
 //==============================================================================
 
-void enable_waveform(const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-    }
-    tfp = new VerilatedFstC;
-    ctx->traceEverOn(true);
-    dut->trace(tfp, 99);
-    tfp->open(filename);
-    trace_from_cycle = from_cycle;
-    trace_to_cycle = to_cycle;
-    tracing_enabled = true;
-}
-
-void disable_waveform() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
-    }
-    tracing_enabled = false;
+Instance* create_instance(uint32_t threads) {
+    Instance* inst = new Instance;
+    sim_init(inst, threads);
+    // Initialize inputs
+    inst->dut->ascii_in = 0;
+    inst->dut->ascii_in_valid = 0;
+    inst->dut->ascii_out_ready = 1;  // Always ready to receive output
+    return inst;
+}
+
+void destroy_instance(Instance* inst) {
+    if (!inst) return;
+    sim_cleanup(inst);
+    delete inst;
 }
 
 //==============================================================================
-// Clock
+// Waveform Control
 //==============================================================================
 
-void clock_cycle() {
-    uint64_t cycle = sim_time / 2;
+void enable_waveform(Instance* inst, const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
+    sim_enable_waveform(inst, filename, from_cycle, to_cycle);
+}
 
-    dut->clk = 0;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
-    }
-    sim_time++;
+void disable_waveform(Instance* inst) {
+    sim_disable_waveform(inst);
+}
 
-    dut->clk = 1;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
-    }
-    sim_time++;
+// 1 if this library was built with FST tracing, 0 for the trace-free variant
+uint8_t has_waveform_support() {
+    return SIM_TRACE;
 }
 
-void clock_n(uint32_t n) {
-    for (uint32_t i = 0; i < n; i++) {
-        clock_cycle();
-    }
+#include "sim_signal_api.h"
+
+//==============================================================================
+// Clock
+//==============================================================================
+
+void clock_cycle(Instance* inst) {
+    sim_clock_cycle(inst);
+}
+
+void clock_n(Instance* inst, uint32_t n) {
+    sim_clock_n(inst, n);
 }
 
-uint64_t get_cycle_count() {
-    return sim_time / 2;
+uint64_t get_cycle_count(Instance* inst) {
+    return inst->sim_time / 2;
 }
 
 //==============================================================================
 // Input Signals
 //==============================================================================
 
-void set_ascii_in(uint8_t v) { dut->ascii_in = v; }
-void set_ascii_in_valid(uint8_t v) { dut->ascii_in_valid = v; }
-void set_ascii_out_ready(uint8_t v) { dut->ascii_out_ready = v; }
+void set_ascii_in(Instance* inst, uint8_t v) { inst->dut->ascii_in = v; }
+void set_ascii_in_valid(Instance* inst, uint8_t v) { inst->dut->ascii_in_valid = v; }
+void set_ascii_out_ready(Instance* inst, uint8_t v) { inst->dut->ascii_out_ready = v; }
 
 //==============================================================================
 // Output Signals
 //==============================================================================
 
-uint8_t get_ascii_in_ready() { return dut->ascii_in_ready; }
-uint8_t get_ascii_out() { return dut->ascii_out; }
-uint8_t get_ascii_out_valid() { return dut->ascii_out_valid; }
-uint8_t get_processing() { return dut->processing; }
-uint8_t get_done() { return dut->done; }
+uint8_t get_ascii_in_ready(Instance* inst) { return inst->dut->ascii_in_ready; }
+uint8_t get_ascii_out(Instance* inst) { return inst->dut->ascii_out; }
+uint8_t get_ascii_out_valid(Instance* inst) { return inst->dut->ascii_out_valid; }
+uint8_t get_processing(Instance* inst) { return inst->dut->processing; }
+uint8_t get_done(Instance* inst) { return inst->dut->done; }
 
 //==============================================================================
 // Convenience Functions
@@ -140,25 +187,29 @@ uint8_t get_done() { return dut->done; }
 
 // Send a single character with handshaking
 // Returns 1 if accepted, 0 if not ready after max_wait cycles
-uint8_t send_char(uint8_t c, uint32_t max_wait) {
+uint8_t send_char(Instance* inst, uint8_t c, uint32_t max_wait) {
+    Vtop* dut = inst->dut;
     dut->ascii_in = c;
     dut->ascii_in_valid = 1;
 
-    for (uint32_t i = 0; i < max_wait; i++) {
-        if (dut->ascii_in_ready) {
-            clock_cycle();
-            dut->ascii_in_valid = 0;
-            return 1;
+    uint8_t accepted = sim_with_observe(inst, [&](auto observe) -> uint8_t {
+        for (uint32_t i = 0; i < max_wait; i++) {
+            bool ready = dut->ascii_in_ready;
+            sim_clock_cycle_t(inst, observe);
+            if (ready) {
+                return 1;
+            }
         }
-        clock_cycle();
-    }
+        return 0;
+    });
     dut->ascii_in_valid = 0;
-    return 0;
+    return accepted;
 }
 
 // Receive a single character if available
 // Returns the character in lower 8 bits, bit 8 set if valid
-uint16_t receive_char() {
+uint16_t receive_char(Instance* inst) {
+    Vtop* dut = inst->dut;
     if (dut->ascii_out_valid && dut->ascii_out_ready) {
         return dut->ascii_out | 0x100;  // Set bit 8 to indicate valid
     }
@@ -166,11 +217,61 @@ uint16_t receive_char() {
 }
 
 // Run until done, returns cycles taken
-uint64_t run_until_done(uint64_t max_cycles) {
+uint64_t run_until_done(Instance* inst, uint64_t max_cycles) {
     uint64_t cycles = 0;
-    while (!dut->done && cycles < max_cycles) {
-        clock_cycle();
-        cycles++;
+    sim_with_observe(inst, [&](auto observe) {
+        while (!inst->dut->done && cycles < max_cycles) {
+            sim_clock_cycle_t(inst, observe);
+            cycles++;
+        }
+    });
+    if (!inst->dut->done) {
+        sim_recorder_timeout(inst);
+    }
+    return cycles;
+}
+
+//==============================================================================
+// Streaming Functions
+//==============================================================================
+
+// Send len characters with the valid/ready handshake, holding ascii_in_valid
+// high across the whole buffer. Waits up to max_wait cycles per character.
+// Output produced meanwhile is not collected (run_polygon() keeps it).
+// Returns the number of characters accepted
+size_t send_buffer(Instance* inst, const uint8_t* buf, size_t len, uint32_t max_wait) {
+    return stream_input(inst, buf, len, max_wait, nullptr);
+}
+
+// Clock until done, collecting every ascii_out byte into out (up to cap bytes;
+// the rest are dropped). Stores the byte count in *out_len, returns cycles taken
+uint64_t drain_output(Instance* inst, uint8_t* out, size_t cap, size_t* out_len,
+                      uint64_t max_cycles) {
+    OutputSink sink = {out, cap};
+    uint64_t cycles = stream_output(inst, &sink, max_cycles);
+    if (out_len) {
+        *out_len = sink.len;
+    }
+    return cycles;
+}
+
+// Full ASCII-in to ASCII-out exchange: send input (which should include the
+// null terminator), then drain the result. ascii_out is collected from the
+// first input cycle on, so output that starts before the input is fully
+// accepted is kept. Returns the drain cycles, or 0 with *output_len = 0 if
+// the input was not fully accepted
+uint64_t run_polygon(Instance* inst, const uint8_t* input, size_t input_len,
+                     uint8_t* output, size_t output_cap, size_t* output_len,
+                     uint32_t max_wait, uint64_t max_cycles) {
+    OutputSink sink = {output, output_cap};
+    uint64_t cycles = 0;
+    if (stream_input(inst, input, input_len, max_wait, &sink) == input_len) {
+        cycles = stream_output(inst, &sink, max_cycles);
+    } else {
+        sink.len = 0;
+    }
+    if (output_len) {
+        *output_len = sink.len;
     }
     return cycles;
 }
@@ -1,20 +1,60 @@
 /**
  * C wrapper for impl_uart (UART Loopback) Verilator module.
  * Exposes module signals as C functions for Python ctypes.
+ *
+ * All functions take the opaque handle returned by create_instance().
  */
 
-#include "Vtop.h"
-#include "verilated.h"
-#include "verilated_fst_c.h"
+#include "sim_instance.h"
 #include <cstdint>
 
-static Vtop* dut = nullptr;
-static VerilatedContext* ctx = nullptr;
-static VerilatedFstC* tfp = nullptr;
-static uint64_t sim_time = 0;
-static uint64_t trace_from_cycle = 0;
-static uint64_t trace_to_cycle = UINT64_MAX;
-static bool tracing_enabled = false;
+struct Instance : SimInstance {};
+
+// Event bits for run_until_event()
+static constexpr uint32_t EVENT_TX = 1u << 0;  // tx line level
+static constexpr uint32_t EVENT_TX_BUSY = 1u << 1;
+static constexpr uint32_t EVENT_RX_BUSY = 1u << 2;
+static constexpr uint32_t EVENT_VALID = 1u << 3;
+static constexpr uint32_t EVENT_FRAME_ERROR = 1u << 4;
+static constexpr uint32_t EVENT_BREAK = 1u << 5;
+
+static inline uint32_t sample_events(Vtop* dut) {
+    return (dut->tx             ? EVENT_TX          : 0) |
+           (dut->busy           ? EVENT_TX_BUSY     : 0) |
+           (dut->busy__0241     ? EVENT_RX_BUSY     : 0) |
+           (dut->valid          ? EVENT_VALID       : 0) |
+           (dut->frame_error    ? EVENT_FRAME_ERROR : 0) |
+           (dut->break_detected ? EVENT_BREAK       : 0);
+}
+
+//==============================================================================
+// Flight Recorder Signals
+//==============================================================================
+
+static const RecorderSignal RECORDER_SIGNALS[] = {
+    {"tx_enable", 1},
+    {"data", 8},
+    {"busy", 1},
+    {"tx", 1},
+    {"rx_busy", 1},
+    {"rx_data", 8},
+    {"valid", 1},
+    {"frame_error", 1},
+    {"break_detected", 1},
+};
+static constexpr uint32_t NUM_RECORDER_SIGNALS = sizeof(RECORDER_SIGNALS) / sizeof(RECORDER_SIGNALS[0]);
+
+static void sample_signals(const Vtop* dut, uint64_t* out) {
+    out[0] = dut->tx_enable;
+    out[1] = dut->data;
+    out[2] = dut->busy;
+    out[3] = dut->tx;
+    out[4] = dut->busy__0241;
+    out[5] = dut->data__0242;
+    out[6] = dut->valid;
+    out[7] = dut->frame_error;
+    out[8] = dut->break_detected;
+}
 
 extern "C" {
 
@@ -22,119 +62,76 @@ extern "C" {
 // Lifecycle
 //==============================================================================
 
-void init_module() {
-    ctx = new VerilatedContext;
-    dut = new Vtop(ctx);
-    sim_time = 0;
-    // Reset sequence
-    dut->rst = 1;
-    for (int i = 0; i < 5; i++) {
-        dut->clk = 0; dut->eval();
-        dut->clk = 1; dut->eval();
-    }
-    dut->rst = 0;
+Instance* create_instance(uint32_t threads) {
+    Instance* inst = new Instance;
+    sim_init(inst, threads);
     // Initialize inputs
-    dut->tx_enable = 0;
-    dut->data = 0;
+    inst->dut->tx_enable = 0;
+    inst->dut->data = 0;
+    return inst;
 }
 
-void cleanup_module() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
-    }
-    if (dut) {
-        dut->final();
-        delete dut;
-        dut = nullptr;
-    }
-    if (ctx) {
-        delete ctx;
-        ctx = nullptr;
-    }
-    tracing_enabled = false;
+void destroy_instance(Instance* inst) {
+    if (!inst) return;
+    sim_cleanup(inst);
+    delete inst;
 }
 
 //==============================================================================
 // Waveform Control
 //==============================================================================
 
-void enable_waveform(const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-    }
-    tfp = new VerilatedFstC;
-    ctx->traceEverOn(true);
-    dut->trace(tfp, 99);
-    tfp->open(filename);
-    trace_from_cycle = from_cycle;
-    trace_to_cycle = to_cycle;
-    tracing_enabled = true;
+void enable_waveform(Instance* inst, const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
+    sim_enable_waveform(inst, filename, from_cycle, to_cycle);
 }
 
-void disable_waveform() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
-    }
-    tracing_enabled = false;
+void disable_waveform(Instance* inst) {
+    sim_disable_waveform(inst);
 }
 
+// 1 if this library was built with FST tracing, 0 for the trace-free variant
+uint8_t has_waveform_support() {
+    return SIM_TRACE;
+}
+
+#include "sim_signal_api.h"
+
 //==============================================================================
 // Clock
 //==============================================================================
 
-void clock_cycle() {
-    uint64_t cycle = sim_time / 2;
-
-    dut->clk = 0;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
-    }
-    sim_time++;
-
-    dut->clk = 1;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
-    }
-    sim_time++;
+void clock_cycle(Instance* inst) {
+    sim_clock_cycle(inst);
 }
 
-void clock_n(uint32_t n) {
-    for (uint32_t i = 0; i < n; i++) {
-        clock_cycle();
-    }
+void clock_n(Instance* inst, uint32_t n) {
+    sim_clock_n(inst, n);
 }
 
-uint64_t get_cycle_count() {
-    return sim_time / 2;
+uint64_t get_cycle_count(Instance* inst) {
+    return inst->sim_time / 2;
 }
 
 //==============================================================================
 // TX Signals (Testbench -> DUT)
 //==============================================================================
 
-void set_tx_enable(uint8_t v) { dut->tx_enable = v; }
-void set_data(uint8_t v) { dut->data = v; }
-uint8_t get_busy() { return dut->busy; }
-uint8_t get_tx() { return dut->tx; }
+void set_tx_enable(Instance* inst, uint8_t v) { inst->dut->tx_enable = v; }
+void set_data(Instance* inst, uint8_t v) { inst->dut->data = v; }
+uint8_t get_busy(Instance* inst) { return inst->dut->busy; }
+uint8_t get_tx(Instance* inst) { return inst->dut->tx; }
 
 //==============================================================================
 // RX Signals (DUT -> Testbench)
 //==============================================================================
 
 // Note: set_rx removed - rx is internally connected in LoopbackDevice
-uint8_t get_rx_busy() { return dut->busy__0241; }  // RX busy signal
-uint8_t get_rx_data() { return dut->data__0242; }  // RX data output
-uint8_t get_valid() { return dut->valid; }
-uint8_t get_frame_error() { return dut->frame_error; }
+uint8_t get_rx_busy(Instance* inst) { return inst->dut->busy__0241; }  // RX busy signal
+uint8_t get_rx_data(Instance* inst) { return inst->dut->data__0242; }  // RX data output
+uint8_t get_valid(Instance* inst) { return inst->dut->valid; }
+uint8_t get_frame_error(Instance* inst) { return inst->dut->frame_error; }
 // get_parity_ok removed - not available when parity is disabled
-uint8_t get_break_detected() { return dut->break_detected; }
+uint8_t get_break_detected(Instance* inst) { return inst->dut->break_detected; }
 
 //==============================================================================
 // Convenience Functions
@@ -142,30 +139,42 @@ uint8_t get_break_detected() { return dut->break_detected; }
 
 // Send a byte via TX (blocking)
 // Returns cycles taken
-uint32_t send_byte(uint8_t byte) {
+uint32_t send_byte(Instance* inst, uint8_t byte) {
+    Vtop* dut = inst->dut;
     dut->data = byte;
     dut->tx_enable = 1;
-    clock_cycle();
+    sim_clock_cycle(inst);
     dut->tx_enable = 0;
 
     uint32_t cycles = 1;
-    while (dut->busy) {
-        clock_cycle();
-        cycles++;
-    }
+    sim_with_observe(inst, [&](auto observe) {
+        while (dut->busy) {
+            sim_clock_cycle_t(inst, observe);
+            cycles++;
+        }
+    });
     return cycles;
 }
 
 // Wait for RX valid and return received byte
 // Returns byte in lower 8 bits, bit 8 set if valid, 0 if timeout
-uint16_t receive_byte(uint32_t max_cycles) {
-    for (uint32_t i = 0; i < max_cycles; i++) {
-        if (dut->valid) {
-            return dut->data__0242 | 0x100;
+uint16_t receive_byte(Instance* inst, uint32_t max_cycles) {
+    Vtop* dut = inst->dut;
+    return sim_with_observe(inst, [&](auto observe) -> uint16_t {
+        for (uint32_t i = 0; i < max_cycles; i++) {
+            if (dut->valid) {
+                return dut->data__0242 | 0x100;
+            }
+            sim_clock_cycle_t(inst, observe);
         }
-        clock_cycle();
-    }
-    return 0;
+        return 0;
+    });
+}
+
+// Clock until any output selected by mask (EVENT_* bits) changes level.
+// Stores the changed bits in *fired (0 on timeout), returns cycles taken
+uint64_t run_until_event(Instance* inst, uint64_t max_cycles, uint32_t mask, uint32_t* fired) {
+    return sim_run_until_event(inst, max_cycles, mask, fired, sample_events);
 }
 
 } // extern "C"
@@ -1,20 +1,167 @@
 /**
  * C wrapper for impl_uart_bridge (UartBridgeTop) Verilator module.
  * Exposes module signals as C functions for Python ctypes.
+ *
+ * All functions take the opaque handle returned by create_instance().
  */
 
-#include "Vtop.h"
-#include "verilated.h"
-#include "verilated_fst_c.h"
+#include "sim_instance.h"
 #include <cstdint>
+#include <cstddef>
+#include <cstdio>
 
-static Vtop* dut = nullptr;
-static VerilatedContext* ctx = nullptr;
-static VerilatedFstC* tfp = nullptr;
-static uint64_t sim_time = 0;
-static uint64_t trace_from_cycle = 0;
-static uint64_t trace_to_cycle = UINT64_MAX;
-static bool tracing_enabled = false;
+struct Instance : SimInstance {};
+
+// Event bits for run_until_event()
+static constexpr uint32_t EVENT_UART_TX = 1u << 0;  // uart_tx line level
+static constexpr uint32_t EVENT_TX_READY = 1u << 1;
+static constexpr uint32_t EVENT_TX_OVERFLOW = 1u << 2;
+static constexpr uint32_t EVENT_RX_VALID = 1u << 3;
+static constexpr uint32_t EVENT_RX_OVERFLOW = 1u << 4;
+static constexpr uint32_t EVENT_PROCESSING = 1u << 5;
+static constexpr uint32_t EVENT_DONE = 1u << 6;
+
+static inline uint32_t sample_events(Vtop* dut) {
+    return (dut->uart_tx     ? EVENT_UART_TX     : 0) |
+           (dut->tx_ready    ? EVENT_TX_READY    : 0) |
+           (dut->tx_overflow ? EVENT_TX_OVERFLOW : 0) |
+           (dut->rx_valid    ? EVENT_RX_VALID    : 0) |
+           (dut->rx_overflow ? EVENT_RX_OVERFLOW : 0) |
+           (dut->processing  ? EVENT_PROCESSING  : 0) |
+           (dut->done        ? EVENT_DONE        : 0);
+}
+
+//==============================================================================
+// Host UART Model
+//
+// Bit-level serializer/deserializer for the testbench side of the serial
+// link (8N1, LSB first). Mirrors the state machines previously implemented
+// in impl_uart_bridge.py so cycle counts are unchanged.
+//==============================================================================
+
+// Testbench -> DUT: drives uart_rx
+struct HostTx {
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+    size_t pos = 0;
+    uint32_t baud_div = 0;
+    uint16_t shift_reg = 0xFFFF;  // Idle high
+    uint32_t bit_counter = 0;
+    uint32_t cycle_counter = 0;
+    bool transmitting = false;
+
+    bool idle() const { return !transmitting && pos >= len; }
+
+    // Process one clock cycle, returns current TX line value
+    uint8_t tick() {
+        // Start new transmission if idle and have data
+        if (!transmitting && pos < len) {
+            // Build frame: [stop=1][data][start=0]
+            shift_reg = (1u << 9) | (static_cast<uint16_t>(data[pos++]) << 1);
+            bit_counter = 10;  // 1 start + 8 data + 1 stop
+            cycle_counter = baud_div;
+            transmitting = true;
+        }
+
+        uint8_t output = 1;  // Idle high
+
+        if (transmitting) {
+            output = shift_reg & 1;
+            if (--cycle_counter == 0) {
+                shift_reg = (shift_reg >> 1) | (1u << 15);  // Shift in 1s
+                cycle_counter = baud_div;
+                if (--bit_counter == 0) {
+                    transmitting = false;
+                }
+            }
+        }
+        return output;
+    }
+};
+
+// DUT -> Testbench: samples uart_tx
+struct HostRx {
+    enum State { IDLE, START, DATA, STOP };
+
+    uint32_t baud_div = 0;
+    State state = IDLE;
+    uint32_t bit_counter = 0;
+    uint32_t cycle_counter = 0;
+    uint8_t shift_reg = 0;
+
+    // Process one clock cycle, returns received byte with bit 8 set, or 0
+    uint16_t tick(uint8_t rx_bit) {
+        uint16_t result = 0;
+
+        switch (state) {
+        case IDLE:  // Wait for start bit
+            if (rx_bit == 0) {
+                state = START;
+                // Sample at midpoint, at least one cycle on so baud_div 1
+                // does not wrap the countdown
+                cycle_counter = baud_div > 1 ? baud_div / 2 : 1;
+            }
+            break;
+        case START:  // Start bit verification
+            if (--cycle_counter == 0) {
+                if (rx_bit == 0) {
+                    state = DATA;
+                    bit_counter = 0;
+                    cycle_counter = baud_div;
+                    shift_reg = 0;
+                } else {
+                    state = IDLE;  // False start
+                }
+            }
+            break;
+        case DATA:
+            if (--cycle_counter == 0) {
+                shift_reg = (shift_reg >> 1) | (rx_bit << 7);
+                cycle_counter = baud_div;
+                if (++bit_counter == 8) {
+                    state = STOP;
+                }
+            }
+            break;
+        case STOP:
+            if (--cycle_counter == 0) {
+                if (rx_bit == 1) {
+                    result = shift_reg | 0x100;
+                }
+                state = IDLE;
+            }
+            break;
+        }
+        return result;
+    }
+};
+
+//==============================================================================
+// Flight Recorder Signals
+//==============================================================================
+
+static const RecorderSignal RECORDER_SIGNALS[] = {
+    {"uart_rx", 1},
+    {"uart_tx", 1},
+    {"tx_ready", 1},
+    {"tx_overflow", 1},
+    {"rx_valid", 1},
+    {"rx_overflow", 1},
+    {"processing", 1},
+    {"done", 1},
+};
+static constexpr uint32_t NUM_RECORDER_SIGNALS = sizeof(RECORDER_SIGNALS) / sizeof(RECORDER_SIGNALS[0]);
+
+static void sample_signals(const Vtop* dut, uint64_t* out) {
+    out[0] = dut->uart_rx;
+    out[1] = dut->uart_tx;
+    out[2] = dut->tx_ready;
+    out[3] = dut->tx_overflow;
+    out[4] = dut->rx_valid;
+    out[5] = dut->rx_overflow;
+    out[6] = dut->processing;
+    out[7] = dut->done;
+}
 
 extern "C" {
 
@@ -22,131 +169,196 @@ extern "C" {
 // Lifecycle
 //==============================================================================
 
-void init_module() {
-    ctx = new VerilatedContext;
-    dut = new Vtop(ctx);
-    sim_time = 0;
-    // Reset sequence
-    dut->rst = 1;
-    for (int i = 0; i < 5; i++) {
-        dut->clk = 0; dut->eval();
-        dut->clk = 1; dut->eval();
-    }
-    dut->rst = 0;
+Instance* create_instance(uint32_t threads) {
+    Instance* inst = new Instance;
+    sim_init(inst, threads);
     // Initialize inputs
-    dut->uart_rx = 1;  // Idle high
+    inst->dut->uart_rx = 1;  // Idle high
+    return inst;
 }
 
-void cleanup_module() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
-    }
-    if (dut) {
-        dut->final();
-        delete dut;
-        dut = nullptr;
-    }
-    if (ctx) {
-        delete ctx;
-        ctx = nullptr;
-    }
-    tracing_enabled = false;
+void destroy_instance(Instance* inst) {
+    if (!inst) return;
+    sim_cleanup(inst);
+    delete inst;
+}
+
+// Reset the model in place for the next polygon instead of a destroy +
+// create round trip. Attached waveforms and recorders stay open
+void reset_dut(Instance* inst) {
+    inst->dut->uart_rx = 1;  // Idle high
+    sim_reset(inst);
 }
 
 //==============================================================================
 // Waveform Control
 //==============================================================================
 
-void enable_waveform(const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-    }
-    tfp = new VerilatedFstC;
-    ctx->traceEverOn(true);
-    dut->trace(tfp, 99);
-    tfp->open(filename);
-    trace_from_cycle = from_cycle;
-    trace_to_cycle = to_cycle;
-    tracing_enabled = true;
-}
-
-void disable_waveform() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
-    }
-    tracing_enabled = false;
+void enable_waveform(Instance* inst, const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
+    sim_enable_waveform(inst, filename, from_cycle, to_cycle);
+}
+
+void disable_waveform(Instance* inst) {
+    sim_disable_waveform(inst);
+}
+
+// 1 if this library was built with FST tracing, 0 for the trace-free variant
+uint8_t has_waveform_support() {
+    return SIM_TRACE;
 }
 
+#include "sim_signal_api.h"
+
 //==============================================================================
-// Clock
+// Checkpoints
 //==============================================================================
 
-void clock_cycle() {
-    uint64_t cycle = sim_time / 2;
+// Save/restore the model (requires a --savable build), returns 1 on success
+uint8_t save_checkpoint(Instance* inst, const char* path) {
+    return sim_save_checkpoint(inst, path);
+}
 
-    dut->clk = 0;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
-    }
-    sim_time++;
+uint8_t restore_checkpoint(Instance* inst, const char* path) {
+    return sim_restore_checkpoint(inst, path);
+}
 
-    dut->clk = 1;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
-    }
-    sim_time++;
+//==============================================================================
+// Clock
+//==============================================================================
+
+void clock_cycle(Instance* inst) {
+    sim_clock_cycle(inst);
 }
 
-void clock_n(uint32_t n) {
-    for (uint32_t i = 0; i < n; i++) {
-        clock_cycle();
-    }
+void clock_n(Instance* inst, uint32_t n) {
+    sim_clock_n(inst, n);
 }
 
-uint64_t get_cycle_count() {
-    return sim_time / 2;
+uint64_t get_cycle_count(Instance* inst) {
+    return inst->sim_time / 2;
 }
 
 //==============================================================================
 // UART Signals
 //==============================================================================
 
-void set_uart_rx(uint8_t v) { dut->uart_rx = v; }
-uint8_t get_uart_tx() { return dut->uart_tx; }
+void set_uart_rx(Instance* inst, uint8_t v) { inst->dut->uart_rx = v; }
+uint8_t get_uart_tx(Instance* inst) { return inst->dut->uart_tx; }
 
 //==============================================================================
 // Flow Control Signals
 //==============================================================================
 
-uint8_t get_tx_ready() { return dut->tx_ready; }
-uint8_t get_tx_overflow() { return dut->tx_overflow; }
-uint8_t get_rx_valid() { return dut->rx_valid; }
-uint8_t get_rx_overflow() { return dut->rx_overflow; }
+uint8_t get_tx_ready(Instance* inst) { return inst->dut->tx_ready; }
+uint8_t get_tx_overflow(Instance* inst) { return inst->dut->tx_overflow; }
+uint8_t get_rx_valid(Instance* inst) { return inst->dut->rx_valid; }
+uint8_t get_rx_overflow(Instance* inst) { return inst->dut->rx_overflow; }
 
 //==============================================================================
 // Status Signals
 //==============================================================================
 
-uint8_t get_processing() { return dut->processing; }
-uint8_t get_done() { return dut->done; }
+uint8_t get_processing(Instance* inst) { return inst->dut->processing; }
+uint8_t get_done(Instance* inst) { return inst->dut->done; }
 
 //==============================================================================
 // Convenience Functions
 //==============================================================================
 
 // Run until done, returns cycles taken
-uint64_t run_until_done(uint64_t max_cycles) {
+uint64_t run_until_done(Instance* inst, uint64_t max_cycles) {
+    uint64_t cycles = 0;
+    sim_with_observe(inst, [&](auto observe) {
+        while (!inst->dut->done && cycles < max_cycles) {
+            sim_clock_cycle_t(inst, observe);
+            cycles++;
+        }
+    });
+    if (!inst->dut->done) {
+        sim_recorder_timeout(inst);
+    }
+    return cycles;
+}
+
+// Clock until any output selected by mask (EVENT_* bits) changes level,
+// holding uart_rx at its current value. Stores the changed bits in *fired
+// (0 on timeout), returns cycles taken
+uint64_t run_until_event(Instance* inst, uint64_t max_cycles, uint32_t mask, uint32_t* fired) {
+    return sim_run_until_event(inst, max_cycles, mask, fired, sample_events);
+}
+
+// Stream an input buffer through the serial link and collect the response.
+// Drives uart_rx from the host TX model and decodes uart_tx with the host RX
+// model every cycle. Once the DUT reports done and the input is fully sent,
+// keeps clocking for a drain window of baud_div * 150 cycles (enough for the
+// longest result line) before returning.
+// Received bytes are stored in output (up to output_cap, extra bytes are
+// dropped) and the stored count is written to *output_len.
+// Returns cycles taken, 0 without clocking for baud_div 0.
+uint64_t run_polygon(Instance* inst, const uint8_t* input, size_t input_len,
+                     uint8_t* output, size_t output_cap, size_t* output_len,
+                     uint32_t baud_div, uint64_t max_cycles, uint8_t verbose) {
+    Vtop* dut = inst->dut;
+    if (baud_div == 0) {
+        if (output_len) {
+            *output_len = 0;
+        }
+        return 0;
+    }
+
+    HostTx tx;
+    tx.data = input;
+    tx.len = input_len;
+    tx.baud_div = baud_div;
+
+    HostRx rx;
+    rx.baud_div = baud_div;
+
+    size_t received = 0;
+    auto collect = [&](uint16_t r) {
+        if ((r & 0x100) && received < output_cap) {
+            output[received++] = r & 0xFF;
+        }
+    };
+
     uint64_t cycles = 0;
-    while (!dut->done && cycles < max_cycles) {
-        clock_cycle();
-        cycles++;
+    uint64_t last_progress = 0;
+    bool finished = false;
+
+    sim_with_observe(inst, [&](auto observe) {
+        while (cycles < max_cycles) {
+            dut->uart_rx = tx.tick();
+            sim_clock_cycle_t(inst, observe);
+            collect(rx.tick(dut->uart_tx));
+            cycles++;
+
+            if (dut->done && tx.idle()) {
+                // Drain remaining output (max 14 bytes: 13 digits + newline)
+                uint64_t drain = static_cast<uint64_t>(baud_div) * 150;
+                for (uint64_t i = 0; i < drain; i++) {
+                    dut->uart_rx = 1;  // Idle
+                    sim_clock_cycle_t(inst, observe);
+                    collect(rx.tick(dut->uart_tx));
+                    cycles++;
+                }
+                finished = true;
+                break;
+            }
+
+            if (verbose && cycles - last_progress >= 10000000) {
+                fprintf(stderr, "Cycle %luM, TX pending: %zu, output len: %zu\n",
+                        static_cast<unsigned long>(cycles / 1000000), tx.len - tx.pos, received);
+                last_progress = cycles;
+            }
+        }
+    });
+
+    if (!finished) {
+        sim_recorder_timeout(inst);
+    }
+
+    if (output_len) {
+        *output_len = received;
     }
     return cycles;
 }
@@ -1,178 +1,1268 @@
 /**
  * C wrapper for rtl_max_rect (MaxRectangleFinder) Verilator module.
  * Exposes module signals as C functions for Python ctypes.
+ *
+ * All functions take the opaque handle returned by create_instance().
  */
 
-#include "Vtop.h"
-#include "verilated.h"
-#include "verilated_fst_c.h"
+#include "sim_instance.h"
+#include "max_rect_ref.h"
+#include "dram_model.h"
+#include "async_run.h"
+
+// Model Verilated with --vpi and rtl_max_rect_preload.vlt, which makes the
+// vertex BRAMs, num_vertices, poly_loaded and fsm_state writable for
+// preload_vertices()
+#ifndef RTL_MAX_RECT_PRELOAD
+#define RTL_MAX_RECT_PRELOAD 0
+#endif
+#if RTL_MAX_RECT_PRELOAD
+#include "verilated_vpi.h"
+#endif
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-static Vtop* dut = nullptr;
-static VerilatedContext* ctx = nullptr;
-static VerilatedFstC* tfp = nullptr;
-static uint64_t sim_time = 0;
-static uint64_t trace_from_cycle = 0;
-static uint64_t trace_to_cycle = UINT64_MAX;
-static bool tracing_enabled = false;
+// debug_state is 4 bits wide
+static constexpr uint32_t NUM_FSM_STATES = 16;
 
-extern "C" {
+// Validator lanes the model was generated with (MaxRectangleFinder num_lanes).
+// Multi-lane models have a lane_busy port; single-lane ones do not.
+#ifndef RTL_MAX_RECT_LANES
+#define RTL_MAX_RECT_LANES 1
+#endif
+static constexpr uint32_t NUM_LANES = RTL_MAX_RECT_LANES;
+
+// Model generated with MaxRectangleFinder area_order=True (bucketed passes)
+#ifndef RTL_MAX_RECT_AREA_ORDER
+#define RTL_MAX_RECT_AREA_ORDER 0
+#endif
+static constexpr bool AREA_ORDER = RTL_MAX_RECT_AREA_ORDER;
+
+// Model generated with a validator edge index (MaxRectangleFinder
+// edge_index_block > 0), which adds the edges_examined/edges_skipped ports
+#ifndef RTL_MAX_RECT_EDGE_INDEX
+#define RTL_MAX_RECT_EDGE_INDEX 0
+#endif
+
+// Model generated with external vertex memory (MaxRectangleFinder
+// cache_lines > 0): the polygon lives in a DramModel and is fetched through
+// the vertex cache's memory port, LINE_VERTICES words per burst
+#ifndef RTL_MAX_RECT_EXTERNAL
+#define RTL_MAX_RECT_EXTERNAL 0
+#endif
+#ifndef RTL_MAX_RECT_LINE_VERTICES
+#define RTL_MAX_RECT_LINE_VERTICES 8
+#endif
+
+// Vertex words are {y, x}, COORD_WIDTH bits each
+static constexpr uint32_t COORD_WIDTH = 20;
+
+// FSM encoding (debug_state) used by the scoreboard and preload
+static constexpr uint8_t STATE_IDLE = 0;
+static constexpr uint8_t STATE_WAIT_START = 2;
+static constexpr uint8_t STATE_LOAD_POLY_ONCE = 3;
+static constexpr uint8_t STATE_INIT_SEARCH = 4;
+static constexpr uint8_t STATE_GENERATE_RECT = 7;
+static constexpr uint8_t STATE_VALIDATE_WAIT = 8;
+static constexpr uint8_t STATE_NEXT_RECT = 9;
+static constexpr uint8_t STATE_COMPLETE = 11;
+
+// Validator verdicts (verdict_outcome, single-lane models only), encoded as
+// the scoreboard's reference kernel
+static constexpr uint32_t NUM_VERDICT_OUTCOMES = 4;  // Valid, CHECK 1, CHECK 2, corner
+static constexpr uint32_t VERDICT_CHECK1 = max_rect_ref::VERDICT_CHECK1;
+static constexpr uint32_t VERDICT_CHECK2 = max_rect_ref::VERDICT_CHECK2;
+static constexpr uint32_t NUM_LATENCY_BUCKETS = 32;  // log2 buckets of verdict_cycles
+static constexpr uint32_t NUM_EXIT_BINS = 16;        // Exit position per polygon edge count
+
+// Per-candidate validation statistics, in get_verdict_stats() order
+struct VerdictStats {
+    uint64_t count[NUM_VERDICT_OUTCOMES];
+    uint64_t cycles[NUM_VERDICT_OUTCOMES];
+    uint64_t latency[NUM_VERDICT_OUTCOMES][NUM_LATENCY_BUCKETS];  // Bucket b: [2**(b-1), 2**b)
+    uint64_t exit_bins[2][NUM_EXIT_BINS];  // CHECK 1 / CHECK 2 exit position
+    uint64_t exit_edges;                   // Edges the rejections walked, failing one included
+    uint64_t exit_full_edges;              // Edges full scans would have walked (n + 1 each)
+};
+static constexpr uint32_t VERDICT_STATS_FIELDS = sizeof(VerdictStats) / sizeof(uint64_t);
+
+// Scoreboard mismatch kinds
+static constexpr uint64_t MISMATCH_VERDICT = 1;  // verdict_outcome differs from the reference
+static constexpr uint64_t MISMATCH_DISPATCH = 2; // Validated vs skipped/pruned differs
+static constexpr uint64_t MISMATCH_PASS = 3;     // Area order: next bucket pass vs complete
+static constexpr uint64_t MISMATCH_FAIL_EDGE = 4;  // Same CHECK 1/2 exit, other fail edge
+
+// First scoreboard mismatch, in get_scoreboard_mismatch() order. For pass
+// mismatches i is the bucket whose pass just ended and the rectangle is zero.
+struct Mismatch {
+    uint64_t cycle, kind, i, j;
+    uint64_t rect_x, rect_y, rect_width, rect_height;
+    uint64_t expected, got;
+};
+static constexpr uint32_t MISMATCH_FIELDS = sizeof(Mismatch) / sizeof(uint64_t);
+
+// Result of one run_jobs() job, in output order
+struct JobResult {
+    uint64_t done, valid, max_area;
+    uint64_t rectangles_tested, rectangles_pruned;
+    uint64_t load_cycles, search_cycles;
+    uint64_t scoreboard_checked, scoreboard_mismatches;
+};
+static constexpr uint32_t JOB_RESULT_FIELDS = sizeof(JobResult) / sizeof(uint64_t);
+
+// Lockstep checker for the validator handshake. validator.start is the
+// GENERATE_RECT -> VALIDATE_WAIT transition, and the verdict is read from
+// the verdict_* ports on the verdict_valid strobe. The candidate is tracked
+// by replaying the (i, j) pair order, once per bucket pass in area-order
+// models, and checked with the RTL-semantics reference kernel from the
+// finder's start-vertex hint.
+struct Scoreboard {
+    std::vector<uint32_t> xy;       // Polygon as loaded into the DUT
+    std::vector<int64_t> vx, vy;
+    max_rect_ref::Edges edges;
+    uint32_t i = 0, j = 1;          // Pair the next GENERATE_RECT evaluates
+    int64_t max_area = 0;           // Follows the DUT's max_area_reg
+    max_rect_ref::Candidate cand = {};  // Candidate being validated
+    uint32_t cand_i = 0, cand_j = 0;
+    uint32_t start_vertex = 0;      // Follows the finder's start_vertex_reg
+    bool pending = false;           // cand started, verdict not yet seen
+    max_rect_ref::RtlVerdict expect = {};
+    bool histogram = false;         // Area order: bucket pre-pass, nothing validated
+    uint64_t buckets = 0;           // Area order: occupied buckets not yet searched
+    int cur_bucket = 0;
+    bool stop_on_mismatch = false;
+    bool halted = false;            // Stop run_until_done at the mismatch
+    uint64_t checked = 0;           // Validator verdicts compared
+    uint64_t mismatches = 0;
+    Mismatch first = {};
+};
+
+struct Instance : SimInstance {
+    // FSM state-occupancy profile (optional, off by default)
+    bool profiling = false;
+    uint8_t last_state = 0xFF;
+    uint64_t state_cycles[NUM_FSM_STATES] = {};
+    uint64_t state_entries[NUM_FSM_STATES] = {};
+    uint64_t lane_busy_cycles[NUM_LANES] = {};
+    VerdictStats verdicts = {};
+
+    // Polygon streamed by load_vertex()/load_vertices(), complete after vertex_last
+    std::vector<uint32_t> loaded_xy;
+    bool load_complete = false;
+
+    Scoreboard* scoreboard = nullptr;  // Optional, off by default
+    bool monitoring = false;           // profiling || scoreboard
+
+    DramModel dram;                    // External vertex memory (external models only)
+
+    AsyncRun async;                    // Background search started by start_async()
+};
+
+static inline void update_monitoring(Instance* inst) {
+    inst->monitoring = inst->profiling || inst->scoreboard;
+}
+
+// Lanes with a candidate in validation. The single lane is busy for as long
+// as the FSM waits for it in VALIDATE_WAIT.
+static inline uint32_t lane_busy_mask(const Vtop* dut, uint8_t state) {
+#if RTL_MAX_RECT_LANES > 1
+    (void)state;
+    return dut->lane_busy;
+#else
+    (void)dut;
+    return state == STATE_VALIDATE_WAIT;
+#endif
+}
+
+// Validator verdict on the verdict_* ports after this edge
+struct Verdict {
+    uint32_t outcome;
+    uint64_t cycles;
+    uint64_t fail_edge, start_edge;
+};
+
+// Multi-lane models have no verdict ports, and neither has a tracked netlist
+// generated from RTL older than them (kept when Amaranth is not installed),
+// so they are detected on the model instead of assumed
+template <typename Dut, typename = void>
+struct HasVerdictPorts : std::false_type {};
+template <typename Dut>
+struct HasVerdictPorts<Dut, std::void_t<decltype(std::declval<Dut&>().verdict_valid)>>
+    : std::true_type {};
+static constexpr bool VERDICT_PORTS = HasVerdictPorts<Vtop>::value;
+
+// False without a verdict this cycle, and always without verdict ports
+template <typename Dut>
+static inline bool read_verdict(const Dut* dut, Verdict* v) {
+    if constexpr (HasVerdictPorts<Dut>::value) {
+        if (!dut->verdict_valid) {
+            return false;
+        }
+        v->outcome = dut->verdict_outcome & (NUM_VERDICT_OUTCOMES - 1);
+        v->cycles = dut->verdict_cycles;
+        v->fail_edge = dut->verdict_fail_edge;
+        v->start_edge = dut->verdict_start_edge;
+        return true;
+    } else {
+        (void)dut;
+        (void)v;
+        return false;
+    }
+}
+
+static const char* mismatch_name(uint64_t kind) {
+    switch (kind) {
+    case MISMATCH_VERDICT: return "verdict";
+    case MISMATCH_DISPATCH: return "dispatch";
+    case MISMATCH_PASS: return "pass";
+    case MISMATCH_FAIL_EDGE: return "fail_edge";
+    default: return "unknown";
+    }
+}
+
+static void scoreboard_report(Instance* inst, const Mismatch& m) {
+    Scoreboard* sb = inst->scoreboard;
+    sb->mismatches++;
+    if (sb->mismatches > 1) {
+        return;
+    }
+    sb->first = m;
+    fprintf(stderr, "Scoreboard mismatch at cycle %llu: %s for pair (%llu, %llu), "
+                    "rect x=%llu y=%llu w=%llu h=%llu: expected %llu, got %llu\n",
+            static_cast<unsigned long long>(m.cycle),
+            mismatch_name(m.kind),
+            static_cast<unsigned long long>(m.i), static_cast<unsigned long long>(m.j),
+            static_cast<unsigned long long>(m.rect_x), static_cast<unsigned long long>(m.rect_y),
+            static_cast<unsigned long long>(m.rect_width),
+            static_cast<unsigned long long>(m.rect_height),
+            static_cast<unsigned long long>(m.expected), static_cast<unsigned long long>(m.got));
+    if (sim_dump_recorder(inst, nullptr)) {
+        fprintf(stderr, "Flight recorder written at mismatch\n");
+    }
+    if (sb->stop_on_mismatch) {
+        sb->halted = true;
+    }
+}
+
+static void scoreboard_init_search(Instance* inst) {
+    Scoreboard* sb = inst->scoreboard;
+    const std::vector<uint32_t>& xy = sb->xy.empty() ? inst->loaded_xy : sb->xy;
+    size_t n = xy.size() / 2;
+    sb->vx.resize(n);
+    sb->vy.resize(n);
+    for (size_t k = 0; k < n; k++) {
+        sb->vx[k] = xy[2 * k];
+        sb->vy[k] = xy[2 * k + 1];
+    }
+    sb->edges.assign(sb->vx, sb->vy);
+    if (n != inst->dut->debug_num_vertices) {
+        fprintf(stderr, "Scoreboard: %zu reference vertices, DUT has %u\n", n,
+                static_cast<unsigned>(inst->dut->debug_num_vertices));
+    }
+    sb->i = 0;
+    sb->j = 1;
+    sb->max_area = 0;
+    sb->start_vertex = 0;
+    sb->pending = false;
+
+    sb->histogram = AREA_ORDER;
+    sb->buckets = 0;
+    sb->cur_bucket = 0;
+    if (AREA_ORDER) {
+        for (size_t a = 0; a < n; a++) {
+            for (size_t b = a + 1; b < n; b++) {
+                int64_t w = sb->vx[a] < sb->vx[b] ? sb->vx[b] - sb->vx[a] : sb->vx[a] - sb->vx[b];
+                int64_t h = sb->vy[a] < sb->vy[b] ? sb->vy[b] - sb->vy[a] : sb->vy[a] - sb->vy[b];
+                if (w != 0 && h != 0) {
+                    sb->buckets |= 1ull << max_rect_ref::area_bucket((w + 4) * (h + 4));
+                }
+            }
+        }
+    }
+}
+
+// Area order: advance to the highest remaining bucket whose largest area
+// (2**b - 1) beats the max. Returns false if the search should complete.
+static bool scoreboard_next_pass(Scoreboard* sb) {
+    uint64_t remaining = sb->buckets & ~(1ull << sb->cur_bucket);
+    if (!remaining) {
+        return false;
+    }
+    int next = 63 - __builtin_clzll(remaining);
+    if ((1ll << next) - 1 <= sb->max_area) {
+        return false;
+    }
+    sb->histogram = false;
+    sb->buckets = remaining;
+    sb->cur_bucket = next;
+    sb->i = 0;
+    sb->j = 1;
+    return true;
+}
+
+// Called after a clock edge with the FSM state before it
+static void scoreboard_step(Instance* inst, uint8_t state) {
+    Scoreboard* sb = inst->scoreboard;
+    Vtop* dut = inst->dut;
+    uint8_t next = dut->debug_state;
+    uint64_t cycle = inst->sim_time / 2 - 1;
+
+    // A preloaded polygon goes straight from WAIT_START to INIT_SEARCH
+    if ((state == STATE_LOAD_POLY_ONCE || state == STATE_WAIT_START) && next == STATE_INIT_SEARCH) {
+        scoreboard_init_search(inst);
+    } else if (AREA_ORDER && state == STATE_NEXT_RECT &&
+               (next == STATE_INIT_SEARCH || next == STATE_COMPLETE)) {
+        uint64_t bucket = static_cast<uint64_t>(sb->cur_bucket);
+        bool expect_pass = scoreboard_next_pass(sb);
+        bool got_pass = next == STATE_INIT_SEARCH;
+        if (expect_pass != got_pass) {
+            scoreboard_report(inst, {cycle, MISMATCH_PASS, bucket, 0, 0, 0, 0, 0,
+                                     expect_pass, got_pass});
+        }
+    } else if (state == STATE_GENERATE_RECT) {
+        if (sb->j >= sb->vx.size()) {
+            return;  // Reference polygon shorter than the DUT's; already reported
+        }
+        int64_t xi = sb->vx[sb->i], yi = sb->vy[sb->i];
+        int64_t xj = sb->vx[sb->j], yj = sb->vy[sb->j];
+        max_rect_ref::Candidate& c = sb->cand;
+        c.x = xi < xj ? xi : xj;
+        c.y = yi < yj ? yi : yj;
+        c.w = (xi < xj ? xj : xi) - c.x;
+        c.h = (yi < yj ? yj : yi) - c.y;
+        c.area = (c.w + 4) * (c.h + 4);
+
+        bool expect_start = c.w != 0 && c.h != 0 && c.area > sb->max_area;
+        if (AREA_ORDER) {
+            expect_start = expect_start && !sb->histogram &&
+                           max_rect_ref::area_bucket(c.area) == sb->cur_bucket;
+        }
+        bool got_start = next == STATE_VALIDATE_WAIT;
+        if (expect_start != got_start) {
+            scoreboard_report(inst, {cycle, MISMATCH_DISPATCH, sb->i, sb->j,
+                                     static_cast<uint64_t>(c.x), static_cast<uint64_t>(c.y),
+                                     static_cast<uint64_t>(c.w), static_cast<uint64_t>(c.h),
+                                     expect_start, got_start});
+        }
+        if (got_start) {
+            sb->pending = true;
+            sb->cand_i = sb->i;
+            sb->cand_j = sb->j;
+            sb->expect = max_rect_ref::validate_rectangle_rtl(sb->edges, c, sb->start_vertex);
+        }
+        if (++sb->j >= sb->vx.size()) {
+            sb->i++;
+            sb->j = sb->i + 1;
+        }
+    } else if (state == STATE_VALIDATE_WAIT && next == STATE_NEXT_RECT) {
+        sb->max_area = static_cast<int64_t>(dut->debug_max_area);  // Follow the DUT
+    }
+
+    Verdict v;
+    if (sb->pending && read_verdict(dut, &v)) {
+        sb->pending = false;
+        sb->checked++;
+        const max_rect_ref::Candidate& c = sb->cand;
+        Mismatch m = {cycle, 0, sb->cand_i, sb->cand_j,
+                      static_cast<uint64_t>(c.x), static_cast<uint64_t>(c.y),
+                      static_cast<uint64_t>(c.w), static_cast<uint64_t>(c.h), 0, 0};
+        bool exited = v.outcome == VERDICT_CHECK1 || v.outcome == VERDICT_CHECK2;
+        if (v.outcome != static_cast<uint32_t>(sb->expect.outcome)) {
+            m.kind = MISMATCH_VERDICT;
+            m.expected = static_cast<uint64_t>(sb->expect.outcome);
+            m.got = v.outcome;
+            scoreboard_report(inst, m);
+        } else if (exited && v.fail_edge != sb->expect.fail_edge) {
+            m.kind = MISMATCH_FAIL_EDGE;
+            m.expected = sb->expect.fail_edge;
+            m.got = v.fail_edge;
+            scoreboard_report(inst, m);
+        }
+        // The next walk starts where this one exited (finder start_vertex_reg),
+        // following the DUT so one mismatch is not reported again downstream
+        sb->start_vertex = exited ? static_cast<uint32_t>(v.fail_edge) : 0;
+    }
+}
+
+// Count the verdict of a candidate whose validation just finished
+static inline void record_verdict(Instance* inst) {
+    Verdict d;
+    if (!read_verdict(inst->dut, &d)) {
+        return;
+    }
+    VerdictStats& v = inst->verdicts;
+    uint32_t bucket = d.cycles ? 64 - __builtin_clzll(d.cycles) : 0;
+    v.count[d.outcome]++;
+    v.cycles[d.outcome] += d.cycles;
+    v.latency[d.outcome][bucket < NUM_LATENCY_BUCKETS ? bucket : NUM_LATENCY_BUCKETS - 1]++;
+
+    // The walk starts at verdict_start_edge and wraps around the polygon. A
+    // full walk checks n + 1 edges, the start edge twice, as the validator's
+    // edge counter does; a CHECK 1/2 exit comes within the first n
+    uint64_t n = inst->dut->debug_num_vertices;
+    if ((d.outcome == VERDICT_CHECK1 || d.outcome == VERDICT_CHECK2) && n) {
+        uint64_t walked = (d.fail_edge + n - d.start_edge) % n + 1;
+        v.exit_bins[d.outcome - VERDICT_CHECK1][(walked - 1) * NUM_EXIT_BINS / n]++;
+        v.exit_edges += walked;
+        v.exit_full_edges += n + 1;
+    }
+}
+
+// Clock one cycle, attributing it to the FSM state held during the cycle and
+// checking validator transactions against the reference model. Monitor and
+// Observe are std::true_type or std::false_type (see with_step_mode).
+template <typename Monitor, typename Observe>
+static inline void step_t(Instance* inst, Monitor, Observe observe) {
+    constexpr bool kMonitor = Monitor::value;
+    uint8_t state = 0;
+    if (kMonitor) {
+        state = inst->dut->debug_state & (NUM_FSM_STATES - 1);
+        if (inst->profiling) {
+            inst->state_cycles[state]++;
+            if (state != inst->last_state) {
+                inst->state_entries[state]++;
+                inst->last_state = state;
+            }
+            uint32_t busy = lane_busy_mask(inst->dut, state);
+            for (uint32_t lane = 0; lane < NUM_LANES; lane++) {
+                inst->lane_busy_cycles[lane] += (busy >> lane) & 1;
+            }
+        }
+    }
+#if RTL_MAX_RECT_EXTERNAL
+    // The cache's request outputs are registered, so they are already
+    // settled for this edge
+    Vtop* dut = inst->dut;
+    bool req_valid = dut->mem_req_valid;
+    uint64_t req_addr = dut->mem_req_addr;
+    DramDrive drv = dram_drive(&inst->dram);
+    dut->mem_req_ready = drv.req_ready;
+    dut->mem_resp_valid = drv.resp_valid;
+    dut->mem_resp_data = drv.resp_data;
+#endif
+    sim_clock_cycle_t(inst, observe);
+#if RTL_MAX_RECT_EXTERNAL
+    dram_advance(&inst->dram, drv, req_valid, req_addr);
+#endif
+    if (kMonitor && inst->profiling) {
+        record_verdict(inst);
+    }
+    if (kMonitor && inst->scoreboard) {
+        scoreboard_step(inst, state);
+    }
+}
+
+// Call loop(monitor, observe) with monitoring and observing fixed for the
+// whole call, so a loop of step_t(inst, monitor, observe) tests neither per
+// cycle (see sim_with_observe)
+template <typename Loop>
+static inline auto with_step_mode(const Instance* inst, Loop loop) {
+    return sim_with_observe(inst, [inst, &loop](auto observe) {
+        if (inst->monitoring) {
+            return loop(std::true_type{}, observe);
+        }
+        return loop(std::false_type{}, observe);
+    });
+}
+
+// Single step, for callers that clock once per call
+static inline void step(Instance* inst) {
+    with_step_mode(inst, [inst](auto monitor, auto observe) { step_t(inst, monitor, observe); });
+}
+
+template <typename Monitor, typename Observe>
+static uint64_t run_until_done_t(Instance* inst, uint64_t max_cycles, Monitor monitor, Observe observe) {
+    constexpr bool kMonitor = Monitor::value;
+    uint64_t cycles = 0;
+    while (!inst->dut->done && cycles < max_cycles) {
+        step_t(inst, monitor, observe);
+        cycles++;
+        if (kMonitor && inst->scoreboard && inst->scoreboard->halted) {
+            break;
+        }
+    }
+    return cycles;
+}
+
+// Background run progress record (get_async_progress() order)
+static constexpr uint32_t ASYNC_PROGRESS_FIELDS = 5;  // {cycles, rect_count, max_area, debug_state, done}
+
+static void publish_progress(Instance* inst, uint64_t cycles) {
+    const Vtop* dut = inst->dut;
+    uint64_t v[ASYNC_PROGRESS_FIELDS] = {cycles, dut->debug_rect_count, dut->debug_max_area,
+                                         dut->debug_state, dut->done};
+    inst->async.publish(v, ASYNC_PROGRESS_FIELDS);
+}
+
+// run_until_done_t in ASYNC_CHUNK_CYCLES slices, publishing progress and
+// checking for cancellation between them
+template <typename Monitor, typename Observe>
+static uint64_t run_async_t(Instance* inst, uint64_t max_cycles, Monitor monitor, Observe observe) {
+    uint64_t cycles = 0;
+    while (cycles < max_cycles && !inst->async.cancelled()) {
+        uint64_t chunk = max_cycles - cycles < ASYNC_CHUNK_CYCLES ? max_cycles - cycles : ASYNC_CHUNK_CYCLES;
+        uint64_t ran = run_until_done_t(inst, chunk, monitor, observe);
+        cycles += ran;
+        publish_progress(inst, cycles);
+        if (ran < chunk) {
+            break;  // Done, or stopped by the scoreboard
+        }
+    }
+    return cycles;
+}
+
+// Flight recorder dump for a run that ended without done
+static void finish_run(Instance* inst) {
+    bool halted = inst->scoreboard && inst->scoreboard->halted;
+    if (!inst->dut->done && !halted) {
+        sim_recorder_timeout(inst);
+    }
+}
 
 //==============================================================================
-// Lifecycle
+// Backdoor Preload
 //==============================================================================
 
-void init_module() {
-    ctx = new VerilatedContext;
-    dut = new Vtop(ctx);
-    sim_time = 0;
-    // Reset sequence
-    dut->rst = 1;
-    for (int i = 0; i < 5; i++) {
-        dut->clk = 0; dut->eval();
-        dut->clk = 1; dut->eval();
+#if RTL_MAX_RECT_PRELOAD
+
+// Resolve a signal below the top module. Verilator versions differ on
+// whether VPI scope names carry the TOP. prefix, so try both. A signal that
+// resolves under neither is reported: the model was Verilated from Verilog
+// older than the RTL, or without rtl_max_rect_preload.vlt.
+static vpiHandle preload_handle(const char* path) {
+    char name[128];
+    snprintf(name, sizeof(name), "top.%s", path);
+    vpiHandle h = vpi_handle_by_name(name, nullptr);
+    if (!h) {
+        snprintf(name, sizeof(name), "TOP.top.%s", path);
+        h = vpi_handle_by_name(name, nullptr);
     }
-    dut->rst = 0;
-    // Initialize inputs
-    dut->vertex_x = 0;
-    dut->vertex_y = 0;
-    dut->vertex_valid = 0;
-    dut->vertex_last = 0;
-    dut->start_search = 0;
+    if (!h) {
+        fprintf(stderr, "preload_vertices: no public signal top.%s in the model; rebuild "
+                "librtl_max_rect_pl_notrace.so from freshly generated rtl_max_rect.v\n", path);
+    }
+    return h;
+}
+
+static void preload_put(vpiHandle h, uint64_t value) {
+    s_vpi_vecval vec[2] = {};
+    vec[0].aval = static_cast<PLI_UINT32>(value & 0xFFFFFFFFu);
+    vec[1].aval = static_cast<PLI_UINT32>(value >> 32);
+    s_vpi_value v;
+    v.format = vpiVectorVal;
+    v.value.vector = vec;
+    vpi_put_value(h, &v, nullptr, vpiNoDelay);
 }
 
-void cleanup_module() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
+// Every signal preload_vertices() writes. All of them are resolved before
+// anything is written, so a model missing one is left untouched.
+struct PreloadHandles {
+    vpiHandle vertex_mem = nullptr;
+    vpiHandle num_vertices = nullptr;
+    vpiHandle poly_loaded = nullptr;
+    vpiHandle fsm_state = nullptr;
+    vpiHandle validator_mem[NUM_LANES] = {};
+    uint32_t num_validators = 0;  // 0 with an edge index (see preload_resolve)
+
+    ~PreloadHandles() {
+        vpiHandle all[] = {vertex_mem, num_vertices, poly_loaded, fsm_state};
+        for (vpiHandle h : all) {
+            if (h) {
+                vpi_release_handle(h);
+            }
+        }
+        for (uint32_t lane = 0; lane < num_validators; lane++) {
+            if (validator_mem[lane]) {
+                vpi_release_handle(validator_mem[lane]);
+            }
+        }
     }
-    if (dut) {
-        dut->final();
-        delete dut;
-        dut = nullptr;
+};
+
+// Resolve every handle, false if any is missing. Edge-index validators also
+// build their block bounding boxes from the load stream, so their BRAMs are
+// left to LOAD_POLY_ONCE.
+static bool preload_resolve(PreloadHandles* h) {
+    h->vertex_mem = preload_handle("vertex_mem");
+    h->num_vertices = preload_handle("num_vertices");
+    h->poly_loaded = preload_handle("poly_loaded");
+    h->fsm_state = preload_handle("fsm_state");
+    bool ok = h->vertex_mem && h->num_vertices && h->poly_loaded && h->fsm_state;
+    h->num_validators = RTL_MAX_RECT_EDGE_INDEX ? 0 : NUM_LANES;
+    for (uint32_t lane = 0; lane < h->num_validators; lane++) {
+        char path[64];
+        if (NUM_LANES > 1) {
+            snprintf(path, sizeof(path), "validator_%u.vertex_mem", lane);
+        } else {
+            snprintf(path, sizeof(path), "validator.vertex_mem");
+        }
+        h->validator_mem[lane] = preload_handle(path);
+        ok = ok && h->validator_mem[lane];
     }
-    if (ctx) {
-        delete ctx;
-        ctx = nullptr;
+    return ok;
+}
+
+// Write the polygon into one vertex BRAM, {y, x} per word as the load path does
+static bool preload_memory(vpiHandle mem, const uint32_t* xy, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        vpiHandle word = vpi_handle_by_index(mem, static_cast<PLI_INT32>(i));
+        if (!word) {
+            fprintf(stderr, "preload_vertices: vertex BRAM has no word %u\n", i);
+            return false;
+        }
+        preload_put(word, (static_cast<uint64_t>(xy[2 * i + 1]) << COORD_WIDTH) | xy[2 * i]);
+        vpi_release_handle(word);
     }
-    tracing_enabled = false;
+    return true;
+}
+#endif
+
+//==============================================================================
+// Flight Recorder Signals
+//==============================================================================
+
+static const RecorderSignal RECORDER_SIGNALS[] = {
+    {"vertex_x", 20},
+    {"vertex_y", 20},
+    {"vertex_valid", 1},
+    {"vertex_last", 1},
+    {"start_search", 1},
+    {"busy", 1},
+    {"done", 1},
+    {"valid", 1},
+    {"max_area", 40},
+    {"rectangles_tested", 20},
+    {"rectangles_pruned", 20},
+    {"vertices_loaded", 11},
+    {"validation_cycles", 32},
+    {"debug_state", 4},
+    {"debug_num_vertices", 11},
+    {"debug_rect_count", 20},
+    {"debug_max_area", 40},
+#if RTL_MAX_RECT_LANES > 1
+    {"lane_busy", RTL_MAX_RECT_LANES},
+#endif
+};
+static constexpr uint32_t NUM_RECORDER_SIGNALS = sizeof(RECORDER_SIGNALS) / sizeof(RECORDER_SIGNALS[0]);
+
+static void sample_signals(const Vtop* dut, uint64_t* out) {
+    out[0] = dut->vertex_x;
+    out[1] = dut->vertex_y;
+    out[2] = dut->vertex_valid;
+    out[3] = dut->vertex_last;
+    out[4] = dut->start_search;
+    out[5] = dut->busy;
+    out[6] = dut->done;
+    out[7] = dut->valid;
+    out[8] = dut->max_area;
+    out[9] = dut->rectangles_tested;
+    out[10] = dut->rectangles_pruned;
+    out[11] = dut->vertices_loaded;
+    out[12] = dut->validation_cycles;
+    out[13] = dut->debug_state;
+    out[14] = dut->debug_num_vertices;
+    out[15] = dut->debug_rect_count;
+    out[16] = dut->debug_max_area;
+#if RTL_MAX_RECT_LANES > 1
+    out[17] = dut->lane_busy;
+#endif
+}
+
+extern "C" {
+
+//==============================================================================
+// Lifecycle
+//==============================================================================
+
+Instance* create_instance(uint32_t threads) {
+    Instance* inst = new Instance;
+    sim_init(inst, threads);
+    // Initialize inputs
+    inst->dut->vertex_x = 0;
+    inst->dut->vertex_y = 0;
+    inst->dut->vertex_valid = 0;
+    inst->dut->vertex_last = 0;
+    inst->dut->start_search = 0;
+#if RTL_MAX_RECT_EXTERNAL
+    inst->dut->ext_poly_valid = 0;
+    inst->dut->ext_num_vertices = 0;
+    inst->dut->mem_req_ready = 0;
+    inst->dut->mem_resp_valid = 0;
+    inst->dut->mem_resp_data = 0;
+    inst->dram.burst_beats = RTL_MAX_RECT_LINE_VERTICES;
+#endif
+    return inst;
+}
+
+void destroy_instance(Instance* inst) {
+    if (!inst) return;
+    inst->async.cancel.store(true);
+    inst->async.join();
+    sim_cleanup(inst);
+    delete inst->scoreboard;
+    delete inst;
 }
 
 //==============================================================================
 // Waveform Control
 //==============================================================================
 
-void enable_waveform(const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-    }
-    tfp = new VerilatedFstC;
-    ctx->traceEverOn(true);
-    dut->trace(tfp, 99);  // Trace 99 levels of hierarchy
-    tfp->open(filename);
-    trace_from_cycle = from_cycle;
-    trace_to_cycle = to_cycle;
-    tracing_enabled = true;
+void enable_waveform(Instance* inst, const char* filename, uint64_t from_cycle, uint64_t to_cycle) {
+    sim_enable_waveform(inst, filename, from_cycle, to_cycle);
 }
 
-void disable_waveform() {
-    if (tfp) {
-        tfp->close();
-        delete tfp;
-        tfp = nullptr;
-    }
-    tracing_enabled = false;
+void disable_waveform(Instance* inst) {
+    sim_disable_waveform(inst);
+}
+
+// 1 if this library was built with FST tracing, 0 for the trace-free variant
+uint8_t has_waveform_support() {
+    return SIM_TRACE;
+}
+
+#include "sim_signal_api.h"
+
+//==============================================================================
+// Checkpoints
+//==============================================================================
+
+// Save/restore the model (requires a --savable build), returns 1 on success
+uint8_t save_checkpoint(Instance* inst, const char* path) {
+    return sim_save_checkpoint(inst, path);
+}
+
+uint8_t restore_checkpoint(Instance* inst, const char* path) {
+    return sim_restore_checkpoint(inst, path);
 }
 
 //==============================================================================
 // Clock
 //==============================================================================
 
-void clock_cycle() {
-    uint64_t cycle = sim_time / 2;
+void clock_cycle(Instance* inst) {
+    step(inst);
+}
+
+void clock_n(Instance* inst, uint32_t n) {
+    with_step_mode(inst, [inst, n](auto monitor, auto observe) {
+        for (uint32_t i = 0; i < n; i++) {
+            step_t(inst, monitor, observe);
+        }
+    });
+}
+
+uint64_t get_cycle_count(Instance* inst) {
+    return inst->sim_time / 2;
+}
+
+//==============================================================================
+// Input Signals
+//==============================================================================
+
+void set_vertex_x(Instance* inst, uint32_t v) { inst->dut->vertex_x = v; }
+void set_vertex_y(Instance* inst, uint32_t v) { inst->dut->vertex_y = v; }
+void set_vertex_valid(Instance* inst, uint8_t v) { inst->dut->vertex_valid = v; }
+void set_vertex_last(Instance* inst, uint8_t v) { inst->dut->vertex_last = v; }
+void set_start_search(Instance* inst, uint8_t v) { inst->dut->start_search = v; }
+
+//==============================================================================
+// Output Signals
+//==============================================================================
+
+uint8_t get_busy(Instance* inst) { return inst->dut->busy; }
+uint8_t get_done(Instance* inst) { return inst->dut->done; }
+uint8_t get_valid(Instance* inst) { return inst->dut->valid; }
+uint64_t get_max_area(Instance* inst) { return inst->dut->max_area; }
+uint32_t get_rectangles_tested(Instance* inst) { return inst->dut->rectangles_tested; }
+uint32_t get_rectangles_pruned(Instance* inst) { return inst->dut->rectangles_pruned; }
+uint32_t get_vertices_loaded(Instance* inst) { return inst->dut->vertices_loaded; }
+uint32_t get_validation_cycles(Instance* inst) { return inst->dut->validation_cycles; }
+uint8_t get_debug_state(Instance* inst) { return inst->dut->debug_state; }
+uint32_t get_debug_num_vertices(Instance* inst) { return inst->dut->debug_num_vertices; }
+uint32_t get_debug_rect_count(Instance* inst) { return inst->dut->debug_rect_count; }
+uint64_t get_debug_max_area(Instance* inst) { return inst->dut->debug_max_area; }
 
-    dut->clk = 0;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
+//==============================================================================
+// FSM State Profile
+//==============================================================================
+
+// Enable/disable per-state cycle and entry counting (counts are kept)
+void enable_state_profile(Instance* inst, uint8_t enable) {
+    inst->profiling = enable;
+    inst->last_state = 0xFF;
+    update_monitoring(inst);
+}
+
+void reset_state_profile(Instance* inst) {
+    for (uint32_t i = 0; i < NUM_FSM_STATES; i++) {
+        inst->state_cycles[i] = 0;
+        inst->state_entries[i] = 0;
     }
-    sim_time++;
+    for (uint32_t lane = 0; lane < NUM_LANES; lane++) {
+        inst->lane_busy_cycles[lane] = 0;
+    }
+    inst->verdicts = {};
+    inst->last_state = 0xFF;
+}
 
-    dut->clk = 1;
-    dut->eval();
-    if (tracing_enabled && tfp && cycle >= trace_from_cycle && cycle <= trace_to_cycle) {
-        tfp->dump(sim_time);
+// Copy the profile as a flat array: cycles for states 0..15 followed by
+// entries for states 0..15. Writes at most cap values, returns NUM_FSM_STATES
+uint32_t get_state_profile(Instance* inst, uint64_t* out, uint32_t cap) {
+    for (uint32_t i = 0; i < 2 * NUM_FSM_STATES && i < cap; i++) {
+        out[i] = i < NUM_FSM_STATES ? inst->state_cycles[i]
+                                    : inst->state_entries[i - NUM_FSM_STATES];
     }
-    sim_time++;
+    return NUM_FSM_STATES;
 }
 
-void clock_n(uint32_t n) {
-    for (uint32_t i = 0; i < n; i++) {
-        clock_cycle();
+// Validator lanes in this model
+uint32_t get_num_lanes() {
+    return NUM_LANES;
+}
+
+// Copy the per-lane busy cycles, counted while the state profile is enabled.
+// Writes at most cap values, returns NUM_LANES
+uint32_t get_lane_busy_cycles(Instance* inst, uint64_t* out, uint32_t cap) {
+    for (uint32_t lane = 0; lane < NUM_LANES && lane < cap; lane++) {
+        out[lane] = inst->lane_busy_cycles[lane];
+    }
+    return NUM_LANES;
+}
+
+// 1 if the model has the verdict_* ports that the verdict statistics and
+// the scoreboard read
+uint8_t has_verdict_ports() {
+    return VERDICT_PORTS;
+}
+
+// Copy the per-candidate validation statistics, counted while the state
+// profile is enabled (models with verdict ports; all 0 otherwise). Layout: verdict
+// count per outcome (valid, CHECK 1, CHECK 2, corner), total validation
+// cycles per outcome, NUM_LATENCY_BUCKETS log2 latency buckets per outcome
+// (bucket b counts cycles in [2**(b-1), 2**b)), NUM_EXIT_BINS exit position
+// bins for CHECK 1 and then CHECK 2 rejections (bin k: the failing edge was
+// within the (k+1)/NUM_EXIT_BINS fraction of the walk), then the edges the
+// rejections walked and the edges full scans (n + 1 each, the start edge
+// twice) would have walked. Writes at most cap values, returns
+// VERDICT_STATS_FIELDS
+uint32_t get_verdict_stats(Instance* inst, uint64_t* out, uint32_t cap) {
+    const uint64_t* fields = reinterpret_cast<const uint64_t*>(&inst->verdicts);
+    for (uint32_t k = 0; k < VERDICT_STATS_FIELDS && k < cap; k++) {
+        out[k] = fields[k];
     }
+    return VERDICT_STATS_FIELDS;
+}
+
+// Edges the validators checked / skipped via the edge index over the last
+// search (latched with the other results). Both 0 without an edge index.
+uint32_t get_edges_examined(Instance* inst) {
+#if RTL_MAX_RECT_EDGE_INDEX
+    return inst->dut->edges_examined;
+#else
+    (void)inst;
+    return 0;
+#endif
 }
 
-uint64_t get_cycle_count() {
-    return sim_time / 2;
+uint32_t get_edges_skipped(Instance* inst) {
+#if RTL_MAX_RECT_EDGE_INDEX
+    return inst->dut->edges_skipped;
+#else
+    (void)inst;
+    return 0;
+#endif
 }
 
 //==============================================================================
-// Input Signals
+// External Vertex Memory
 //==============================================================================
 
-void set_vertex_x(uint32_t v) { dut->vertex_x = v; }
-void set_vertex_y(uint32_t v) { dut->vertex_y = v; }
-void set_vertex_valid(uint8_t v) { dut->vertex_valid = v; }
-void set_vertex_last(uint8_t v) { dut->vertex_last = v; }
-void set_start_search(uint8_t v) { dut->start_search = v; }
+// 1 if the model fetches vertices from external memory through a cache
+uint8_t has_external_memory() {
+    return RTL_MAX_RECT_EXTERNAL;
+}
+
+// Memory timing: cycles from an accepted request to the first word, and
+// between the following words of the burst (both at least 1)
+void configure_dram(Instance* inst, uint32_t latency, uint32_t cycles_per_beat) {
+    inst->dram.latency = latency ? latency : 1;
+    inst->dram.cycles_per_beat = cycles_per_beat ? cycles_per_beat : 1;
+}
+
+// Cache counters, live and cleared by start_search(). All 0 without
+// external memory.
+uint32_t get_cache_accesses(Instance* inst) {
+#if RTL_MAX_RECT_EXTERNAL
+    return inst->dut->cache_accesses;
+#else
+    (void)inst;
+    return 0;
+#endif
+}
+
+uint32_t get_cache_misses(Instance* inst) {
+#if RTL_MAX_RECT_EXTERNAL
+    return inst->dut->cache_misses;
+#else
+    (void)inst;
+    return 0;
+#endif
+}
+
+uint32_t get_cache_stall_cycles(Instance* inst) {
+#if RTL_MAX_RECT_EXTERNAL
+    return inst->dut->cache_stall_cycles;
+#else
+    (void)inst;
+    return 0;
+#endif
+}
+
+// Memory-side counters since the last start_search(): bursts served and
+// cycles with a burst in flight
+uint64_t get_dram_bursts(Instance* inst) { return inst->dram.bursts; }
+uint64_t get_dram_busy_cycles(Instance* inst) { return inst->dram.busy_cycles; }
 
 //==============================================================================
-// Output Signals
+// Scoreboard
 //==============================================================================
 
-uint8_t get_busy() { return dut->busy; }
-uint8_t get_done() { return dut->done; }
-uint8_t get_valid() { return dut->valid; }
-uint64_t get_max_area() { return dut->max_area; }
-uint32_t get_rectangles_tested() { return dut->rectangles_tested; }
-uint32_t get_rectangles_pruned() { return dut->rectangles_pruned; }
-uint32_t get_vertices_loaded() { return dut->vertices_loaded; }
-uint32_t get_validation_cycles() { return dut->validation_cycles; }
-uint8_t get_debug_state() { return dut->debug_state; }
-uint32_t get_debug_num_vertices() { return dut->debug_num_vertices; }
-uint32_t get_debug_rect_count() { return dut->debug_rect_count; }
-uint64_t get_debug_max_area() { return dut->debug_max_area; }
+// Check every validator verdict (and every skip/prune/validate decision)
+// against the native reference model as the search runs. xy/count give the
+// polygon in DUT coordinates; with xy null the polygon last streamed through
+// load_vertex()/load_vertices() is used. reset_dut() drops an explicit
+// polygon, so each run_jobs() job is checked against its own. With stop_on_mismatch set,
+// run_until_done() returns at the first mismatch. Counters are reset.
+// Single-lane models with verdict ports only; returns 0 (scoreboard off)
+// otherwise, 1 once enabled.
+uint8_t enable_scoreboard(Instance* inst, const uint32_t* xy, uint32_t count, uint8_t stop_on_mismatch) {
+    if (NUM_LANES > 1) {
+        // The scoreboard reads each verdict from the verdict_* ports, which
+        // carry one validator's result at a time
+        fprintf(stderr, "Scoreboard: not supported with %u validator lanes\n", NUM_LANES);
+        return 0;
+    }
+    if (!VERDICT_PORTS) {
+        fprintf(stderr, "Scoreboard: the model has no verdict ports; "
+                        "regenerate rtl_max_rect.v from the current RTL\n");
+        return 0;
+    }
+    delete inst->scoreboard;
+    inst->scoreboard = new Scoreboard;
+    if (xy) {
+        inst->scoreboard->xy.assign(xy, xy + 2 * static_cast<size_t>(count));
+    }
+    inst->scoreboard->stop_on_mismatch = stop_on_mismatch;
+    update_monitoring(inst);
+    return 1;
+}
+
+void disable_scoreboard(Instance* inst) {
+    delete inst->scoreboard;
+    inst->scoreboard = nullptr;
+    update_monitoring(inst);
+}
+
+// Number of verdicts compared so far (0 if the scoreboard is off)
+uint64_t get_scoreboard_checked(Instance* inst) {
+    return inst->scoreboard ? inst->scoreboard->checked : 0;
+}
+
+// Copy the first mismatch as {cycle, kind, i, j, rect_x, rect_y, rect_width,
+// rect_height, expected, got}, kind one of MISMATCH_VERDICT (1),
+// MISMATCH_DISPATCH (2), MISMATCH_PASS (3) or MISMATCH_FAIL_EDGE (4). Writes
+// at most cap values, returns the number of mismatches seen
+uint64_t get_scoreboard_mismatch(Instance* inst, uint64_t* out, uint32_t cap) {
+    if (!inst->scoreboard) {
+        return 0;
+    }
+    const uint64_t* fields = reinterpret_cast<const uint64_t*>(&inst->scoreboard->first);
+    for (uint32_t k = 0; k < MISMATCH_FIELDS && k < cap; k++) {
+        out[k] = fields[k];
+    }
+    return inst->scoreboard->mismatches;
+}
 
 //==============================================================================
 // Convenience Functions
 //==============================================================================
 
-void load_vertex(uint32_t x, uint32_t y, uint8_t last) {
+static void record_loaded_vertex(Instance* inst, uint32_t x, uint32_t y, bool last) {
+    if (inst->load_complete) {
+        inst->loaded_xy.clear();
+        inst->load_complete = false;
+    }
+    inst->loaded_xy.push_back(x);
+    inst->loaded_xy.push_back(y);
+    inst->load_complete = last;
+}
+
+#if RTL_MAX_RECT_EXTERNAL
+// Write the polygon to external memory and hand it to the DUT with a one
+// cycle ext_poly_valid pulse (the FSM must be in IDLE)
+static void load_external(Instance* inst, const uint32_t* xy, uint32_t count) {
+    std::vector<uint64_t>& words = inst->dram.words;
+    words.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        words[i] = static_cast<uint64_t>(xy[2 * i + 1]) << COORD_WIDTH | xy[2 * i];
+    }
+    inst->dut->ext_num_vertices = count;
+    inst->dut->ext_poly_valid = 1;
+    step(inst);
+    inst->dut->ext_poly_valid = 0;
+}
+#endif
+
+// With external memory, vertices are collected until last and then written
+// to memory in one go
+void load_vertex(Instance* inst, uint32_t x, uint32_t y, uint8_t last) {
+    record_loaded_vertex(inst, x, y, last);
+#if RTL_MAX_RECT_EXTERNAL
+    if (last) {
+        load_external(inst, inst->loaded_xy.data(), static_cast<uint32_t>(inst->loaded_xy.size() / 2));
+    }
+#else
+    Vtop* dut = inst->dut;
     dut->vertex_x = x;
     dut->vertex_y = y;
     dut->vertex_valid = 1;
     dut->vertex_last = last;
-    clock_cycle();
+    step(inst);
     dut->vertex_valid = 0;
     dut->vertex_last = 0;
+#endif
 }
 
-void start_search() {
-    dut->start_search = 1;
-    clock_cycle();
-    dut->start_search = 0;
+// Stream count vertices from an interleaved {x0, y0, x1, y1, ...} array,
+// one per cycle, with vertex_last set on the final element
+void load_vertices(Instance* inst, const uint32_t* xy, uint32_t count) {
+#if RTL_MAX_RECT_EXTERNAL
+    inst->loaded_xy.assign(xy, xy + 2 * static_cast<size_t>(count));
+    inst->load_complete = true;
+    load_external(inst, xy, count);
+#else
+    Vtop* dut = inst->dut;
+    dut->vertex_valid = 1;
+    with_step_mode(inst, [&](auto monitor, auto observe) {
+        for (uint32_t i = 0; i < count; i++) {
+            dut->vertex_x = xy[2 * i];
+            dut->vertex_y = xy[2 * i + 1];
+            dut->vertex_last = (i == count - 1);
+            record_loaded_vertex(inst, xy[2 * i], xy[2 * i + 1], i == count - 1);
+            step_t(inst, monitor, observe);
+        }
+    });
+    dut->vertex_valid = 0;
+    dut->vertex_last = 0;
+#endif
 }
 
-uint64_t run_until_done(uint64_t max_cycles) {
-    uint64_t cycles = 0;
-    while (!dut->done && cycles < max_cycles) {
-        clock_cycle();
-        cycles++;
+// 1 if this library was built with backdoor preload access
+uint8_t has_preload_support() {
+    return RTL_MAX_RECT_PRELOAD;
+}
+
+// Write count vertices from an interleaved {x0, y0, x1, y1, ...} array
+// straight into the vertex BRAMs, set num_vertices and put the FSM in
+// WAIT_START without clocking, instead of streaming one vertex per cycle.
+// The FSM must be in IDLE or WAIT_START. Returns 2 if every validator BRAM
+// was preloaded too (start_search() skips LOAD_POLY_ONCE), 1 if only the
+// finder's BRAM was (LOAD_POLY_ONCE copies it as usual), 0 on failure or
+// without preload support.
+uint8_t preload_vertices(Instance* inst, const uint32_t* xy, uint32_t count) {
+#if RTL_MAX_RECT_PRELOAD
+    uint8_t state = inst->dut->debug_state;
+    if (count < 3 || (state != STATE_IDLE && state != STATE_WAIT_START)) {
+        return 0;
+    }
+    Verilated::threadContextp(inst->ctx);
+    PreloadHandles h;
+    if (!preload_resolve(&h)) {
+        return 0;
+    }
+    if (!preload_memory(h.vertex_mem, xy, count)) {
+        return 0;
+    }
+    for (uint32_t lane = 0; lane < h.num_validators; lane++) {
+        if (!preload_memory(h.validator_mem[lane], xy, count)) {
+            return 0;
+        }
+    }
+    bool validators = h.num_validators > 0;
+    preload_put(h.num_vertices, count);
+    preload_put(h.poly_loaded, validators);
+    preload_put(h.fsm_state, STATE_WAIT_START);
+    inst->dut->eval();
+
+    // The scoreboard reads the polygon from here, as after a streamed load
+    inst->loaded_xy.assign(xy, xy + 2 * static_cast<size_t>(count));
+    inst->load_complete = true;
+    return validators ? 2 : 1;
+#else
+    (void)inst;
+    (void)xy;
+    (void)count;
+    return 0;
+#endif
+}
+
+void start_search(Instance* inst) {
+    dram_reset_stats(&inst->dram);
+    inst->dut->start_search = 1;
+    step(inst);
+    inst->dut->start_search = 0;
+}
+
+uint64_t run_until_done(Instance* inst, uint64_t max_cycles) {
+    uint64_t cycles = with_step_mode(inst, [inst, max_cycles](auto monitor, auto observe) {
+        return run_until_done_t(inst, max_cycles, monitor, observe);
+    });
+    finish_run(inst);
+    return cycles;
+}
+
+// Same as run_until_done, then copies the state profile into profile_out
+// (layout as get_state_profile, 2 * NUM_FSM_STATES entries)
+uint64_t run_until_done_profiled(Instance* inst, uint64_t max_cycles, uint64_t* profile_out) {
+    uint64_t cycles = run_until_done(inst, max_cycles);
+    if (profile_out) {
+        get_state_profile(inst, profile_out, 2 * NUM_FSM_STATES);
     }
     return cycles;
 }
 
+//==============================================================================
+// Background Run
+//==============================================================================
+
+// 1 while a background run is in flight
+uint8_t get_async_running(Instance* inst) {
+    return inst->async.running.load(std::memory_order_acquire);
+}
+
+// Run run_until_done(max_cycles) on a native thread and return at once.
+// While it runs, only get_async_progress(), get_async_running(),
+// cancel_async() and wait_async() may be called on the instance.
+// Returns 0 if a background run is already in flight
+uint8_t start_async(Instance* inst, uint64_t max_cycles) {
+    if (get_async_running(inst)) {
+        return 0;
+    }
+    publish_progress(inst, 0);
+    return inst->async.start([inst, max_cycles]() {
+        uint64_t cycles = with_step_mode(inst, [inst, max_cycles](auto monitor, auto observe) {
+            return run_async_t(inst, max_cycles, monitor, observe);
+        });
+        if (!inst->async.cancelled()) {
+            finish_run(inst);
+        }
+        return cycles;
+    });
+}
+
+// Copy the progress record as of the last ASYNC_CHUNK_CYCLES boundary:
+// {cycles, debug_rect_count, debug_max_area, debug_state, done}, cycles
+// counted from start_async(). Writes at most cap values, returns
+// ASYNC_PROGRESS_FIELDS. Safe to call while the run is in flight
+uint32_t get_async_progress(Instance* inst, uint64_t* out, uint32_t cap) {
+    inst->async.snapshot(out, cap);
+    return ASYNC_PROGRESS_FIELDS;
+}
+
+// Ask the background run to stop at the next chunk boundary. The model
+// keeps its state, so the search can be resumed with run_until_done() or
+// another start_async()
+void cancel_async(Instance* inst) {
+    inst->async.cancel.store(true, std::memory_order_relaxed);
+}
+
+// Wait for the background run to end, returns the cycles the last one ran
+uint64_t wait_async(Instance* inst) {
+    return inst->async.join();
+}
+
+//==============================================================================
+// Job Queue
+//==============================================================================
+
+// Reset the model in place for the next polygon: pulse rst and clear the
+// state profile, lane busy counts, streamed polygon, scoreboard tallies and
+// DRAM statistics. An explicit scoreboard polygon is dropped too, so the
+// scoreboard checks the next job against the polygon loaded for it. A
+// waveform, flight recorder or sampling buffer stays attached, and the
+// cycle counter keeps running. Returns 0 (and does nothing) while a
+// background run is in flight
+uint8_t reset_dut(Instance* inst) {
+    if (get_async_running(inst)) {
+        return 0;
+    }
+    Vtop* dut = inst->dut;
+    dut->vertex_valid = 0;
+    dut->vertex_last = 0;
+    dut->start_search = 0;
+#if RTL_MAX_RECT_EXTERNAL
+    dut->ext_poly_valid = 0;
+    dut->mem_req_ready = 0;
+    dut->mem_resp_valid = 0;
+    dram_cancel(&inst->dram);
+#endif
+    sim_reset(inst);
+
+    reset_state_profile(inst);
+    dram_reset_stats(&inst->dram);
+    inst->loaded_xy.clear();
+    inst->load_complete = false;
+    if (Scoreboard* sb = inst->scoreboard) {
+        Scoreboard fresh;
+        fresh.stop_on_mismatch = sb->stop_on_mismatch;
+        *sb = std::move(fresh);
+    }
+    return 1;
+}
+
+// Run num_jobs polygons back to back on this instance in one call. xy holds
+// the jobs' interleaved {x0, y0, x1, y1, ...} vertices one after another and
+// counts[k] the vertex count of job k. Each job is reset_dut(), a load
+// (preload_vertices() where supported, streamed otherwise), start_search()
+// and run_until_done(max_cycles). Job k's results go to
+// out[k * JOB_RESULT_FIELDS ...] as {done, valid, max_area,
+// rectangles_tested, rectangles_pruned, load_cycles, search_cycles,
+// scoreboard_checked, scoreboard_mismatches}, the last two zero with the
+// scoreboard off; jobs with fewer than 3 vertices are skipped and read as
+// zeros. Returns the number of jobs that completed
+uint32_t run_jobs(Instance* inst, const uint32_t* xy, const uint32_t* counts, uint32_t num_jobs,
+                  uint64_t max_cycles, uint64_t* out) {
+    uint32_t completed = 0;
+    for (uint32_t k = 0; k < num_jobs; k++) {
+        uint32_t count = counts[k];
+        JobResult r = {};
+        if (count >= 3 && reset_dut(inst)) {
+            uint64_t load_start = get_cycle_count(inst);
+            if (!preload_vertices(inst, xy, count)) {
+                load_vertices(inst, xy, count);
+            }
+            r.load_cycles = get_cycle_count(inst) - load_start;
+            start_search(inst);
+            r.search_cycles = run_until_done(inst, max_cycles);
+            const Vtop* dut = inst->dut;
+            r.done = dut->done;
+            r.valid = dut->valid;
+            r.max_area = dut->max_area;
+            r.rectangles_tested = dut->rectangles_tested;
+            r.rectangles_pruned = dut->rectangles_pruned;
+            if (const Scoreboard* sb = inst->scoreboard) {
+                r.scoreboard_checked = sb->checked;
+                r.scoreboard_mismatches = sb->mismatches;
+            }
+            completed += r.done ? 1 : 0;
+        }
+        memcpy(out + static_cast<size_t>(k) * JOB_RESULT_FIELDS, &r, sizeof(r));
+        xy += 2 * static_cast<size_t>(count);
+    }
+    return completed;
+}
+
 } // extern "C"
@@ -0,0 +1,58 @@
+/**
+ * Per-cycle capture of selected signals into a caller-owned buffer.
+ *
+ * Picks columns out of the wrapper's flight recorder signal table (the same
+ * names and sampler) and stores them column-major: column k of the buffer
+ * holds buffer[k * capacity .. k * capacity + count). A Python caller can
+ * pass a (num_columns, capacity) uint64 numpy array and read the columns
+ * without copying. With every > 1 only every Nth cycle is kept.
+ *
+ * Nothing is encoded or written, so unlike the flight recorder this works in
+ * trace-free builds. Once the buffer is full further samples are counted as
+ * dropped until the caller rewinds it.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct SampleCapture {
+    std::vector<uint32_t> columns;  // Signal-table index of each column
+    std::vector<uint64_t> row;      // Scratch for one full signal-table row
+    uint64_t* buffer = nullptr;     // columns.size() x capacity, not owned
+    uint64_t capacity = 0;          // Rows per column
+    uint64_t count = 0;             // Rows filled
+    uint64_t dropped = 0;           // Samples that did not fit
+    uint64_t start_cycle = 0;       // Cycle of row 0
+    uint32_t every = 1;             // Keep one cycle in `every`
+    uint32_t phase = 0;             // Cycles since the last kept one
+
+    // Called after every cycle with a sampler for the full signal table
+    template <typename Sampler>
+    void take(Sampler sample, uint64_t cycle) {
+        if (++phase < every) {
+            return;
+        }
+        phase = 0;
+        if (count == capacity) {
+            dropped++;
+            return;
+        }
+        sample(row.data());
+        if (count == 0) {
+            start_cycle = cycle;
+        }
+        uint64_t* out = buffer + count;
+        for (uint32_t k = 0; k < columns.size(); k++) {
+            out[k * capacity] = row[columns[k]];
+        }
+        count++;
+    }
+
+    // Start filling the buffer from row 0 again (the decimation phase carries on)
+    void rewind() {
+        count = 0;
+        dropped = 0;
+    }
+};
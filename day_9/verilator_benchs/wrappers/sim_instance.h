@@ -0,0 +1,543 @@
+/**
+ * Per-instance Verilator simulation state shared by all module wrappers.
+ *
+ * Every wrapper derives its opaque Instance handle from SimInstance, so each
+ * handle owns its own VerilatedContext, model and trace file. Independent
+ * handles can be driven concurrently from different threads.
+ *
+ * Build with -DSIM_TRACE=0 against a model Verilated without --trace-fst to
+ * compile all tracing out. Clocking loops choose between the observed and
+ * the plain clock once per call (sim_with_observe), so with nothing observed
+ * they run sim_clock_cycle_t<false>, which has no per-cycle tests.
+ *
+ * Traced builds also provide a flight recorder (flight_recorder.h) that keeps
+ * the last N cycles of the wrapper's signal table in memory, and triggered
+ * capture that writes only a window around a signal condition. Any build can
+ * copy selected signals into a caller buffer every cycle (sample_capture.h).
+ *
+ * Build with -DSIM_SAVABLE=1 against a model Verilated with --savable to
+ * enable checkpoint save/restore.
+ *
+ * Build with -DSIM_PROF_VLT='"path"' against a model Verilated with
+ * --prof-pgo to choose where its thread profile goes (default profile.vlt in
+ * the working directory); it is written when the instance is destroyed.
+ */
+
+#pragma once
+
+#ifndef SIM_TRACE
+#define SIM_TRACE 1
+#endif
+
+#ifndef SIM_SAVABLE
+#define SIM_SAVABLE 0
+#endif
+
+#include "Vtop.h"
+#include "verilated.h"
+#if SIM_TRACE
+#include "verilated_fst_c.h"
+#endif
+#include "flight_recorder.h"
+#include "sample_capture.h"
+#if SIM_SAVABLE
+#include "verilated_save.h"
+#endif
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+struct SimInstance {
+    VerilatedContext* ctx = nullptr;
+    Vtop* dut = nullptr;
+#if SIM_TRACE
+    VerilatedFstC* tfp = nullptr;
+#endif
+    uint64_t sim_time = 0;
+    uint64_t trace_from_cycle = 0;
+    uint64_t trace_to_cycle = UINT64_MAX;
+    bool tracing_enabled = false;
+#if SIM_TRACE
+    FlightRecorder* recorder = nullptr;
+    TriggerCapture capture;
+#endif
+    SampleCapture* sampling = nullptr;
+    void (*sample_signals)(const Vtop*, uint64_t*) = nullptr;  // Fills a signal-table row
+    bool observing = false;  // Any of the above active: clock takes the observed path
+};
+
+static inline void sim_update_observing(SimInstance* s) {
+#if SIM_TRACE
+    s->observing = s->tracing_enabled || s->recorder || s->sampling;
+#else
+    s->observing = s->sampling != nullptr;
+#endif
+}
+
+//==============================================================================
+// Lifecycle
+//==============================================================================
+
+static constexpr int SIM_RESET_CYCLES = 5;
+
+// Create context and model, then apply the reset sequence.
+// threads sets the context thread count for models Verilated with --threads
+// (0 keeps the Verilator default); it is ignored for single-threaded builds.
+static inline void sim_init(SimInstance* s, uint32_t threads) {
+    s->ctx = new VerilatedContext;
+#if VM_THREADS
+    if (threads) {
+        s->ctx->threads(threads);
+    }
+#ifdef SIM_PROF_VLT
+    s->ctx->profVltFilename(SIM_PROF_VLT);
+#endif
+#else
+    (void)threads;
+#endif
+    s->dut = new Vtop(s->ctx);
+    s->sim_time = 0;
+    // Reset sequence
+    s->dut->rst = 1;
+    for (int i = 0; i < SIM_RESET_CYCLES; i++) {
+        s->dut->clk = 0; s->dut->eval();
+        s->dut->clk = 1; s->dut->eval();
+    }
+    s->dut->rst = 0;
+}
+
+static inline void sim_cleanup(SimInstance* s) {
+#if SIM_TRACE
+    if (s->tfp) {
+        s->tfp->close();
+        delete s->tfp;
+        s->tfp = nullptr;
+    }
+    if (s->recorder && s->capture.state == CAPTURE_POST) {
+        s->capture.finish(*s->recorder);
+    }
+    delete s->recorder;
+    s->recorder = nullptr;
+#endif
+    delete s->sampling;
+    s->sampling = nullptr;
+    if (s->dut) {
+        s->dut->final();
+        delete s->dut;
+        s->dut = nullptr;
+    }
+    if (s->ctx) {
+        delete s->ctx;
+        s->ctx = nullptr;
+    }
+    s->tracing_enabled = false;
+    sim_update_observing(s);
+}
+
+//==============================================================================
+// Waveform Control
+//==============================================================================
+
+static inline void sim_enable_waveform(SimInstance* s, const char* filename,
+                                       uint64_t from_cycle, uint64_t to_cycle) {
+#if SIM_TRACE
+    if (s->tfp) {
+        s->tfp->close();
+        delete s->tfp;
+    }
+    s->tfp = new VerilatedFstC;
+    s->ctx->traceEverOn(true);
+    s->dut->trace(s->tfp, 99);  // Trace 99 levels of hierarchy
+    s->tfp->open(filename);
+    s->trace_from_cycle = from_cycle;
+    s->trace_to_cycle = to_cycle;
+    s->tracing_enabled = true;
+    sim_update_observing(s);
+#else
+    (void)s; (void)from_cycle; (void)to_cycle;
+    fprintf(stderr, "Waveform %s not written: library built without tracing\n", filename);
+#endif
+}
+
+static inline void sim_disable_waveform(SimInstance* s) {
+#if SIM_TRACE
+    if (s->tfp) {
+        s->tfp->close();
+        delete s->tfp;
+        s->tfp = nullptr;
+    }
+#endif
+    s->tracing_enabled = false;
+    sim_update_observing(s);
+}
+
+//==============================================================================
+// Flight Recorder
+//==============================================================================
+
+// Start keeping the last `depth` cycles of signals[] (filled by sampler after
+// every cycle). If auto_dump_path is non-empty the recording is written there
+// when a run times out. Returns 1 on success, 0 in trace-free builds.
+static inline uint8_t sim_enable_recorder(SimInstance* s, const RecorderSignal* signals,
+                                          uint32_t num_signals,
+                                          void (*sampler)(const Vtop*, uint64_t*),
+                                          uint64_t depth, const char* auto_dump_path) {
+#if SIM_TRACE
+    delete s->recorder;
+    s->recorder = new FlightRecorder(signals, num_signals, depth);
+    if (s->capture.state == CAPTURE_POST) {
+        s->capture.state = CAPTURE_ARMED;  // Pending window was discarded
+    }
+    s->recorder->auto_dump_path = auto_dump_path ? auto_dump_path : "";
+    s->sample_signals = sampler;
+    sim_update_observing(s);
+    return 1;
+#else
+    (void)s; (void)signals; (void)num_signals; (void)sampler; (void)depth; (void)auto_dump_path;
+    fprintf(stderr, "Flight recorder not available: library built without tracing\n");
+    return 0;
+#endif
+}
+
+static inline void sim_disable_recorder(SimInstance* s) {
+#if SIM_TRACE
+    delete s->recorder;
+    s->recorder = nullptr;
+    s->capture.state = CAPTURE_OFF;
+#endif
+    sim_update_observing(s);
+}
+
+// Write the recorded cycles to filename (or the auto-dump path if filename
+// is null/empty). Returns 1 if a file was written.
+static inline uint8_t sim_dump_recorder(SimInstance* s, const char* filename) {
+#if SIM_TRACE
+    if (!s->recorder) {
+        return 0;
+    }
+    if (!filename || !*filename) {
+        filename = s->recorder->auto_dump_path.c_str();
+    }
+    return s->recorder->dump(filename) ? 1 : 0;
+#else
+    (void)s; (void)filename;
+    return 0;
+#endif
+}
+
+// Called by wrapper run loops that stop on max_cycles without finishing.
+// Also writes a triggered capture whose post window is still open.
+static inline void sim_recorder_timeout(SimInstance* s) {
+#if SIM_TRACE
+    if (s->recorder && s->capture.state == CAPTURE_POST) {
+        s->capture.finish(*s->recorder);
+    }
+    if (s->recorder && !s->recorder->auto_dump_path.empty()) {
+        if (sim_dump_recorder(s, nullptr)) {
+            fprintf(stderr, "Run timed out at cycle %lu, flight recorder written to %s\n",
+                    static_cast<unsigned long>(s->sim_time / 2),
+                    s->recorder->auto_dump_path.c_str());
+        }
+    }
+#else
+    (void)s;
+#endif
+}
+
+//==============================================================================
+// Triggered Capture
+//==============================================================================
+
+// Set the start (which = 0) or stop (which = 1) condition to
+// `signal op value`; op is one of TRIGGER_*, TRIGGER_OFF clears it.
+// Returns 0 for an unknown signal or op, or in trace-free builds.
+static inline uint8_t sim_set_capture_trigger(SimInstance* s, const RecorderSignal* signals,
+                                              uint32_t num_signals, uint8_t which,
+                                              const char* signal, uint32_t op, uint64_t value) {
+#if SIM_TRACE
+    int32_t index = recorder_find_signal(signals, num_signals, signal);
+    if (which > 1 || op >= TRIGGER_NUM_OPS || (op != TRIGGER_OFF && index < 0)) {
+        return 0;
+    }
+    RecorderTrigger& t = which ? s->capture.stop : s->capture.start;
+    t.signal = index < 0 ? 0 : static_cast<uint32_t>(index);
+    t.op = op;
+    t.value = value;
+    return 1;
+#else
+    (void)s; (void)signals; (void)num_signals; (void)which; (void)signal; (void)op; (void)value;
+    return 0;
+#endif
+}
+
+// Arm triggered capture: when the start trigger fires, the `pre` cycles before
+// it through `post` cycles after it (or the stop trigger) are written to path.
+// Re-arms until max_captures files are written (0 = unlimited). Enables or
+// grows the flight recorder so it holds pre + post + 1 cycles.
+// Returns 1 on success, 0 without a start trigger or in trace-free builds.
+static inline uint8_t sim_enable_capture(SimInstance* s, const RecorderSignal* signals,
+                                         uint32_t num_signals,
+                                         void (*sampler)(const Vtop*, uint64_t*),
+                                         uint64_t pre, uint64_t post, const char* path,
+                                         uint64_t max_captures) {
+#if SIM_TRACE
+    if (s->capture.start.op == TRIGGER_OFF || !path || !*path) {
+        return 0;
+    }
+    uint64_t depth = pre + post + 1;
+    if (!s->recorder || s->recorder->depth < depth) {
+        std::string auto_path = s->recorder ? s->recorder->auto_dump_path : "";
+        sim_enable_recorder(s, signals, num_signals, sampler, depth, auto_path.c_str());
+    }
+    s->capture.pre = pre;
+    s->capture.post = post;
+    s->capture.path = path;
+    s->capture.captures = 0;
+    s->capture.max_captures = max_captures;
+    s->capture.state = CAPTURE_ARMED;
+    return 1;
+#else
+    (void)s; (void)signals; (void)num_signals; (void)sampler; (void)pre; (void)post;
+    (void)max_captures;
+    fprintf(stderr, "Capture %s not armed: library built without tracing\n", path ? path : "");
+    return 0;
+#endif
+}
+
+// Stop triggered capture, writing a capture whose post window is still open.
+// The flight recorder stays enabled.
+static inline void sim_disable_capture(SimInstance* s) {
+#if SIM_TRACE
+    if (s->recorder && s->capture.state == CAPTURE_POST) {
+        s->capture.finish(*s->recorder);
+    }
+    s->capture.state = CAPTURE_OFF;
+#else
+    (void)s;
+#endif
+}
+
+// Number of capture files written since the capture was armed
+static inline uint64_t sim_capture_count(SimInstance* s) {
+#if SIM_TRACE
+    return s->capture.captures;
+#else
+    (void)s;
+    return 0;
+#endif
+}
+
+//==============================================================================
+// Sample Capture
+//==============================================================================
+
+// Copy signals[ids[k]] (filled by sampler) into column k of buffer after
+// every `every` cycles, column-major with capacity rows per column. The
+// buffer is owned by the caller and must stay valid until sampling is
+// disabled. Returns 0 for an unknown id, no columns or a null buffer.
+static inline uint8_t sim_enable_sampling(SimInstance* s, uint32_t num_signals,
+                                          void (*sampler)(const Vtop*, uint64_t*),
+                                          const uint32_t* ids, uint32_t num_ids,
+                                          uint64_t* buffer, uint64_t capacity, uint32_t every) {
+    if (!ids || !num_ids || !buffer || !capacity) {
+        return 0;
+    }
+    for (uint32_t k = 0; k < num_ids; k++) {
+        if (ids[k] >= num_signals) {
+            return 0;
+        }
+    }
+    delete s->sampling;
+    s->sampling = new SampleCapture;
+    s->sampling->columns.assign(ids, ids + num_ids);
+    s->sampling->row.resize(num_signals);
+    s->sampling->buffer = buffer;
+    s->sampling->capacity = capacity;
+    s->sampling->every = every ? every : 1;
+    s->sampling->phase = s->sampling->every - 1;  // Keep the first cycle
+    s->sample_signals = sampler;
+    sim_update_observing(s);
+    return 1;
+}
+
+static inline void sim_disable_sampling(SimInstance* s) {
+    delete s->sampling;
+    s->sampling = nullptr;
+    sim_update_observing(s);
+}
+
+//==============================================================================
+// Checkpoints
+//==============================================================================
+
+// Serialize the cycle counter and full model state to path.
+// Returns 1 on success, 0 if the file could not be opened or the model
+// was not built savable. Waveform state is not part of the checkpoint.
+static inline uint8_t sim_save_checkpoint(SimInstance* s, const char* path) {
+#if SIM_SAVABLE
+    VerilatedSave os;
+    os.open(path);
+    if (!os.isOpen()) {
+        return 0;
+    }
+    os << s->sim_time;
+    os << *s->dut;
+    os.close();
+    return 1;
+#else
+    (void)s;
+    fprintf(stderr, "Checkpoint %s not written: model not built with --savable\n", path);
+    return 0;
+#endif
+}
+
+// Restore a checkpoint written by sim_save_checkpoint() from the same build.
+// Returns 1 on success, 0 if the file could not be opened or the model
+// was not built savable.
+static inline uint8_t sim_restore_checkpoint(SimInstance* s, const char* path) {
+#if SIM_SAVABLE
+    VerilatedRestore os;
+    os.open(path);
+    if (!os.isOpen()) {
+        return 0;
+    }
+    os >> s->sim_time;
+    os >> *s->dut;
+    os.close();
+#if SIM_TRACE
+    if (s->recorder) {
+        s->recorder->clear();  // Recorded cycles no longer precede sim_time
+    }
+    if (s->capture.state == CAPTURE_POST) {
+        s->capture.state = CAPTURE_ARMED;
+    }
+#endif
+    return 1;
+#else
+    (void)s;
+    fprintf(stderr, "Checkpoint %s not restored: model not built with --savable\n", path);
+    return 0;
+#endif
+}
+
+//==============================================================================
+// Clock
+//==============================================================================
+
+static inline void sim_trace_dump(SimInstance* s) {
+#if SIM_TRACE
+    s->tfp->dump(s->sim_time);
+#else
+    (void)s;
+#endif
+}
+
+// One full clock cycle. kObserve selects at compile time whether the FST dump
+// and flight recorder hooks (and their tests) exist at all.
+template <bool kObserve>
+static inline void sim_clock_cycle_t(SimInstance* s) {
+    uint64_t cycle = s->sim_time / 2;
+    bool dump = kObserve && s->tracing_enabled &&
+                cycle >= s->trace_from_cycle && cycle <= s->trace_to_cycle;
+
+    s->dut->clk = 0;
+    s->dut->eval();
+    if (dump) {
+        sim_trace_dump(s);
+    }
+    s->sim_time++;
+
+    s->dut->clk = 1;
+    s->dut->eval();
+    if (dump) {
+        sim_trace_dump(s);
+    }
+    s->sim_time++;
+
+#if SIM_TRACE
+    if (kObserve && s->recorder) {
+        s->sample_signals(s->dut, s->recorder->next_slot(cycle));
+        if (s->capture.active()) {
+            s->capture.update(*s->recorder, cycle);
+        }
+    }
+#endif
+    if (kObserve && s->sampling) {
+        const Vtop* dut = s->dut;
+        auto sampler = s->sample_signals;
+        s->sampling->take([dut, sampler](uint64_t* row) { sampler(dut, row); }, cycle);
+    }
+}
+
+template <bool kObserve>
+static inline void sim_clock_cycle_t(SimInstance* s, std::bool_constant<kObserve>) {
+    sim_clock_cycle_t<kObserve>(s);
+}
+
+// Call loop(observe), observe being std::true_type or std::false_type as
+// s->observing is now, so a loop clocking with sim_clock_cycle_t(s, observe)
+// tests observing once per call instead of every cycle. Nothing may enable
+// or disable tracing, the flight recorder or sampling during the call.
+template <typename Loop>
+static inline auto sim_with_observe(const SimInstance* s, Loop loop) {
+    if (s->observing) {
+        return loop(std::true_type{});
+    }
+    return loop(std::false_type{});
+}
+
+// Single clock cycle, for callers that clock once per call
+static inline void sim_clock_cycle(SimInstance* s) {
+    sim_with_observe(s, [s](auto observe) { sim_clock_cycle_t(s, observe); });
+}
+
+static inline void sim_clock_n(SimInstance* s, uint64_t n) {
+    sim_with_observe(s, [s, n](auto observe) {
+        for (uint64_t i = 0; i < n; i++) {
+            sim_clock_cycle_t(s, observe);
+        }
+    });
+}
+
+// Reset the existing model for the next job, instead of a cleanup + init
+// round trip that rebuilds the context, the model and any trace
+// registration. Memories keep their contents. The reset cycles go through
+// the normal clock, so the cycle counter keeps running and an open waveform,
+// flight recorder or sample capture records them.
+static inline void sim_reset(SimInstance* s) {
+    s->dut->rst = 1;
+    sim_clock_n(s, SIM_RESET_CYCLES);
+    s->dut->rst = 0;
+}
+
+//==============================================================================
+// Event Wait
+//==============================================================================
+
+// Clock until one of the outputs selected by mask changes. sample(dut) packs
+// the watched outputs into one bit per event; the bits that changed are
+// stored in *fired (0 on timeout). Returns cycles taken.
+template <typename Sample>
+static inline uint64_t sim_run_until_event(SimInstance* s, uint64_t max_cycles, uint32_t mask,
+                                           uint32_t* fired, Sample sample) {
+    uint32_t prev = sample(s->dut) & mask;
+    uint32_t changed = 0;
+    uint64_t cycles = 0;
+
+    sim_with_observe(s, [&](auto observe) {
+        while (cycles < max_cycles) {
+            sim_clock_cycle_t(s, observe);
+            cycles++;
+            uint32_t cur = sample(s->dut) & mask;
+            changed = cur ^ prev;
+            if (changed) {
+                break;
+            }
+        }
+    });
+
+    if (fired) {
+        *fired = changed;
+    }
+    return cycles;
+}
@@ -0,0 +1,113 @@
+/**
+ * Flight recorder, triggered capture and sample capture C API, shared by all
+ * module wrappers.
+ *
+ * The entry points only forward to the sim_instance.h helpers with the
+ * wrapper's signal table, so each wrapper includes this file once, inside
+ * its extern "C" block, after defining:
+ *   - Instance, derived from SimInstance;
+ *   - RECORDER_SIGNALS[] and NUM_RECORDER_SIGNALS, the signal table;
+ *   - sample_signals(dut, out), which fills one row of it.
+ */
+
+#pragma once
+
+//==============================================================================
+// Flight Recorder
+//==============================================================================
+
+// Keep the last depth cycles of the port signals in memory (traced builds
+// only). auto_dump_path (may be null) is written when a run times out.
+// Returns 1 on success
+uint8_t enable_flight_recorder(Instance* inst, uint64_t depth, const char* auto_dump_path) {
+    return sim_enable_recorder(inst, RECORDER_SIGNALS, NUM_RECORDER_SIGNALS, sample_signals,
+                               depth, auto_dump_path);
+}
+
+void disable_flight_recorder(Instance* inst) {
+    sim_disable_recorder(inst);
+}
+
+// Write the recorded cycles to an FST file (null/empty: the auto-dump path).
+// Returns 1 if a file was written
+uint8_t dump_flight_recorder(Instance* inst, const char* filename) {
+    return sim_dump_recorder(inst, filename);
+}
+
+// Set the start (which = 0) or stop (which = 1) capture condition on a
+// recorder signal by name; op is a TRIGGER_* value (0 clears).
+// Returns 0 for an unknown signal or op
+uint8_t set_capture_trigger(Instance* inst, uint8_t which, const char* signal, uint32_t op,
+                            uint64_t value) {
+    return sim_set_capture_trigger(inst, RECORDER_SIGNALS, NUM_RECORDER_SIGNALS, which, signal,
+                                   op, value);
+}
+
+// Write pre cycles before each start trigger through post cycles after it
+// (or the stop trigger) to path, up to max_captures files (0 = unlimited).
+// Returns 1 on success
+uint8_t enable_triggered_capture(Instance* inst, uint64_t pre, uint64_t post, const char* path,
+                                 uint64_t max_captures) {
+    return sim_enable_capture(inst, RECORDER_SIGNALS, NUM_RECORDER_SIGNALS, sample_signals,
+                              pre, post, path, max_captures);
+}
+
+void disable_triggered_capture(Instance* inst) {
+    sim_disable_capture(inst);
+}
+
+uint64_t get_capture_count(Instance* inst) {
+    return sim_capture_count(inst);
+}
+
+//==============================================================================
+// Sample Capture
+//==============================================================================
+
+// Index of a flight recorder signal by name (the names set_capture_trigger
+// takes), or -1. get_signal_name(i) is the reverse, null past the end.
+int32_t find_signal(const char* name) {
+    return recorder_find_signal(RECORDER_SIGNALS, NUM_RECORDER_SIGNALS, name);
+}
+
+uint32_t get_num_signals() {
+    return NUM_RECORDER_SIGNALS;
+}
+
+const char* get_signal_name(uint32_t index) {
+    return index < NUM_RECORDER_SIGNALS ? RECORDER_SIGNALS[index].name : nullptr;
+}
+
+// From now on, every `every` cycles (0 = 1) copy signals ids[0 .. num_ids)
+// into the caller's column-major buffer, column k at buffer + k * capacity,
+// until capacity rows are filled. Works in trace-free builds. Returns 0 for
+// an unknown id or an empty buffer
+uint8_t enable_sampling(Instance* inst, const uint32_t* ids, uint32_t num_ids, uint64_t* buffer,
+                        uint64_t capacity, uint32_t every) {
+    return sim_enable_sampling(inst, NUM_RECORDER_SIGNALS, sample_signals, ids, num_ids, buffer,
+                               capacity, every);
+}
+
+void disable_sampling(Instance* inst) {
+    sim_disable_sampling(inst);
+}
+
+// Refill the buffer from row 0 (after the caller has consumed it)
+void rewind_sampling(Instance* inst) {
+    if (inst->sampling) {
+        inst->sampling->rewind();
+    }
+}
+
+// Rows filled, samples lost to a full buffer, and the cycle of row 0
+uint64_t get_sample_count(Instance* inst) {
+    return inst->sampling ? inst->sampling->count : 0;
+}
+
+uint64_t get_samples_dropped(Instance* inst) {
+    return inst->sampling ? inst->sampling->dropped : 0;
+}
+
+uint64_t get_sample_start_cycle(Instance* inst) {
+    return inst->sampling ? inst->sampling->start_cycle : 0;
+}